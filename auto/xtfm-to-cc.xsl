@@ -15,7 +15,7 @@
 <xsl:template match="XTFM">
 #include "TFM.hh"
 
-static TFM::Font font = {
+static const TFM::Font font = {
 <xsl:choose>
   <xsl:when test="contains(Font/@family, ' ')">"<xsl:value-of select = "substring-before(Font/@family, ' ')"/>",
 </xsl:when>
@@ -30,19 +30,19 @@ static TFM::Font font = {
   <xsl:value-of select="count(Font/Data/Character)"/>
 };
 
-static TFM::Dimension dimension[] = {
+static const TFM::Dimension dimension[] = {
 <xsl:apply-templates select="Font/Dimensions/Dimension"/>
 };
 
 <xsl:apply-templates select="Font/Data/Character" mode="kerning"/>
 <xsl:apply-templates select="Font/Data/Character" mode="ligature"/>
 
-static TFM::Character character[] = {
+static const TFM::Character character[] = {
 <xsl:apply-templates select="Font/Data/Character"/>
 };
 
 void
-<xsl:value-of select="$name"/>_tables(TFM::Font*&amp; _font, TFM::Dimension*&amp; _dimension, TFM::Character*&amp; _character)
+<xsl:value-of select="$name"/>_tables(const TFM::Font*&amp; _font, const TFM::Dimension*&amp; _dimension, const TFM::Character*&amp; _character)
 {
   _font = &amp;font;
   _dimension = dimension;
@@ -58,7 +58,7 @@ void
 
 <xsl:template match="Character" mode="kerning">
 <xsl:if test="Kerning">
-static TFM::Kerning C_<xsl:value-of select="@index"/>_Kerning[] = {
+static const TFM::Kerning C_<xsl:value-of select="@index"/>_Kerning[] = {
 <xsl:apply-templates select="Kerning"/>
 };
 </xsl:if>
@@ -66,7 +66,7 @@ static TFM::Kerning C_<xsl:value-of select="@index"/>_Kerning[] = {
 
 <xsl:template match="Character" mode="ligature">
 <xsl:if test="Ligature">
-static TFM::Ligature C_<xsl:value-of select="@index"/>_Ligature[] = {
+static const TFM::Ligature C_<xsl:value-of select="@index"/>_Ligature[] = {
 <xsl:apply-templates select="Ligature"/>
 };
 </xsl:if>
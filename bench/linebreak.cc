@@ -0,0 +1,146 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Clock.hh"
+#include "LineBreaker.hh"
+
+// Measures the total-fit line breaker on long BoxML-like paragraphs
+// (words separated by spaces) against the greedy strategy formerly
+// used by hov, which measured every child again for each trial width.
+// Usage: linebreak [words [widths]]
+
+static scaled
+measure(const std::vector<int>& lengths, unsigned i)
+{
+  // a word is as wide as its characters, the average character
+  // being half an em wide in a 10pt font
+  return scaled(5 * lengths[i]);
+}
+
+static double
+raggedness(const std::vector<scaled>& slacks)
+{
+  double sum = 0;
+  for (unsigned i = 0; i + 1 < slacks.size(); i++)
+    sum += slacks[i].toFloat() * slacks[i].toFloat();
+  return sum;
+}
+
+static void
+greedy(const std::vector<int>& lengths, const scaled& space, const scaled& width, std::vector<scaled>& slacks)
+{
+  slacks.clear();
+  scaled remaining = width;
+  for (unsigned i = 0; i < lengths.size(); i++)
+    {
+      const scaled w = measure(lengths, i);
+      if (remaining != width && w + space > remaining)
+	{
+	  slacks.push_back(remaining);
+	  remaining = width;
+	}
+      remaining -= (remaining == width) ? w : w + space;
+    }
+  slacks.push_back(remaining);
+}
+
+static void
+totalFit(const LineBreaker& breaker, const std::vector<scaled>& widths, const scaled& space,
+	 const scaled& width, std::vector<scaled>& slacks)
+{
+  std::vector<unsigned> breaks;
+  breaker.breakLines(width, width, breaks);
+
+  slacks.clear();
+  unsigned first = 0;
+  for (std::vector<unsigned>::const_iterator b = breaks.begin(); b != breaks.end(); b++)
+    {
+      const unsigned last = (*b + 1) / 2;
+      scaled lineWidth = 0;
+      for (unsigned i = first; i < last; i++)
+	lineWidth += widths[i] + ((i > first) ? space : scaled::zero());
+      slacks.push_back(width - lineWidth);
+      first = last;
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+  const unsigned nWords = (argc > 1) ? atoi(argv[1]) : 20000;
+  const int nWidths = (argc > 2) ? atoi(argv[2]) : 50;
+  const scaled space = 3;
+
+  srand(0);
+  std::vector<int> lengths;
+  lengths.reserve(nWords);
+  for (unsigned i = 0; i < nWords; i++)
+    lengths.push_back(1 + rand() % 5 + rand() % 5);
+
+  Clock perf;
+  perf.Start();
+  std::vector<scaled> widths;
+  widths.reserve(nWords);
+  LineBreaker breaker;
+  for (unsigned i = 0; i < nWords; i++)
+    {
+      widths.push_back(measure(lengths, i));
+      if (i > 0) breaker.appendGlue(space, 100);
+      breaker.appendBox(widths.back());
+    }
+  perf.Stop();
+  printf("%u words, %d widths\n", nWords, nWidths);
+  printf("measuring the words once: %ldms\n", perf());
+
+  std::vector<scaled> slacks;
+  double greedyRaggedness = 0;
+  double totalFitRaggedness = 0;
+
+  perf.Start();
+  for (int k = 0; k < nWidths; k++)
+    {
+      greedy(lengths, space, scaled(200 + 10 * k), slacks);
+      greedyRaggedness += raggedness(slacks);
+    }
+  perf.Stop();
+  printf("greedy, measuring for every width: %ldms\n", perf());
+
+  perf.Start();
+  for (int k = 0; k < nWidths; k++)
+    {
+      totalFit(breaker, widths, space, scaled(200 + 10 * k), slacks);
+      totalFitRaggedness += raggedness(slacks);
+    }
+  perf.Stop();
+  printf("total-fit on the measured words: %ldms\n", perf());
+
+  printf("raggedness (sum of squared slacks): greedy %g, total-fit %g\n",
+	 greedyRaggedness, totalFitRaggedness);
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+
+#include "defs.h"
+#include "Logger.hh"
+#include "Init.hh"
+#include "Configuration.hh"
+#include "libxml2_MathView.hh"
+#include "MathMLOperatorDictionary.hh"
+#include "MathMLNamespaceContext.hh"
+#include "SVG_Backend.hh"
+#include "MathGraphicDevice.hh"
+#if GMV_ENABLE_BOXML
+#include "BoxMLNamespaceContext.hh"
+#include "BoxGraphicDevice.hh"
+#include "BoxMLHOVElement.hh"
+#include "BoxMLTextElement.hh"
+#include "FormattingContext.hh"
+#endif // GMV_ENABLE_BOXML
+
+// Checks that nested hov elements are not formatted again when
+// nothing but a sibling or the available width has changed, by
+// recording the BoxML elements that are formatted at each step.
+// Every element wraps its area when it is formatted.  Text is given
+// a width proportional to its length, so the outcome does not depend
+// on the installed fonts.  Exits with a non-zero status on failure.
+// Usage: relayout
+
+typedef libxml2_MathView MathView;
+
+#if GMV_ENABLE_BOXML
+
+class CountingBoxGraphicDevice : public BoxGraphicDevice
+{
+protected:
+  CountingBoxGraphicDevice(const SmartPtr<AbstractLogger>& logger)
+    : BoxGraphicDevice(logger), strings(0) { }
+  virtual ~CountingBoxGraphicDevice() { }
+
+public:
+  static SmartPtr<CountingBoxGraphicDevice> create(const SmartPtr<AbstractLogger>& logger)
+  { return new CountingBoxGraphicDevice(logger); }
+
+  virtual scaled ex(const FormattingContext& ctxt) const
+  { return ctxt.getSize() / 2; }
+  virtual AreaRef string(const FormattingContext&, const String& s, const scaled&) const
+  {
+    strings++;
+    return getFactory()->horizontalSpace(scaled(5 * static_cast<int>(s.length())));
+  }
+  virtual AreaRef wrapper(const FormattingContext& ctxt, const AreaRef& area) const
+  {
+    formatted.insert(ctxt.getBoxMLElement());
+    return area;
+  }
+
+  void reset(void) const { strings = 0; formatted.clear(); }
+
+  mutable unsigned strings;
+  mutable std::set<const BoxMLElement*> formatted;
+};
+
+static int failures = 0;
+
+static void
+step(const char* name, const SmartPtr<MathView>& view,
+     const SmartPtr<CountingBoxGraphicDevice>& bgd,
+     unsigned expectedElements, unsigned expectedStrings)
+{
+  bgd->reset();
+  view->getBoundingBox();
+  const bool ok = bgd->formatted.size() == expectedElements && bgd->strings == expectedStrings;
+  printf("  %-32s %3u elements %3u strings (expected %u, %u)%s\n", name,
+	 static_cast<unsigned>(bgd->formatted.size()), bgd->strings,
+	 expectedElements, expectedStrings, ok ? "" : "  FAILED");
+  if (!ok) failures++;
+}
+
+#endif // GMV_ENABLE_BOXML
+
+int
+main()
+{
+#if GMV_ENABLE_BOXML
+  SmartPtr<AbstractLogger> logger = Logger::create();
+  logger->setLogLevel(LOG_ERROR);
+  SmartPtr<Configuration> configuration = initConfiguration<MathView>(logger, getenv("GTKMATHVIEWCONF"));
+  SmartPtr<Backend> backend = SVG_Backend::create(logger, configuration);
+  SmartPtr<MathGraphicDevice> mgd = backend->getMathGraphicDevice();
+  SmartPtr<CountingBoxGraphicDevice> bgd = CountingBoxGraphicDevice::create(logger);
+  bgd->setFactory(mgd->getFactory());
+
+  SmartPtr<MathView> view = MathView::create(logger);
+  view->setOperatorDictionary(initOperatorDictionary<MathView>(logger, configuration));
+  view->setMathMLNamespaceContext(MathMLNamespaceContext::create(view, mgd));
+  view->setBoxMLNamespaceContext(BoxMLNamespaceContext::create(view, bgd));
+
+  // an hov of three hov, each one with four words that do not fit
+  // on a single line at the narrower width
+  std::string s = "<hov xmlns=\"" BOXML_NS_URI "\" spacing=\"5pt\">";
+  for (unsigned i = 0; i < 3; i++)
+    {
+      s += "<hov spacing=\"5pt\">";
+      s += "<text>lorem</text><text>ipsum</text><text>dolor</text><text>amet</text>";
+      s += "</hov>";
+    }
+  s += "</hov>";
+  const unsigned nElements = 1 + 3 * (1 + 4);
+  const scaled narrow(60);
+  const scaled wide(400);
+
+  view->setAvailableWidth(narrow);
+  if (!view->loadBuffer(s.c_str()))
+    {
+      fprintf(stderr, "relayout: could not load the document\n");
+      return 1;
+    }
+
+  SmartPtr<BoxMLHOVElement> root = smart_cast<BoxMLHOVElement>(view->getRootElement());
+  assert(root && root->getSize() == 3);
+  SmartPtr<BoxMLHOVElement> first = smart_cast<BoxMLHOVElement>(root->getChild(0));
+  SmartPtr<BoxMLHOVElement> second = smart_cast<BoxMLHOVElement>(root->getChild(1));
+
+  printf("relayout: nested hov, formatted elements per step\n");
+  step("first format", view, bgd, nElements, 12);
+  step("no change", view, bgd, 0, 0);
+
+  // only the changed word, its hov and the root are formatted
+  smart_cast<BoxMLTextElement>(first->getChild(0))->setContent("changed");
+  step("word changed", view, bgd, 3, 1);
+
+  // the words do not depend on the width, the hov elements do
+  view->setAvailableWidth(wide);
+  step("wider", view, bgd, 4, 0);
+
+  // both layouts of the root are cached
+  view->setAvailableWidth(narrow);
+  step("narrower again", view, bgd, 0, 0);
+  view->setAvailableWidth(wide);
+  step("wider again", view, bgd, 0, 0);
+
+  // the siblings restore their own cached layouts
+  smart_cast<BoxMLTextElement>(second->getChild(0))->setContent("changed");
+  step("word changed after resizing", view, bgd, 3, 1);
+
+  view->resetRootElement();
+
+  return (failures > 0) ? 1 : 0;
+#else
+  printf("relayout: BoxML support is disabled\n");
+  return 77;
+#endif // GMV_ENABLE_BOXML
+}
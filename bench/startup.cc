@@ -0,0 +1,155 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <sys/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "Logger.hh"
+#include "Init.hh"
+#include "Configuration.hh"
+#include "libxml2_MathView.hh"
+#include "MathMLOperatorDictionary.hh"
+#include "MathMLNamespaceContext.hh"
+#include "SVG_Backend.hh"
+#include "SVG_StreamRenderingContext.hh"
+#include "MathGraphicDevice.hh"
+
+// Measures the time mathmlsvg takes from the moment it starts setting
+// up the view to the moment the first document has been rendered,
+// broken down into its phases. Every run builds the configuration,
+// the backend and the view from scratch, the first run also pays for
+// the one-time initialization of the libraries. The second column is
+// the time of the first run, the third the average over the runs.
+// Usage: startup [-n runs] [file]   (default tests/simple.xml)
+
+typedef libxml2_MathView MathView;
+
+enum Phase {
+  PHASE_CONFIGURATION,
+  PHASE_BACKEND,
+  PHASE_VIEW,
+  PHASE_LOAD,
+  PHASE_FORMAT,
+  PHASE_RENDER,
+  N_PHASES
+};
+
+static const char* phaseName[] = {
+  "configuration",
+  "backend",
+  "view",
+  "load",
+  "format",
+  "render"
+};
+
+static double
+now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static void
+run(const char* file, double* elapsed)
+{
+  double t = now();
+  double t1;
+
+#define PHASE(p) t1 = now(); elapsed[p] += t1 - t; t = t1
+
+  SmartPtr<AbstractLogger> logger = Logger::create();
+  logger->setLogLevel(LOG_ERROR);
+  SmartPtr<Configuration> configuration = initConfiguration<MathView>(logger, getenv("GTKMATHVIEWCONF"));
+  SmartPtr<MathMLOperatorDictionary> dictionary = initOperatorDictionary<MathView>(logger, configuration);
+  PHASE(PHASE_CONFIGURATION);
+
+  SmartPtr<Backend> backend = SVG_Backend::create(logger, configuration);
+  SmartPtr<MathGraphicDevice> mgd = backend->getMathGraphicDevice();
+  PHASE(PHASE_BACKEND);
+
+  SmartPtr<MathView> view = MathView::create(logger);
+  view->setOperatorDictionary(dictionary);
+  view->setMathMLNamespaceContext(MathMLNamespaceContext::create(view, mgd));
+  PHASE(PHASE_VIEW);
+
+  view->loadURI(file);
+  PHASE(PHASE_LOAD);
+
+  const BoundingBox box = view->getBoundingBox();
+  PHASE(PHASE_FORMAT);
+
+  std::ostringstream os;
+  SVG_StreamRenderingContext rc(logger, os);
+  rc.documentStart(box);
+  view->render(rc, 0, -box.height);
+  rc.documentEnd();
+  PHASE(PHASE_RENDER);
+
+#undef PHASE
+
+  view->resetRootElement();
+}
+
+int
+main(int argc, char* argv[])
+{
+  int runs = 10;
+  int first = 1;
+  if (argc > 2 && !strcmp(argv[1], "-n"))
+    {
+      runs = atoi(argv[2]);
+      if (runs < 1) runs = 1;
+      first = 3;
+    }
+  const char* file = (first < argc) ? argv[first] : STARTUP_DOCUMENT;
+
+  double firstRun[N_PHASES];
+  double total[N_PHASES];
+  for (int p = 0; p < N_PHASES; p++)
+    firstRun[p] = total[p] = 0;
+
+  run(file, firstRun);
+  for (int i = 0; i < runs; i++)
+    run(file, total);
+
+  printf("%s: time to first render, %d runs\n", file, runs);
+  printf("  %-16s %10s %10s\n", "phase", "first", "average");
+  double sumFirst = 0;
+  double sumTotal = 0;
+  for (int p = 0; p < N_PHASES; p++)
+    {
+      printf("  %-16s %8.3fms %8.3fms\n", phaseName[p], firstRun[p], total[p] / runs);
+      sumFirst += firstRun[p];
+      sumTotal += total[p];
+    }
+  printf("  %-16s %8.3fms %8.3fms\n", "total", sumFirst, sumTotal / runs);
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Clock.hh"
+#include "Logger.hh"
+#include "Init.hh"
+#include "Configuration.hh"
+#include "libxml2_MathView.hh"
+#include "MathMLOperatorDictionary.hh"
+#include "MathMLNamespaceContext.hh"
+#include "SVG_Backend.hh"
+#include "ShaperManager.hh"
+#include "ComputerModernShaper.hh"
+#include "MathGraphicDevice.hh"
+
+// Compares the hit rates of the cache of stretched strings, keyed on
+// the exact span, with the ones of the two levels of the stretchy
+// cache of the Computer Modern shaper, the parts of the character and
+// its assembly for a number of glue pieces, on the given documents
+// (typically tests/stretch*.xml) and on randomly generated nested
+// parenthesized expressions.
+// Usage: stretchy [-r expressions [depth]] [file...]
+
+typedef libxml2_MathView MathView;
+
+static void
+expression(std::string& s, int depth)
+{
+  static const char* fence[][2] = { { "(", ")" }, { "[", "]" }, { "{", "}" }, { "|", "|" } };
+
+  if (depth == 0)
+    {
+      // a leaf of random height, so that fences around it stretch
+      // to many different spans
+      char buffer[64];
+      sprintf(buffer, "<mspace width=\"1em\" height=\"%d.%dex\" depth=\"%d.%dex\"/>",
+	      rand() % 6, rand() % 10, rand() % 2, rand() % 10);
+      s += buffer;
+      return;
+    }
+
+  const unsigned f = rand() % 4;
+  s += "<mrow><mo>";
+  s += fence[f][0];
+  s += "</mo>";
+  switch (rand() % 3)
+    {
+    case 0:
+      s += "<mfrac>";
+      expression(s, depth - 1);
+      expression(s, depth - 1);
+      s += "</mfrac>";
+      break;
+    case 1:
+      s += "<msup>";
+      expression(s, depth - 1);
+      s += "<mn>2</mn></msup>";
+      break;
+    default:
+      expression(s, depth - 1);
+      s += "<mo>+</mo>";
+      expression(s, depth - 1);
+      break;
+    }
+  s += "<mo>";
+  s += fence[f][1];
+  s += "</mo></mrow>";
+}
+
+static double
+rate(unsigned hits, unsigned misses)
+{ return (hits + misses > 0) ? (100.0 * hits) / (hits + misses) : 0.0; }
+
+static void
+report(const char* name, const SmartPtr<MathGraphicDevice>& mgd,
+       const SmartPtr<ComputerModernShaper>& cmShaper, long ms)
+{
+  unsigned hits;
+  unsigned misses;
+  mgd->getStretchyCacheStats(hits, misses);
+  const ComputerModernShaper::StretchyCacheStats& stats = cmShaper->getStretchyCacheStats();
+  printf("%s: %u stretchy strings, %ldms\n", name, hits + misses, ms);
+  printf("  exact span:   %5.1f%% hits\n", rate(hits, misses));
+  printf("  parts:        %5.1f%% hits (%u lookups)\n",
+	 rate(stats.partsHits, stats.partsMisses), stats.partsHits + stats.partsMisses);
+  printf("  assembly:     %5.1f%% hits (%u lookups)\n",
+	 rate(stats.assemblyHits, stats.assemblyMisses), stats.assemblyHits + stats.assemblyMisses);
+}
+
+int
+main(int argc, char* argv[])
+{
+  int first = 1;
+  unsigned nExpressions = 0;
+  int depth = 6;
+  if (argc > 1 && !strcmp(argv[1], "-r"))
+    {
+      nExpressions = (argc > 2) ? atoi(argv[2]) : 200;
+      first = 3;
+      if (argc > 3 && argv[3][0] != '-' && !strstr(argv[3], ".xml"))
+	{
+	  depth = atoi(argv[3]);
+	  first = 4;
+	}
+    }
+
+  SmartPtr<AbstractLogger> logger = Logger::create();
+  logger->setLogLevel(LOG_ERROR);
+  SmartPtr<Configuration> configuration = initConfiguration<MathView>(logger, getenv("GTKMATHVIEWCONF"));
+  SmartPtr<Backend> backend = SVG_Backend::create(logger, configuration);
+  SmartPtr<MathGraphicDevice> mgd = backend->getMathGraphicDevice();
+
+  SmartPtr<ComputerModernShaper> cmShaper;
+  SmartPtr<ShaperManager> sm = backend->getShaperManager();
+  for (unsigned i = 0; !cmShaper && sm->getShaper(i); i++)
+    cmShaper = smart_cast<ComputerModernShaper>(sm->getShaper(i));
+  if (!cmShaper)
+    {
+      fprintf(stderr, "stretchy: the Computer Modern shaper is not configured\n");
+      return 1;
+    }
+
+  SmartPtr<MathView> view = MathView::create(logger);
+  view->setOperatorDictionary(initOperatorDictionary<MathView>(logger, configuration));
+  view->setMathMLNamespaceContext(MathMLNamespaceContext::create(view, mgd));
+
+  Clock perf;
+  for (int i = first; i < argc; i++)
+    {
+      mgd->clearCache();
+      cmShaper->clearStretchyCache();
+      perf.Start();
+      view->loadURI(argv[i]);
+      view->getBoundingBox();
+      perf.Stop();
+      report(argv[i], mgd, cmShaper, perf());
+    }
+
+  if (nExpressions > 0)
+    {
+      srand(0);
+      mgd->clearCache();
+      cmShaper->clearStretchyCache();
+      long ms = 0;
+      for (unsigned i = 0; i < nExpressions; i++)
+	{
+	  std::string s = "<math xmlns=\"http://www.w3.org/1998/Math/MathML\">";
+	  expression(s, depth);
+	  s += "</math>";
+	  perf.Start();
+	  view->loadBuffer(s.c_str());
+	  view->getBoundingBox();
+	  perf.Stop();
+	  ms += perf();
+	}
+      char name[64];
+      sprintf(name, "%u random expressions of depth %d", nExpressions, depth);
+      report(name, mgd, cmShaper, ms);
+    }
+
+  view->resetRootElement();
+
+  return 0;
+}
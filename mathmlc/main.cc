@@ -0,0 +1,112 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+
+#include "compiledDocumentWriter.hh"
+
+static String
+toString(const xmlChar* s)
+{ return s ? String(reinterpret_cast<const char*>(s)) : String(); }
+
+static void
+compileNode(compiledDocumentWriter& writer, xmlNode* node)
+{
+  for (xmlNode* p = node; p; p = p->next)
+    switch (p->type)
+      {
+      case XML_ELEMENT_NODE:
+	writer.startElement(p->ns ? toString(p->ns->href) : String(), toString(p->name));
+	for (xmlAttr* attr = p->properties; attr; attr = attr->next)
+	  {
+	    xmlChar* value = xmlNodeListGetString(p->doc, attr->children, 1);
+	    writer.attribute(attr->ns ? toString(attr->ns->href) : String(), toString(attr->name), toString(value));
+	    xmlFree(value);
+	  }
+	compileNode(writer, p->children);
+	writer.endElement();
+	break;
+      case XML_TEXT_NODE:
+      case XML_CDATA_SECTION_NODE:
+	writer.text(toString(p->content));
+	break;
+      case XML_ENTITY_REF_NODE:
+	compileNode(writer, p->children);
+	break;
+      default:
+	break;
+      }
+}
+
+static void
+printUsage(const char* name)
+{
+  fprintf(stderr, "Usage: %s <input.xml> [<output.gmc>]\n", name);
+}
+
+int
+main(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 3)
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+
+  String outName;
+  if (argc == 3)
+    outName = argv[2];
+  else
+    {
+      outName = argv[1];
+      const String::size_type dot = outName.rfind('.');
+      if (dot != String::npos && outName.find('/', dot) == String::npos)
+	outName.erase(dot);
+      outName += ".gmc";
+    }
+
+  xmlDoc* doc = xmlReadFile(argv[1], 0, XML_PARSE_NOENT);
+  if (!doc)
+    {
+      fprintf(stderr, "%s: could not parse `%s'\n", argv[0], argv[1]);
+      return 1;
+    }
+
+  compiledDocumentWriter writer;
+  compileNode(writer, xmlDocGetRootElement(doc));
+  xmlFreeDoc(doc);
+  xmlCleanupParser();
+
+  if (!writer.save(outName))
+    {
+      fprintf(stderr, "%s: could not write `%s'\n", argv[0], outName.c_str());
+      return 1;
+    }
+
+  return 0;
+}
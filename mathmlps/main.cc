@@ -25,6 +25,7 @@
 #include <cassert>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #ifdef __linux__
 /* to get getopt on Linux */
 #ifndef __USE_POSIX2
@@ -39,9 +40,13 @@
 #include "CharTraits.icc"
 
 #include "Logger.hh"
+#include "ForkServer.hh"
 
 #include "Init.hh"
 #include "Configuration.hh"
+#include "Utils.hh"
+#include "AreaSerializer.hh"
+#include "DirectoryAreaCache.hh"
 #include "libxml2_MathView.hh"
 #include "MathMLOperatorDictionary.hh"
 #if HAVE_LIBT1
@@ -49,6 +54,7 @@
 #endif //HAVE_LIBT1
 #include "FontDataBase.hh"
 #include "PS_Backend.hh"
+#include "ShaperManager.hh"
 #include "PS_MathGraphicDevice.hh"
 #include "PS_StreamRenderingContext.hh"
 #include "MathMLNamespaceContext.hh"
@@ -66,6 +72,7 @@ static Length::Unit unitId = Length::CM_UNIT;
 static double xMargin = 2;
 static double yMargin = 2;
 static double fontSize = DEFAULT_FONT_SIZE;
+static double zoom = 1;
 static bool cropping = true;
 #ifdef HAVE_LIBT1
 static int fontEmbed = 2;
@@ -74,8 +81,13 @@ static int fontEmbed = 0;
 #endif
 static bool cutFileName = true;
 static char* configPath = 0;
+static char* cacheDir = 0;
+static int cacheSize = 64;
 static int  logLevel = LOG_ERROR;
 static bool logLevelSet = false;
+static char* serverPath = 0;
+static int workers = 4;
+static int requestsPerWorker = 0;
 
 enum CommandLineOptionId {
   OPTION_VERSION = 256,
@@ -84,10 +96,16 @@ enum CommandLineOptionId {
   OPTION_UNIT,
   OPTION_MARGINS,
   OPTION_FONT_SIZE,
+  OPTION_ZOOM,
   OPTION_FONT_EMBED,
   OPTION_CROP,
   OPTION_CUT_FILENAME,
-  OPTION_CONFIG
+  OPTION_CONFIG,
+  OPTION_CACHE_DIR,
+  OPTION_CACHE_SIZE,
+  OPTION_SERVER,
+  OPTION_WORKERS,
+  OPTION_REQUESTS_PER_WORKER
 };
 
 static void
@@ -108,12 +126,18 @@ static struct poptOption optionsTable[] = {
   { "page-size", 'p', POPT_ARG_STRING, 0, OPTION_PAGE_SIZE, "Page size (width x height) (default = 21 x 29.7)", "<float>x<float>" },
   { "margins", 'm', POPT_ARG_STRING, 0, OPTION_MARGINS, "Margins (top x left) (default = 2 x 2)", "<float>x<float>" },
   { "font-size", 'f', POPT_ARG_DOUBLE, &fontSize, OPTION_FONT_SIZE, "Default font size (in pt, default=10)", "<float>" },
+  { "zoom", 'z', POPT_ARG_DOUBLE, &zoom, OPTION_ZOOM, "Scale factor applied to the output (default=1)", "<float>" },
 #ifdef HAVE_LIBT1
   { "font-embed", 0, POPT_ARG_INT, &fontEmbed, OPTION_FONT_EMBED, "Enable/disable embedding (default=2)", "[0=disable,1=embed,2=subset]" },
 #endif // HAVE_LIBT1
   { "config", 0, POPT_ARG_STRING, 0, OPTION_CONFIG, "Configuration file path", "<path>" },
   { "crop", 'r', POPT_ARG_STRING | POPT_ARGFLAG_OPTIONAL, 0, OPTION_CROP, "Enable/disable cropping to bounding box (default='yes')", "[yes,no]" },
   { "cut-filename", 0, POPT_ARG_STRING | POPT_ARGFLAG_OPTIONAL, 0, OPTION_CUT_FILENAME, "Cut the prefix dir from the output file (default='yes')", "[yes,no]" },
+  { "cache-dir", 0, POPT_ARG_STRING, 0, OPTION_CACHE_DIR, "Directory for caching formatted documents", "<path>" },
+  { "cache-size", 0, POPT_ARG_INT, &cacheSize, OPTION_CACHE_SIZE, "Maximum size of the cache (in MB, default=64)", "<int>" },
+  { "server", 0, POPT_ARG_STRING, 0, OPTION_SERVER, "Serve requests on a UNIX socket, the files are rendered once to warm up the caches", "<path>" },
+  { "workers", 0, POPT_ARG_INT, &workers, OPTION_WORKERS, "Number of worker processes in server mode (default=4)", "<int>" },
+  { "requests-per-worker", 0, POPT_ARG_INT, &requestsPerWorker, OPTION_REQUESTS_PER_WORKER, "Replace a worker after it has served this many requests (default=0, never)", "<int>" },
   POPT_AUTOHELP
   { 0, 0, 0, 0, 0, 0, 0 }
 };
@@ -251,6 +275,71 @@ getOutputFileName(const char* in)
   return out;
 }
 
+struct Converter
+{
+  SmartPtr<AbstractLogger> logger;
+  SmartPtr<Configuration> configuration;
+  SmartPtr<MathView> view;
+  scaled width;
+  scaled height;
+  scaled xMargin;
+  scaled yMargin;
+};
+
+static void
+render(const Converter& conv, std::ostream& os, const char* title)
+{
+  const BoundingBox box = conv.view->getBoundingBox();
+
+#ifdef HAVE_LIBT1
+  SmartPtr<FontDataBase> fDb;
+  switch (fontEmbed) {
+  case 0: fDb = FontDataBase::create(); break;
+  case 1: fDb = T1_FontDataBase::create(conv.logger, conv.configuration, false); break;
+  case 2: fDb = T1_FontDataBase::create(conv.logger, conv.configuration, true); break;
+  default: assert(false); /* IMPOSSIBLE */
+  }
+#else // !HAVE_LIBT1
+  SmartPtr<FontDataBase> fDb = FontDataBase::create();
+#endif
+
+  PS_StreamRenderingContext rc(conv.logger, os, fDb);
+  // the formatted document is only scaled, not formatted again
+  rc.setZoom(zoom);
+
+  if (cropping)
+    {
+      rc.documentStart(0, 0, box, title);
+      conv.view->render(rc, 0, box.depth);
+    }
+  else
+    {
+      rc.documentStart(conv.xMargin, (box.depth + conv.yMargin),
+		       BoundingBox(conv.width, conv.height - box.depth - conv.yMargin, 
+				   box.depth + conv.yMargin),
+		       title);
+      conv.view->render(rc, conv.xMargin, (box.depth + conv.yMargin));
+    }
+
+  rc.documentEnd();
+}
+
+// a request is a MathML document, the response is its EPS rendering
+static bool
+serveRequest(const std::string& request, std::string& response, void* data)
+{
+  const Converter& conv = *static_cast<const Converter*>(data);
+  if (!conv.view->loadBuffer(request.c_str()))
+    return false;
+  if (conv.view->getAreaCache())
+    conv.view->setDocumentDigest(MathViewNS::digestString(request));
+  std::ostringstream os;
+  render(conv, os, "request.eps");
+  conv.view->resetRootElement();
+  response = os.str();
+  return true;
+}
+
 int
 main(int argc, const char* argv[])
 {
@@ -283,6 +372,9 @@ main(int argc, const char* argv[])
 	  break;
 	case OPTION_FONT_SIZE:
 	  break;
+	case OPTION_ZOOM:
+	  if (zoom <= 0) parseError(ctxt, "zoom");
+	  break;
 #ifdef HAVE_LIBT1
         case OPTION_FONT_EMBED:
        	  if (fontEmbed < 0 || fontEmbed > 2) parseError(ctxt, "font-embed");
@@ -300,6 +392,23 @@ main(int argc, const char* argv[])
 	  assert(arg != 0);
 	  configPath = strdup(arg);
 	  break;
+	case OPTION_CACHE_DIR:
+	  assert(arg != 0);
+	  cacheDir = strdup(arg);
+	  break;
+	case OPTION_CACHE_SIZE:
+	  if (cacheSize <= 0) parseError(ctxt, "cache-size");
+	  break;
+	case OPTION_SERVER:
+	  assert(arg != 0);
+	  serverPath = strdup(arg);
+	  break;
+	case OPTION_WORKERS:
+	  if (workers <= 0) parseError(ctxt, "workers");
+	  break;
+	case OPTION_REQUESTS_PER_WORKER:
+	  if (requestsPerWorker < 0) parseError(ctxt, "requests-per-worker");
+	  break;
 	default:
 	  assert(false);
 	}
@@ -325,6 +434,7 @@ main(int argc, const char* argv[])
   SmartPtr<MathMLOperatorDictionary> dictionary = initOperatorDictionary<MathView>(logger, configuration);
 
   logger->out(LOG_INFO, "Font size : %f", fontSize);
+  logger->out(LOG_INFO, "Zoom      : %f", zoom);
   logger->out(LOG_INFO, "Page size : %fx%f", width, height);
   logger->out(LOG_INFO, "Margins   : %fx%f", xMargin, yMargin);
 
@@ -349,6 +459,46 @@ main(int argc, const char* argv[])
 
   view->setAvailableWidth(widthS - xMarginS * 2);
 
+  if (cacheDir)
+    {
+      if (SmartPtr<AreaSerializer> serializer = backend->getAreaSerializer())
+	view->setAreaCache(DirectoryAreaCache::create(serializer, "ps", configuration->getDigest(),
+						      cacheDir, static_cast<unsigned long>(cacheSize) << 20));
+      else
+	logger->out(LOG_WARNING, "the backend does not support caching");
+    }
+
+  Converter conv;
+  conv.logger = logger;
+  conv.configuration = configuration;
+  conv.view = view;
+  conv.width = widthS;
+  conv.height = heightS;
+  conv.xMargin = xMarginS;
+  conv.yMargin = yMarginS;
+
+  if (serverPath)
+    {
+      // prepare then fork: the files are rendered and thrown away so
+      // that the caches are warm before the workers are forked
+      const char* file = 0;
+      while ((file = poptGetArg(ctxt)) != 0)
+	{
+	  logger->out(LOG_INFO, "Warming up with `%s'...", file);
+	  view->loadURI(file);
+	  std::ostringstream os;
+	  render(conv, os, file);
+	  view->resetRootElement();
+	}
+      backend->getShaperManager()->registerPendingShapers();
+      mgd->freezeCache();
+
+      ForkServer server(logger, serverPath, workers, requestsPerWorker);
+      const bool ok = server.run(serveRequest, &conv);
+      poptFreeContext(ctxt);
+      return ok ? 0 : 1;
+    }
+
   const char* file = 0;
   while ((file = poptGetArg(ctxt)) != 0)
     {
@@ -364,39 +514,17 @@ main(int argc, const char* argv[])
       view->loadReader(reader);
 #endif
       view->loadURI(file);
-      const BoundingBox box = view->getBoundingBox();
-     
-#ifdef HAVE_LIBT1
-      SmartPtr<FontDataBase> fDb;
-      switch (fontEmbed) {
-      case 0: fDb = FontDataBase::create(); break;
-      case 1: fDb = T1_FontDataBase::create(logger, configuration, false); break;
-      case 2: fDb = T1_FontDataBase::create(logger, configuration, true); break;
-      default: assert(false); /* IMPOSSIBLE */
-      }
-#else // !HAVE_LIBT1
-      SmartPtr<FontDataBase> fDb = FontDataBase::create();
-#endif
-
-      std::ofstream os(outName);
-      PS_StreamRenderingContext rc(logger, os, fDb);
-
-      if (cropping)
-	{
-	  rc.documentStart(0, 0, box, outName);
-	  view->render(rc, 0, box.depth);
-	}
-      else
+      if (view->getAreaCache())
 	{
-	  rc.documentStart(xMarginS, (box.depth + yMarginS),
-			   BoundingBox(widthS, heightS - box.depth - yMarginS, 
-				       box.depth + yMarginS),
-			   outName);
-	  view->render(rc, xMarginS, (box.depth + yMarginS));
+	  std::ifstream is(file);
+	  std::ostringstream source;
+	  source << is.rdbuf();
+	  view->setDocumentDigest(MathViewNS::digestString(source.str()));
 	}
 
+      std::ofstream os(outName);
+      render(conv, os, outName);
       delete [] outName;
-      rc.documentEnd();
       view->resetRootElement();
       os.close();
       // WARNING: currently the text reader is freed by libxmlXmlReader
@@ -45,7 +45,7 @@ Fragment::addDependency(const SmartPtr<Fragment>& frag)
 }
 
 bool
-Fragment::visit(std::list<SmartPtr<Fragment> >& sortedFragmentList)
+Fragment::visit(std::vector<SmartPtr<Fragment> >& sortedFragmentList)
 {
   if (color == GRAY)
     return true;
@@ -53,7 +53,7 @@ Fragment::visit(std::list<SmartPtr<Fragment> >& sortedFragmentList)
   if (color == WHITE)
     {
       color = GRAY;
-      for (std::list<SmartPtr<Fragment> >::iterator f = dependencies.begin(); f != dependencies.end(); f++)
+      for (std::vector<SmartPtr<Fragment> >::iterator f = dependencies.begin(); f != dependencies.end(); f++)
 	if ((*f)->visit(sortedFragmentList))
 	  return true;
       color = BLACK;
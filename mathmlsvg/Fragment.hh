@@ -23,7 +23,7 @@
 #ifndef __Fragment_hh__
 #define __Fragment_hh__
 
-#include <list>
+#include <vector>
 
 #include "Model.hh"
 #include "Object.hh"
@@ -43,7 +43,7 @@ public:
   Model::Element getNewRoot(void) const { return newRoot; }
 
   void addDependency(const SmartPtr<Fragment>&);
-  bool visit(std::list<SmartPtr<Fragment > >&);
+  bool visit(std::vector<SmartPtr<Fragment> >&);
   scaled getX(void) const { return x; }
   scaled getY(void) const { return y; }
   const BoundingBox& getBoundingBox(void) const { return box; }
@@ -55,7 +55,7 @@ private:
 
   Model::Element oldRoot;
   Model::Element newRoot;
-  std::list<SmartPtr<Fragment> > dependencies;
+  std::vector<SmartPtr<Fragment> > dependencies;
   scaled x;
   scaled y;
   BoundingBox box;
@@ -44,7 +44,7 @@ SMS::SMS(const SmartPtr<AbstractLogger>& _logger,
 	 const SmartPtr<MathView>& _view,
 	 const scaled& _pageWidth, const scaled& _pageHeight,
 	 float _dpi)
-  : logger(_logger), view(_view), evalContext(logger, view),
+  : logger(_logger), view(_view),
     pageWidth(_pageWidth), pageHeight(_pageHeight), dpi(_dpi)
 {
   funMap["pair"] = &SMS::fun_pair;
@@ -106,82 +106,39 @@ SMS::evaluate(const Length& length, const scaled& defaultValue)
 #include "scaledAux.hh"
 
 bool
-SMS::sortFragments(std::list<SmartPtr<Fragment> >& sortedFragmentList) const
+SMS::sortFragments(std::vector<SmartPtr<Fragment> >& sortedFragmentList) const
 {
-  for (std::list<SmartPtr<Fragment> >::const_iterator f = fragmentList.begin(); f != fragmentList.end(); f++)
+  sortedFragmentList.reserve(fragmentList.size());
+  for (std::vector<SmartPtr<Fragment> >::const_iterator f = fragmentList.begin(); f != fragmentList.end(); f++)
     if ((*f)->visit(sortedFragmentList))
       return true;
   return false;
 }
 
-
-bool xmlIsNull(const xmlChar* str)
+bool
+SMS::isPairAttribute(const String& elemName, const String& name)
 {
-  return(str[0] == (xmlChar)'0');
+  return ((elemName == "rect" || elemName == "text" || elemName == "foreignObject") && name == "at")
+    || (elemName == "rect" && name == "size")
+    || ((elemName == "rect" || elemName == "ellipse") && name == "radius")
+    || ((elemName == "circle" || elemName == "ellipse") && name == "at")
+    || (elemName == "line" && (name == "from" || name == "to"));
 }
 
-bool SMS::isGmvNamespace(const xmlChar* ns)
+const Scanner::TokenVector&
+SMS::getAttributeTokens(xmlAttr* attr)
 {
-  int i;
-  char *gmvNs = GMV_NS_URI;
-  for (i = 0; i < 41; i++)
-    {
-      if (ns[i] != gmvNs[i])
-	return(false);
-    }
-  return(true);
-}
-
-// Funzione che cerca gli ID all'interno degli attributi
-// deve essere sostituita con una funzione di parsing dell'intero attributo
+  assert(attr);
+  const AttributeTokensMap::const_iterator p = attributeTokensMap.find(attr);
+  if (p != attributeTokensMap.end())
+    return p->second;
 
-std::list<xmlChar*>
-SMS::getDepFromAttr(const xmlChar *value)
-{
-  std::list<xmlChar *> idRetLst;
-  String attribute((char *)value);
-  Scanner scanner(UCS4StringOfString(attribute), false);
-  
-  while (true)
-    {
-      switch(scanner.getToken())
-	{
-	case Scanner::RAW :
-	  scanner.advance();
-	  break;
-	  
-	case Scanner::EOS :
-	  return(idRetLst);
-	  break;
-	  
-	case Scanner::DOLLAR :
-	  scanner.advance();
-	  if (scanner.getToken() == Scanner::ID)
-	    {
-	      String tmp("");
-	      tmp.append(StringOfUCS4String(scanner.getString()));
-	      scanner.advance();
-	      xmlChar *xmlTmp = (xmlChar *)calloc(sizeof(tmp.c_str()), sizeof(xmlChar));
-	      strcpy((char *)xmlTmp, (char *)tmp.c_str());
-	      idRetLst.push_back((xmlChar *)xmlTmp);
-	      break;
-	    }
-	  else
-	    {
-	      scanner.advance();
-	      break;
-	    }
-	  
-	case Scanner::ID :
-	  scanner.advance();
-	  break;
-	  
-	  
-	default :
-	  scanner.advance();
-	  break;
-	}
-    }
+  // pair attributes are pure expressions, all the others are
+  // raw text with expressions embedded within braces
+  const bool raw = !isPairAttribute(Model::getNodeName(attr->parent), Model::getNodeName((xmlNode*) attr));
+  Scanner::TokenVector& tokens = attributeTokensMap[attr];
+  Scanner::tokenize(UCS4StringOfString(Model::getNodeValue((xmlNode*) attr)), raw, tokens);
+  return tokens;
 }
 
 void
@@ -199,30 +156,43 @@ SMS::assoc(const Model::Node& node, const SmartPtr<Fragment>& frag)
 void
 SMS::findFragmentDependencies()
 {
-  for (std::list<SmartPtr<Fragment> >::iterator f = fragmentList.begin();
+  for (std::vector<SmartPtr<Fragment> >::const_iterator f = fragmentList.begin();
        f != fragmentList.end();
        f++)
-    if (xmlAttr* attr = Model::asNode((*f)->getOldRoot())->properties)
-      for (; attr != NULL; attr = attr->next)
+    for (xmlAttr* attr = Model::asNode((*f)->getOldRoot())->properties; attr; attr = attr->next)
+      if (attr->ns && Model::fromModelString(attr->ns->href) == GMV_NS_URI)
 	{
-	  if (Model::Node attrNode = (xmlNode*) attr)
-	    if (Model::getNodeNamespaceURI(attrNode) == GMV_NS_URI)
-	      for (Scanner scanner(UCS4StringOfString(Model::getNodeValue(attrNode)), false); scanner.more(); scanner.advance())
-// FIX MEEEEEEEEEE!!!!!!!!
-//
-		if (scanner.getToken() == Scanner::ID)
-                {
-                  String readString = StringOfUCS4String(scanner.getString());
-                  if (readString == "width" || readString == "height" || readString == "depth")
-                  {
-                    scanner.advance();
-                    while (scanner.getToken() != Scanner::ID) scanner.advance();
-                    scanner.advance();
-                  }
-		  else if (SmartPtr<Fragment> tmp = idFragmentMap[StringOfUCS4String(scanner.getString())])
-		    (*f)->addDependency(tmp);
-	        }
-        }
+	  // a fragment depends on every fragment containing an
+	  // element that is referred to as $id in its attributes
+	  const Scanner::TokenVector& tokens = getAttributeTokens(attr);
+	  for (Scanner::TokenVector::const_iterator p = tokens.begin(); p != tokens.end(); p++)
+	    if (p->id == Scanner::DOLLAR && p + 1 != tokens.end() && (p + 1)->id == Scanner::ID)
+	      {
+		const IdFragmentMap::const_iterator q = idFragmentMap.find(StringOfUCS4String((p + 1)->string));
+		if (q != idFragmentMap.end())
+		  (*f)->addDependency(q->second);
+	      }
+	}
+}
+
+void
+SMS::collectLocations(const Model::Element& el)
+{
+  assert(el);
+  if (Model::hasAttribute(el, "id"))
+    if (SmartPtr<Element> elem = view->elementOfModelElement(el))
+      {
+	Point origin;
+	BoundingBox box;
+	if (view->getElementExtents(elem, &origin, &box))
+	  {
+	    const String name = Model::getAttribute(el, "id");
+	    idLocationMap[name] = Location::create(name, origin.x, origin.y, box);
+	  }
+      }
+
+  for (Model::ElementIterator p(el); p.more(); p.next())
+    collectLocations(p.element());
 }
 
 void
@@ -244,16 +214,15 @@ SMS::traverse(const Model::Node& node)
 	      // set available width with width attribute on foreignObject
 	      if (SmartPtr<Element> root = view->getRootElement())
 		{
-		  // questa prima resa serve per conoscere le dimensioni del frammento
-		  // e di tutti gli elementi MathML in esso contenuti
-		  
-		  view->render(evalContext, 0, 0);
+		  // the locations of the elements with an id are read
+		  // directly from the formatted fragment, the only
+		  // rendering needed is the one generating the SVG
+		  const BoundingBox box = view->getBoundingBox();
+		  collectLocations(mmlRoot);
+
 		  std::ostringstream os;
 		  SVG_libxml2_StreamRenderingContext context(logger, os, view);
-		  const BoundingBox box = view->getBoundingBox();
 		  context.documentStart(box);
-		  // questa seconda resa serve per generare l'SVG corrispondente al
-		  // frammento di MathML
 		  view->render(context, 0, 0);
 		  context.documentEnd();
 		  
@@ -306,7 +275,7 @@ SMS::fromUserUnits(float f) const
 void
 SMS::substFragments()
 {
-  for (std::list<SmartPtr<Fragment> >::const_iterator p = fragmentList.begin(); p != fragmentList.end(); p++)
+  for (std::vector<SmartPtr<Fragment> >::const_iterator p = fragmentList.begin(); p != fragmentList.end(); p++)
     {
       const SmartPtr<Fragment> fragment = *p;
       std::ostringstream os;
@@ -741,8 +710,10 @@ SMS::getLocationOfId(const String& name) const
   
   SmartPtr<Fragment> frag = p->second;
   assert(frag != 0);
-  if (SmartPtr<Location> loc = evalContext.getLocation(name))
+  const IdLocationMap::const_iterator q = idLocationMap.find(name);
+  if (q != idLocationMap.end())
     {
+      const SmartPtr<Location> loc = q->second;
       const scaled lx = frag->getX() - frag->getBoundingBox().width / 2 + loc->getX();
       const scaled ly = frag->getY() + (frag->getBoundingBox().height - frag->getBoundingBox().depth) / 2 - loc->getY();
       return Location::create(name, lx, ly, loc->getBoundingBox());
@@ -752,7 +723,7 @@ SMS::getLocationOfId(const String& name) const
 }
 
 SmartPtr<Value>
-SMS::evalExpr(Scanner& scanner)
+SMS::evalExpr(TokenStream& scanner)
 {
   int a = scanner.getToken();
   switch (a)
@@ -846,9 +817,9 @@ SMS::evalExpr(Scanner& scanner)
 }
 
 bool
-SMS::evalAttribute(const Model::Element& el, const String& value, const String& name)
+SMS::evalAttribute(const Model::Element& el, const Scanner::TokenVector& tokens, const String& name)
 {
-  Scanner scanner(UCS4StringOfString(value), true);
+  TokenStream scanner(tokens);
   String acc;
 
   while (scanner.more())
@@ -868,26 +839,10 @@ SMS::evalAttribute(const Model::Element& el, const String& value, const String&
   return true;
 }
 
-#if 0
-bool
-SMS::evalScalarAttribute(const Model::Element& el, const String& value, const String& name)
-{
-  Scanner scanner(UCS4StringOfString(value));
-  scaled v;
-  if (asScalar(evalExpr(scanner), v)) {
-    std::ostringstream os;
-    os << toUserUnits(v); 
-    Model::setAttribute(el, name, os.str());
-    return true;
-  }
-  return false;
-}
-#endif
-
 bool
-SMS::evalPairAttribute(const Model::Element& el, const String& value, const String& name1, const String& name2)
+SMS::evalPairAttribute(const Model::Element& el, const Scanner::TokenVector& tokens, const String& name1, const String& name2)
 {
-  Scanner scanner(UCS4StringOfString(value));
+  TokenStream scanner(tokens);
   Point p;
   if (asPair(evalExpr(scanner), p)) {
     std::ostringstream os1;
@@ -913,21 +868,21 @@ SMS::evalAttributes(const Model::Node& node)
 	if (attr->ns && Model::fromModelString(attr->ns->href) == GMV_NS_URI)
 	  {
 	    const String name = Model::getNodeName((xmlNode*) attr);
-	    const String value = Model::getNodeValue((xmlNode*) attr);
+	    const Scanner::TokenVector& tokens = getAttributeTokens(attr);
 	    if ((elemName == "rect" || elemName == "text" || elemName == "foreignObject") && name == "at")
-	      evalPairAttribute(elem, value, "x", "y");
+	      evalPairAttribute(elem, tokens, "x", "y");
 	    else if (elemName == "rect" && name == "size")
-	      evalPairAttribute(elem, value, "width", "height");
+	      evalPairAttribute(elem, tokens, "width", "height");
 	    else if ((elemName == "rect" || elemName == "ellipse") && name == "radius")
-	      evalPairAttribute(elem, value, "rx", "ry");
+	      evalPairAttribute(elem, tokens, "rx", "ry");
 	    else if ((elemName == "circle" || elemName == "ellipse") && name == "at")
-	      evalPairAttribute(elem, value, "cx", "cy");
+	      evalPairAttribute(elem, tokens, "cx", "cy");
 	    else if (elemName == "line" && name == "from")
-	      evalPairAttribute(elem, value, "x1", "y1");
+	      evalPairAttribute(elem, tokens, "x1", "y1");
 	    else if (elemName == "line" && name == "to")
-	      evalPairAttribute(elem, value, "x2", "y2");
+	      evalPairAttribute(elem, tokens, "x2", "y2");
 	    else
-	      evalAttribute(elem, value, name);
+	      evalAttribute(elem, tokens, name);
 	  }
       }
       for (Model::NodeIterator p(node); p.more(); p.next())
@@ -1039,25 +994,15 @@ SMS::process(const String& uri, const String& outName)
 
   traverse(Model::asNode(root));
   findFragmentDependencies();
-#if 0
-  std::cerr << "stampa dipendenze" << std::endl;
-  for (std::list<SmartPtr<Fragment> >::iterator it = fragmentList.begin();
-       it != fragmentList.end();
-       it++)
-    {
-      std::cerr << *it << std::endl;
-      (*it)->printDep();
-    }
-#endif
   
-  std::list<SmartPtr<Fragment> > sortedFragments;
+  std::vector<SmartPtr<Fragment> > sortedFragments;
   if (sortFragments(sortedFragments))
     {
       logger->out(LOG_ERROR, "circular dependencies in MathML fragments");
       exit(1);
     }
   
-  for (std::list<SmartPtr<Fragment> >::const_iterator f = sortedFragments.begin();
+  for (std::vector<SmartPtr<Fragment> >::const_iterator f = sortedFragments.begin();
        f != sortedFragments.end();
        f++)
     {
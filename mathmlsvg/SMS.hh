@@ -23,7 +23,7 @@
 #ifndef __SMS_hh__
 #define __SMS_hh__
 
-#include <list>
+#include <vector>
 
 #include "Fragment.hh"
 #include "MathView.hh"
@@ -31,7 +31,8 @@
 #include "Length.hh"
 #include "scaled.hh"
 #include "HashMap.hh"
-#include "SVG_EvalRenderingContext.hh"
+#include "StringHash.hh"
+#include "Scanner.hh"
 
 class SMS
 {
@@ -54,19 +55,18 @@ protected:
   bool asScalar(const SmartPtr<Value>&, scaled&) const;
   bool asPair(const SmartPtr<Value>&, Point&) const;
   void traverse(const Model::Node&);
+  void collectLocations(const Model::Element&);
   void substFragments(void);
   void evalAttributes(const Model::Node&);
-  SmartPtr<Value> evalExpr(class Scanner&);
-  bool evalAttribute(const Model::Element&, const String&, const String&);
-  // bool evalScalarAttribute(const Model::Element& , const String&, const String&);
-  bool evalPairAttribute(const Model::Element&, const String&, const String&, const String&);
-  void dependAssocList(const Model::Node&, SmartPtr<Fragment>);
-  bool isGmvNamespace(const xmlChar* ns);
-  void createFragDepList();
+  SmartPtr<Value> evalExpr(class TokenStream&);
+  bool evalAttribute(const Model::Element&, const Scanner::TokenVector&, const String&);
+  bool evalPairAttribute(const Model::Element&, const Scanner::TokenVector&, const String&, const String&);
+  static bool isPairAttribute(const String&, const String&);
+  const Scanner::TokenVector& getAttributeTokens(xmlAttr*);
 
   void findFragmentDependencies();
   void assoc(const Model::Node&, const SmartPtr<Fragment>&);
-  bool sortFragments(std::list<SmartPtr<Fragment> >&) const;
+  bool sortFragments(std::vector<SmartPtr<Fragment> >&) const;
 
   SmartPtr<Location> getLocationOfId(const String&) const;
 
@@ -99,9 +99,7 @@ protected:
 private:
   SmartPtr<class AbstractLogger> logger;
   SmartPtr<MathView> view;
-  SVG_EvalRenderingContext evalContext;
-  std::list<SmartPtr<Fragment> > fragmentList;
-  std::list<xmlChar*> getDepFromAttr(const xmlChar *value);
+  std::vector<SmartPtr<Fragment> > fragmentList;
   scaled pageWidth;
   scaled pageHeight;
   scaled canvasWidth;
@@ -115,6 +113,25 @@ private:
   typedef HASH_MAP_NS::hash_map<String,SmartPtr<Fragment>,StringHash,StringEq> IdFragmentMap;
   IdFragmentMap idFragmentMap;
 
+  // locations of the MathML elements with an id, relative
+  // to the origin of the fragment they belong to
+  typedef HASH_MAP_NS::hash_map<String,SmartPtr<Location>,StringHash,StringEq> IdLocationMap;
+  IdLocationMap idLocationMap;
+
+  struct xmlAttr_hash
+  {
+    size_t operator()(const xmlAttr* attr) const
+    {
+      assert(attr);
+      return reinterpret_cast<size_t>(attr);
+    }
+  };
+
+  // gmv: attributes are scanned once and the tokens are reused
+  // both for dependency analysis and for evaluation
+  typedef HASH_MAP_NS::hash_map<const xmlAttr*,Scanner::TokenVector,xmlAttr_hash> AttributeTokensMap;
+  AttributeTokensMap attributeTokensMap;
+
   typedef HASH_MAP_NS::hash_map<String,Handler,StringHash,StringEq> FunMap;
   FunMap funMap;
 };
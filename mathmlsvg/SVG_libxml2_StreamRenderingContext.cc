@@ -50,7 +50,9 @@ SVG_libxml2_StreamRenderingContext::toSVGLength(const scaled& s) const
 String
 SVG_libxml2_StreamRenderingContext::getId(const SmartPtr<Element>& elem) const
 {
-  assert(elem);
+  // the wrappers of areas restored from the area cache refer to no
+  // element, they are rendered without an id
+  if (!elem) return "";
   if (xmlElement* el = view->modelElementOfElement(elem))
     {
       if (xmlChar* id = xmlGetProp((xmlNode*) el, libxml2_Model::toModelString("id")))
@@ -138,3 +138,31 @@ Scanner::getNumber() const
   assert(v);
   return v->getValue();
 }
+
+void
+Scanner::tokenize(const UCS4String& s, bool mode, TokenVector& res)
+{
+  Scanner scanner(s, mode);
+  while (true)
+    {
+      Token token;
+      token.id = scanner.getToken();
+      token.number = 0;
+      switch (token.id)
+	{
+	case RAW:
+	case ID:
+	  token.string = scanner.getString();
+	  break;
+	case NUMBER:
+	  token.number = scanner.getNumber();
+	  break;
+	default:
+	  break;
+	}
+      res.push_back(token);
+      if (token.id == EOS || token.id == ERROR)
+	return;
+      scanner.advance();
+    }
+}
@@ -23,6 +23,9 @@
 #ifndef __Scanner_hh__
 #define __Scanner_hh__
 
+#include <cassert>
+#include <vector>
+
 #include "String.hh"
 #include "Value.hh"
 #include "SmartPtr.hh"
@@ -56,6 +59,18 @@ public:
 
   UCS4String getString(void) const;
   float getNumber(void) const;
+
+  struct Token
+  {
+    TokenId id;
+    UCS4String string;
+    float number;
+  };
+
+  typedef std::vector<Token> TokenVector;
+  // scans the whole string once, the resulting vector always
+  // ends with an EOS or an ERROR token
+  static void tokenize(const UCS4String&, bool, TokenVector&);
   
 protected:
   TokenId scanToken(void);
@@ -69,4 +84,24 @@ private:
   UCS4String::const_iterator end;
 };
 
+// TokenStream replays a vector of tokens produced by Scanner::tokenize
+// through the same interface as Scanner, so that an attribute value
+// can be scanned once and evaluated any number of times
+class TokenStream
+{
+public:
+  TokenStream(const Scanner::TokenVector& v) : p(v.begin()), end(v.end()) { }
+
+  bool more(void) const { return p != end && p->id != Scanner::EOS; }
+  Scanner::TokenId getToken(void) const { return (p != end) ? p->id : Scanner::EOS; }
+  void advance(void) { if (p != end && p->id != Scanner::EOS && p->id != Scanner::ERROR) p++; }
+
+  UCS4String getString(void) const { assert(p != end); return p->string; }
+  float getNumber(void) const { assert(p != end); return p->number; }
+
+private:
+  Scanner::TokenVector::const_iterator p;
+  Scanner::TokenVector::const_iterator end;
+};
+
 #endif // __Scanner_hh__
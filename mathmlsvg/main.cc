@@ -25,6 +25,7 @@
 #include <cassert>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #ifdef __linux__
 /* to get getopt on Linux */
 #ifndef __USE_POSIX2
@@ -39,12 +40,14 @@
 #include "CharTraits.icc"
 
 #include "Logger.hh"
+#include "ForkServer.hh"
 
 #include "Init.hh"
 #include "Configuration.hh"
 #include "libxml2_MathView.hh"
 #include "MathMLOperatorDictionary.hh"
 #include "SVG_Backend.hh"
+#include "ShaperManager.hh"
 #include "SVG_MathGraphicDevice.hh"
 #include "SVG_libxml2_StreamRenderingContext.hh"
 #include "MathMLNamespaceContext.hh"
@@ -64,11 +67,15 @@ static Length::Unit unitId = Length::CM_UNIT;
 static double xMargin = 2;
 static double yMargin = 2;
 static double fontSize = DEFAULT_FONT_SIZE;
+static double zoom = 1;
 static bool   cropping = true;
 static bool   cutFileName = true;
 static char* configPath = 0;
 static int logLevel = LOG_ERROR;
 static bool logLevelSet = false;
+static char* serverPath = 0;
+static int workers = 4;
+static int requestsPerWorker = 0;
 
 enum CommandLineOptionId {
   OPTION_VERSION = 256,
@@ -77,9 +84,13 @@ enum CommandLineOptionId {
   OPTION_UNIT,
   OPTION_MARGINS,
   OPTION_FONT_SIZE,
+  OPTION_ZOOM,
   OPTION_CROP,
   OPTION_CUT_FILENAME,
-  OPTION_CONFIG
+  OPTION_CONFIG,
+  OPTION_SERVER,
+  OPTION_WORKERS,
+  OPTION_REQUESTS_PER_WORKER
 };
 
 static void
@@ -100,9 +111,13 @@ static struct poptOption optionsTable[] = {
   { "page-size", 'p', POPT_ARG_STRING, 0, OPTION_PAGE_SIZE, "Page size (width x height) (default = 21 x 29.7)", "<float>x<float>" },
   { "margins", 'm', POPT_ARG_STRING, 0, OPTION_MARGINS, "Margins (top x left) (default = 2 x 2)", "<float>x<float>" },
   { "font-size", 'f', POPT_ARG_DOUBLE, &fontSize, OPTION_FONT_SIZE, "Default font size (in pt, default=10)", "<float>" },
+  { "zoom", 'z', POPT_ARG_DOUBLE, &zoom, OPTION_ZOOM, "Scale factor applied to the output (default=1)", "<float>" },
   { "config", 0, POPT_ARG_STRING, 0, OPTION_CONFIG, "Configuration file path", "<path>" },
   { "crop", 'r', POPT_ARG_STRING | POPT_ARGFLAG_OPTIONAL, 0, OPTION_CROP, "Enable/disable cropping to bounding box (default='yes')", "[yes,no]" },
   { "cut-filename", 0, POPT_ARG_STRING | POPT_ARGFLAG_OPTIONAL, 0, OPTION_CUT_FILENAME, "Cut the prefix dir from the output file (default='yes')", "[yes,no]" },
+  { "server", 0, POPT_ARG_STRING, 0, OPTION_SERVER, "Serve requests on a UNIX socket, the files are rendered once to warm up the caches", "<path>" },
+  { "workers", 0, POPT_ARG_INT, &workers, OPTION_WORKERS, "Number of worker processes in server mode (default=4)", "<int>" },
+  { "requests-per-worker", 0, POPT_ARG_INT, &requestsPerWorker, OPTION_REQUESTS_PER_WORKER, "Replace a worker after it has served this many requests (default=0, never)", "<int>" },
   POPT_AUTOHELP
   { 0, 0, 0, 0, 0, 0, 0 }
 };
@@ -240,6 +255,51 @@ getOutputFileName(const char* in)
   return out;
 }
 
+struct Converter
+{
+  SmartPtr<AbstractLogger> logger;
+  SmartPtr<MathView> view;
+  scaled width;
+  scaled height;
+  scaled xMargin;
+  scaled yMargin;
+};
+
+static void
+render(const Converter& conv, std::ostream& os)
+{
+  const BoundingBox box = conv.view->getBoundingBox();
+  //SVG_StreamRenderingContext rc(logger, os);
+  SVG_libxml2_StreamRenderingContext rc(conv.logger, os, conv.view);
+  // the formatted document is only scaled, not formatted again
+  rc.setZoom(zoom);
+  if (cropping)
+    {
+      rc.documentStart(box);
+      conv.view->render(rc, 0, -box.height);
+    }
+  else
+    {
+      rc.documentStart(BoundingBox(conv.width, box.height, conv.height - box.height));
+      conv.view->render(rc, conv.xMargin, -(conv.yMargin + box.height));
+    }
+  rc.documentEnd();
+}
+
+// a request is a MathML document, the response is its SVG rendering
+static bool
+serveRequest(const std::string& request, std::string& response, void* data)
+{
+  const Converter& conv = *static_cast<const Converter*>(data);
+  if (!conv.view->loadBuffer(request.c_str()))
+    return false;
+  std::ostringstream os;
+  render(conv, os);
+  conv.view->resetRootElement();
+  response = os.str();
+  return true;
+}
+
 int
 main(int argc, const char* argv[])
 {
@@ -272,6 +332,9 @@ main(int argc, const char* argv[])
 	  break;
 	case OPTION_FONT_SIZE:
 	  break;
+	case OPTION_ZOOM:
+	  if (zoom <= 0) parseError(ctxt, "zoom");
+	  break;
 	case OPTION_CROP:
 	  if (arg == 0) cropping = true;
 	  else if (!parseBoolean(arg, cropping)) parseError(ctxt, "crop");
@@ -284,6 +347,16 @@ main(int argc, const char* argv[])
 	  assert(arg != 0);
 	  configPath = strdup(arg);
 	  break;
+	case OPTION_SERVER:
+	  assert(arg != 0);
+	  serverPath = strdup(arg);
+	  break;
+	case OPTION_WORKERS:
+	  if (workers <= 0) parseError(ctxt, "workers");
+	  break;
+	case OPTION_REQUESTS_PER_WORKER:
+	  if (requestsPerWorker < 0) parseError(ctxt, "requests-per-worker");
+	  break;
 	default:
 	  assert(false);
 	}
@@ -309,6 +382,7 @@ main(int argc, const char* argv[])
   SmartPtr<MathMLOperatorDictionary> dictionary = initOperatorDictionary<MathView>(logger, configuration);
 
   logger->out(LOG_INFO, "Font size : %f", fontSize);
+  logger->out(LOG_INFO, "Zoom      : %f", zoom);
   logger->out(LOG_INFO, "Page size : %fx%f", width, height);
   logger->out(LOG_INFO, "Margins   : %fx%f", xMargin, yMargin);
 
@@ -333,6 +407,36 @@ main(int argc, const char* argv[])
 
   view->setAvailableWidth(widthS - xMarginS * 2);
 
+  Converter conv;
+  conv.logger = logger;
+  conv.view = view;
+  conv.width = widthS;
+  conv.height = heightS;
+  conv.xMargin = xMarginS;
+  conv.yMargin = yMarginS;
+
+  if (serverPath)
+    {
+      // prepare then fork: the files are rendered and thrown away so
+      // that the caches are warm before the workers are forked
+      const char* file = 0;
+      while ((file = poptGetArg(ctxt)) != 0)
+	{
+	  logger->out(LOG_INFO, "Warming up with `%s'...", file);
+	  view->loadURI(file);
+	  std::ostringstream os;
+	  render(conv, os);
+	  view->resetRootElement();
+	}
+      backend->getShaperManager()->registerPendingShapers();
+      mgd->freezeCache();
+
+      ForkServer server(logger, serverPath, workers, requestsPerWorker);
+      const bool ok = server.run(serveRequest, &conv);
+      poptFreeContext(ctxt);
+      return ok ? 0 : 1;
+    }
+
   const char* file = 0;
   while ((file = poptGetArg(ctxt)) != 0)
     {
@@ -348,23 +452,10 @@ main(int argc, const char* argv[])
       view->loadReader(reader);
 #endif
       view->loadURI(file);
-      const BoundingBox box = view->getBoundingBox();
 
       std::ofstream os(outName);
       delete [] outName;
-      //SVG_StreamRenderingContext rc(logger, os);
-      SVG_libxml2_StreamRenderingContext rc(logger, os, view);
-      if (cropping)
-	{
-	  rc.documentStart(box);
-	  view->render(rc, 0, -box.height);
-	}
-      else
-	{
-	  rc.documentStart(BoundingBox(widthS, box.height, heightS - box.height));
-	  view->render(rc, xMarginS, -(yMarginS + box.height));
-	}
-      rc.documentEnd();
+      render(conv, os);
       view->resetRootElement();
       os.close();
       // WARNING: currently the text reader is freed by libxmlXmlReader
@@ -0,0 +1,117 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <map>
+
+#include "AbstractLogger.hh"
+#include "Configuration.hh"
+#include "Cairo_Backend.hh"
+#include "Cairo_AreaFactory.hh"
+#include "Cairo_TFMComputerModernMathGraphicDevice.hh"
+#include "Cairo_TFMComputerModernShaper.hh"
+#if GMV_ENABLE_BOXML
+#include "Cairo_BoxGraphicDevice.hh"
+#endif // GMV_ENABLE_BOXML
+#if HAVE_CAIRO_FT
+#include "OpenTypeMathFont.hh"
+#include "OpenTypeMathGraphicDevice.hh"
+#include "OpenTypeMathShaper.hh"
+#endif // HAVE_CAIRO_FT
+#include "SpaceShaper.hh"
+#include "NullShaper.hh"
+#include "TFMManager.hh"
+#include "TFMFontManager.hh"
+#include "ShaperManager.hh"
+
+Cairo_Backend::Cairo_Backend(const SmartPtr<AbstractLogger>& l, const SmartPtr<Configuration>& conf)
+  : Backend(l, conf)
+{
+  SmartPtr<Cairo_AreaFactory> factory = Cairo_AreaFactory::create();
+  SmartPtr<TFMManager> tfm = TFMManager::create();
+  SmartPtr<TFMFontManager> fm = TFMFontManager::create(tfm);
+
+  std::multimap<int, SmartPtr<Shaper> > shaperSet;
+  if (conf->getBool(l, "cairo-backend/null-shaper/enabled", false))
+    shaperSet.insert(std::pair<int,SmartPtr<Shaper> >(conf->getInt(l, "cairo-backend/null-shaper/priority", 0),
+						      NullShaper::create(l)));
+
+  if (conf->getBool(l, "cairo-backend/space-shaper/enabled", false))
+    shaperSet.insert(std::pair<int,SmartPtr<Shaper> >(conf->getInt(l, "cairo-backend/space-shaper/priority", 0),
+						      SpaceShaper::create()));
+
+  // the metrics always come from the TFM files, so the
+  // formatting does not depend on the fonts that are installed
+  SmartPtr<Cairo_TFMComputerModernShaper> cmShaper = Cairo_TFMComputerModernShaper::create(l, conf);
+  cmShaper->setFontManager(fm);
+  if (conf->getBool(l, "cairo-backend/ttf-computer-modern-shaper/enabled", true))
+    shaperSet.insert(std::pair<int,SmartPtr<Shaper> >(conf->getInt(l, "cairo-backend/ttf-computer-modern-shaper/priority", 0),
+						      cmShaper));
+
+#if HAVE_CAIRO_FT
+  // an OpenType math font replaces the TFM metrics altogether
+  SmartPtr<OpenTypeMathFont> otFont;
+  if (conf->getBool(l, "cairo-backend/opentype-math-shaper/enabled", false))
+    {
+      const String fontFile = conf->getString(l, "cairo-backend/opentype-math-shaper/font", "");
+      if (fontFile.empty())
+	l->out(LOG_WARNING, "no font given for the OpenType math shaper");
+      else if ((otFont = OpenTypeMathFont::create(l, fontFile)))
+	shaperSet.insert(std::pair<int,SmartPtr<Shaper> >(conf->getInt(l, "cairo-backend/opentype-math-shaper/priority", 0),
+							  OpenTypeMathShaper::create(l, otFont)));
+    }
+
+  if (otFont)
+    {
+      SmartPtr<OpenTypeMathGraphicDevice> mgd = OpenTypeMathGraphicDevice::create(l);
+      mgd->setFont(otFont);
+      mgd->setFactory(factory);
+      setMathGraphicDevice(mgd);
+    }
+  else
+#endif // HAVE_CAIRO_FT
+    {
+      SmartPtr<Cairo_TFMComputerModernMathGraphicDevice> mgd = Cairo_TFMComputerModernMathGraphicDevice::create(l, conf);
+      mgd->setFamily(cmShaper->getFamily());
+      mgd->setTFMManager(tfm);
+      mgd->setFactory(factory);
+      setMathGraphicDevice(mgd);
+    }
+#if GMV_ENABLE_BOXML
+  SmartPtr<BoxGraphicDevice> bgd = Cairo_BoxGraphicDevice::create(l, conf);
+  bgd->setFactory(factory);
+  setBoxGraphicDevice(bgd);
+#endif // GMV_ENABLE_BOXML
+
+  for (std::multimap<int, SmartPtr<Shaper> >::const_iterator p = shaperSet.begin();
+       p != shaperSet.end();
+       p++)
+    getShaperManager()->registerShaper(p->second);
+}
+
+Cairo_Backend::~Cairo_Backend()
+{ }
+
+SmartPtr<Cairo_Backend>
+Cairo_Backend::create(const SmartPtr<AbstractLogger>& l, const SmartPtr<Configuration>& conf)
+{ return new Cairo_Backend(l, conf); }
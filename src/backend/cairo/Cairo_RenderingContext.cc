@@ -0,0 +1,281 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+#if HAVE_CAIRO_FT
+#include <cairo-ft.h>
+#endif // HAVE_CAIRO_FT
+
+#include "AbstractLogger.hh"
+#include "Cairo_RenderingContext.hh"
+#include "OpenTypeMathFont.hh"
+#include "TFM.hh"
+#include "TFMFont.hh"
+
+Cairo_RenderingContext::Cairo_RenderingContext(const SmartPtr<AbstractLogger>& l)
+  : logger(l), fgColor(RGBColor::BLACK()), bgColor(0xff, 0xff, 0xff, 0x00), resolution(1.0),
+    surface(0), cr(0), fontScale(0.0)
+{
+  assert(logger);
+}
+
+Cairo_RenderingContext::~Cairo_RenderingContext()
+{
+  clearFonts();
+  if (cr) cairo_destroy(cr);
+  if (surface) cairo_surface_destroy(surface);
+  for (FaceCache::iterator p = faceCache.begin(); p != faceCache.end(); p++)
+    if (p->second) cairo_font_face_destroy(p->second);
+}
+
+void
+Cairo_RenderingContext::clearFonts()
+{
+  for (FontCache::iterator p = fontCache.begin(); p != fontCache.end(); p++)
+    {
+      cairo_scaled_font_destroy(p->second->scaledFont);
+      delete p->second;
+    }
+  fontCache.clear();
+}
+
+void
+Cairo_RenderingContext::setSource(const RGBColor& c)
+{
+  assert(cr);
+  cairo_set_source_rgba(cr, c.red / 255.0, c.green / 255.0, c.blue / 255.0, c.alpha / 255.0);
+}
+
+void
+Cairo_RenderingContext::documentStart(const BoundingBox& box)
+{
+  const double scale = resolution * getZoom();
+  const int width = std::max(1, static_cast<int>(ceil(box.horizontalExtent().toDouble() * scale)));
+  const int height = std::max(1, static_cast<int>(ceil(box.verticalExtent().toDouble() * scale)));
+
+  if (cr) cairo_destroy(cr);
+  if (surface) cairo_surface_destroy(surface);
+  surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+  cr = cairo_create(surface);
+  if (cairo_status(cr) != CAIRO_STATUS_SUCCESS)
+    logger->out(LOG_ERROR, "could not create a %dx%d image: %s",
+		width, height, cairo_status_to_string(cairo_status(cr)));
+
+  cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+  setSource(bgColor);
+  cairo_paint(cr);
+  cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+  cairo_scale(cr, scale, scale);
+
+  if (scale != fontScale)
+    {
+      clearFonts();
+      fontScale = scale;
+    }
+}
+
+void
+Cairo_RenderingContext::documentEnd()
+{
+  assert(surface);
+  cairo_surface_flush(surface);
+}
+
+void
+Cairo_RenderingContext::fill(const scaled& x, const scaled& y, const BoundingBox& box)
+{
+  setSource(fgColor);
+  cairo_rectangle(cr, toCairoX(x), toCairoY(y + box.height),
+		  box.horizontalExtent().toDouble(), box.verticalExtent().toDouble());
+  cairo_fill(cr);
+}
+
+cairo_scaled_font_t*
+Cairo_RenderingContext::getScaledFont(const SmartPtr<TFMFont>& font, UChar8 index, unsigned long& glyph)
+{
+  CachedFont* cached;
+  FontCache::const_iterator p = fontCache.find(font);
+  if (p != fontCache.end())
+    cached = p->second;
+  else
+    {
+      // the TrueType fonts are found by fontconfig under the same
+      // name as the TFM they come with
+      const SmartPtr<TFM> tfm = font->getTFM();
+      std::ostringstream familyS;
+      familyS << tfm->getFamily() << tfm->getDesignSize().toInt();
+      const String family = familyS.str();
+
+      cairo_font_face_t* face = cairo_toy_font_face_create(family.c_str(),
+							   CAIRO_FONT_SLANT_NORMAL,
+							   CAIRO_FONT_WEIGHT_NORMAL);
+      cairo_matrix_t fontMatrix;
+      cairo_matrix_init_scale(&fontMatrix, font->getSize().toDouble(), font->getSize().toDouble());
+      cairo_matrix_t ctm;
+      cairo_matrix_init_scale(&ctm, fontScale, fontScale);
+      cairo_font_options_t* options = cairo_font_options_create();
+
+      cached = new CachedFont;
+      cached->font = font;
+      cached->scaledFont = cairo_scaled_font_create(face, &fontMatrix, &ctm, options);
+      for (unsigned i = 0; i < 256; i++) cached->glyph[i] = -1;
+      cairo_font_options_destroy(options);
+      cairo_font_face_destroy(face);
+
+      if (cairo_scaled_font_status(cached->scaledFont) != CAIRO_STATUS_SUCCESS)
+	logger->out(LOG_WARNING, "could not load font `%s'", family.c_str());
+      fontCache[font] = cached;
+    }
+
+  if (cached->glyph[index] < 0)
+    {
+      // the index is a Latin-1 character code of the TrueType font,
+      // encoded as UTF-8 with one byte up to 0x7f and two bytes above
+      char utf8[2];
+      int length = 0;
+      if (index < 0x80)
+	utf8[length++] = index;
+      else
+	{
+	  utf8[length++] = 0xc0 | (index >> 6);
+	  utf8[length++] = 0x80 | (index & 0x3f);
+	}
+
+      cairo_glyph_t* glyphs = 0;
+      int nGlyphs = 0;
+      cached->glyph[index] = 0;
+      if (cairo_scaled_font_text_to_glyphs(cached->scaledFont, 0, 0, utf8, length,
+					   &glyphs, &nGlyphs, 0, 0, 0) == CAIRO_STATUS_SUCCESS
+	  && nGlyphs > 0)
+	cached->glyph[index] = glyphs[0].index;
+      cairo_glyph_free(glyphs);
+    }
+
+  glyph = cached->glyph[index];
+  return cached->scaledFont;
+}
+
+void
+Cairo_RenderingContext::draw(const scaled& x, const scaled& y, const SmartPtr<TFMFont>& font, UChar8 index)
+{
+  cairo_glyph_t glyph;
+  cairo_set_scaled_font(cr, getScaledFont(font, index, glyph.index));
+  glyph.x = toCairoX(x);
+  glyph.y = toCairoY(y);
+  setSource(fgColor);
+  cairo_show_glyphs(cr, &glyph, 1);
+}
+
+#if HAVE_CAIRO_FT
+// Cairo may keep a face alive after the last font face referring to
+// it is destroyed, so the library is shared and never released
+static FT_Library ftLibrary = 0;
+static const cairo_user_data_key_t ftFaceKey = { 0 };
+
+static void
+destroyFTFace(void* face)
+{ FT_Done_Face(static_cast<FT_Face>(face)); }
+#endif // HAVE_CAIRO_FT
+
+cairo_font_face_t*
+Cairo_RenderingContext::getFontFace(const OpenTypeMathFont& font)
+{
+  FaceCache::const_iterator p = faceCache.find(&font);
+  if (p != faceCache.end()) return p->second;
+
+  cairo_font_face_t* face = 0;
+#if HAVE_CAIRO_FT
+  FT_Face ftFace;
+  if (!ftLibrary && FT_Init_FreeType(&ftLibrary))
+    {
+      logger->out(LOG_ERROR, "could not initialize FreeType");
+      ftLibrary = 0;
+    }
+  else if (FT_New_Face(ftLibrary, font.getFileName().c_str(), 0, &ftFace))
+    logger->out(LOG_WARNING, "could not load font `%s'", font.getFileName().c_str());
+  else
+    {
+      face = cairo_ft_font_face_create_for_ft_face(ftFace, 0);
+      if (cairo_font_face_set_user_data(face, &ftFaceKey, ftFace, destroyFTFace) != CAIRO_STATUS_SUCCESS)
+	{
+	  cairo_font_face_destroy(face);
+	  FT_Done_Face(ftFace);
+	  face = 0;
+	}
+    }
+#endif // HAVE_CAIRO_FT
+
+  faceCache[&font] = face;
+  return face;
+}
+
+void
+Cairo_RenderingContext::drawOpenTypeGlyph(const scaled& x, const scaled& y,
+					  const OpenTypeMathFont& font, unsigned index, const scaled& size)
+{
+  if (cairo_font_face_t* face = getFontFace(font))
+    {
+      cairo_glyph_t glyph;
+      glyph.index = index;
+      glyph.x = toCairoX(x);
+      glyph.y = toCairoY(y);
+      cairo_set_font_face(cr, face);
+      cairo_set_font_size(cr, size.toDouble());
+      setSource(fgColor);
+      cairo_show_glyphs(cr, &glyph, 1);
+    }
+}
+
+const unsigned char*
+Cairo_RenderingContext::getData() const
+{ return surface ? cairo_image_surface_get_data(surface) : 0; }
+
+int
+Cairo_RenderingContext::getWidth() const
+{ return surface ? cairo_image_surface_get_width(surface) : 0; }
+
+int
+Cairo_RenderingContext::getHeight() const
+{ return surface ? cairo_image_surface_get_height(surface) : 0; }
+
+int
+Cairo_RenderingContext::getStride() const
+{ return surface ? cairo_image_surface_get_stride(surface) : 0; }
+
+bool
+Cairo_RenderingContext::writePNG(const String& fileName) const
+{
+  assert(surface);
+  const cairo_status_t status = cairo_surface_write_to_png(surface, fileName.c_str());
+  if (status != CAIRO_STATUS_SUCCESS)
+    {
+      logger->out(LOG_ERROR, "could not write `%s': %s", fileName.c_str(), cairo_status_to_string(status));
+      return false;
+    }
+  return true;
+}
@@ -0,0 +1,121 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __Cairo_RenderingContext_hh__
+#define __Cairo_RenderingContext_hh__
+
+#include <cairo.h>
+
+#include "Char.hh"
+#include "SmartPtr.hh"
+#include "RGBColor.hh"
+#include "BoundingBox.hh"
+#include "RenderingContext.hh"
+#include "OpenTypeGlyphRenderer.hh"
+#include "String.hh"
+#include "HashMap.hh"
+
+// Cairo_RenderingContext draws the areas into an image surface kept
+// in memory. Lengths are in points, the resolution says how many
+// pixels are in a point and the zoom is applied on top of it
+class GMV_BackEnd_EXPORT Cairo_RenderingContext : public RenderingContext, public OpenTypeGlyphRenderer
+{
+public:
+  Cairo_RenderingContext(const SmartPtr<class AbstractLogger>&);
+  virtual ~Cairo_RenderingContext();
+
+  void setForegroundColor(const RGBColor& c) { fgColor = c; }
+  void setBackgroundColor(const RGBColor& c) { bgColor = c; }
+
+  RGBColor getForegroundColor(void) const { return fgColor; }
+  RGBColor getBackgroundColor(void) const { return bgColor; }
+
+  void setResolution(double r) { resolution = r; }
+  double getResolution(void) const { return resolution; }
+
+  // the image is as large as the box and it is cleared with the
+  // background color, which is transparent unless set otherwise
+  virtual void documentStart(const BoundingBox&);
+  virtual void documentEnd(void);
+  virtual void fill(const scaled&, const scaled&, const BoundingBox&);
+  virtual void draw(const scaled&, const scaled&, const SmartPtr<class TFMFont>&, UChar8);
+  // draws nothing unless Cairo was built with FreeType support
+  virtual void drawOpenTypeGlyph(const scaled&, const scaled&,
+				 const class OpenTypeMathFont&, unsigned, const scaled&);
+
+  // premultiplied ARGB pixels in native endianness, one row every
+  // getStride() bytes
+  const unsigned char* getData(void) const;
+  int getWidth(void) const;
+  int getHeight(void) const;
+  int getStride(void) const;
+  bool writePNG(const String&) const;
+
+  static double toCairoX(const scaled& x) { return x.toDouble(); }
+  static double toCairoY(const scaled& y) { return -y.toDouble(); }
+
+protected:
+  void setSource(const RGBColor&);
+  cairo_scaled_font_t* getScaledFont(const SmartPtr<class TFMFont>&, UChar8, unsigned long&);
+  void clearFonts(void);
+  cairo_font_face_t* getFontFace(const class OpenTypeMathFont&);
+
+private:
+  SmartPtr<class AbstractLogger> logger;
+
+  RGBColor fgColor;
+  RGBColor bgColor;
+  double resolution;
+
+  cairo_surface_t* surface;
+  cairo_t* cr;
+
+  // the scaled fonts and the glyph indices for each TFMFont, valid
+  // as long as the pixels per point do not change
+  struct CachedFont
+  {
+    SmartPtr<class TFMFont> font;
+    cairo_scaled_font_t* scaledFont;
+    long glyph[256];
+  };
+  struct TFMFontPtrHash
+  {
+    size_t operator()(const class TFMFont* font) const
+    { return reinterpret_cast<size_t>(font); }
+  };
+
+  typedef HASH_MAP_NS::hash_map<const class TFMFont*, CachedFont*, TFMFontPtrHash> FontCache;
+  FontCache fontCache;
+  double fontScale;
+
+  // the faces of the OpenType fonts do not depend on the scale
+  struct OpenTypeMathFontPtrHash
+  {
+    size_t operator()(const class OpenTypeMathFont* font) const
+    { return reinterpret_cast<size_t>(font); }
+  };
+
+  typedef HASH_MAP_NS::hash_map<const class OpenTypeMathFont*, cairo_font_face_t*, OpenTypeMathFontPtrHash> FaceCache;
+  FaceCache faceCache;
+};
+
+#endif // __Cairo_RenderingContext_hh__
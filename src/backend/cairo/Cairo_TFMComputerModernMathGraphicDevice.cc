@@ -0,0 +1,77 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "AbstractLogger.hh"
+#include "Configuration.hh"
+#include "FormattingContext.hh"
+#include "Cairo_TFMComputerModernMathGraphicDevice.hh"
+#include "Cairo_TFMGlyphArea.hh"
+#include "TFMFont.hh"
+#include "TFM.hh"
+
+Cairo_TFMComputerModernMathGraphicDevice::Cairo_TFMComputerModernMathGraphicDevice(const SmartPtr<AbstractLogger>& l,
+										   const SmartPtr<Configuration>&)
+  : TFMComputerModernMathGraphicDevice(l)
+{ }
+
+Cairo_TFMComputerModernMathGraphicDevice::~Cairo_TFMComputerModernMathGraphicDevice()
+{ }
+
+SmartPtr<Cairo_TFMComputerModernMathGraphicDevice>
+Cairo_TFMComputerModernMathGraphicDevice::create(const SmartPtr<AbstractLogger>& logger,
+						 const SmartPtr<Configuration>& conf)
+{ return new Cairo_TFMComputerModernMathGraphicDevice(logger, conf); }
+
+AreaRef
+Cairo_TFMComputerModernMathGraphicDevice::script(const class FormattingContext& context,
+						 const AreaRef& base,
+						 const AreaRef& subScript, const Length& subScriptShift,
+						 const AreaRef& superScript, const Length& superScriptShift) const
+{
+  AreaRef nucleus = base;
+  while (nucleus && is_a<const BinContainerArea>(nucleus))
+    nucleus = smart_cast<const BinContainerArea>(nucleus)->getChild();
+
+  AreaRef newSuperScript = superScript;
+  if (superScript)
+    if (SmartPtr<const Cairo_TFMGlyphArea> glyph = smart_cast<const Cairo_TFMGlyphArea>(nucleus))
+      {
+	const SmartPtr<TFMFont> font = glyph->getFont();
+	const SmartPtr<TFM> tfm = font->getTFM();
+	const Char8 index = glyph->getIndex();
+	const scaled ic = tfm->getGlyphItalicCorrection(index) * tfm->getScale(font->getSize());
+	if (ic != scaled::zero())
+	  {
+	    std::vector<AreaRef> c;
+	    c.reserve(2);
+	    c.push_back(getFactory()->horizontalSpace(ic));
+	    c.push_back(superScript);
+	    newSuperScript = getFactory()->horizontalArray(c);
+	  }
+      }
+
+  return MathGraphicDevice::script(context, base,
+				   subScript, subScriptShift,
+				   newSuperScript, superScriptShift);
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __Cairo_TFMGlyphArea_hh__
+#define __Cairo_TFMGlyphArea_hh__
+
+#include "GlyphArea.hh"
+
+// the metrics come from the TFM, the glyph is drawn from the
+// TrueType version of the font whose index is given separately
+class Cairo_TFMGlyphArea : public GlyphArea
+{
+protected:
+  Cairo_TFMGlyphArea(const SmartPtr<class TFMFont>&, Char8, UChar8);
+  virtual ~Cairo_TFMGlyphArea();
+
+public:
+  static SmartPtr<Cairo_TFMGlyphArea> create(const SmartPtr<class TFMFont>&, Char8, UChar8);
+
+  virtual BoundingBox box(void) const;
+  virtual scaled leftEdge(void) const;
+  virtual scaled rightEdge(void) const;
+  virtual void render(class RenderingContext&, const scaled&, const scaled&) const;
+
+  SmartPtr<class TFMFont> getFont(void) const;
+  Char8 getIndex(void) const { return index; }
+  UChar8 getTTFIndex(void) const { return ttf_index; }
+
+private:
+  SmartPtr<class TFMFont> font;
+  Char8 index;
+  UChar8 ttf_index;
+};
+
+#endif // __Cairo_TFMGlyphArea_hh__
@@ -47,6 +47,17 @@ Area::originY(AreaIndex i) const
   return p.y;
 }
 
+void
+Area::makeImmortal() const
+{
+  if (!immortal())
+    {
+      setImmortal();
+      for (AreaIndex i = 0; i < size(); i++)
+	node(i)->makeImmortal();
+    }
+}
+
 bool
 Area::indexOfPosition(const scaled&, const scaled&, CharIndex&) const
 { return false; }
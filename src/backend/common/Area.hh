@@ -66,6 +66,9 @@ public:
 
   scaled originX(AreaIndex) const;
   scaled originY(AreaIndex) const;
+
+  // makes the area and its descendants immortal
+  void makeImmortal(void) const;
 };
 
 #endif // __Area_hh__
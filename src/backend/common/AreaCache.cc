@@ -0,0 +1,85 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <sstream>
+
+#include "AreaCache.hh"
+#include "AreaSerializer.hh"
+#include "Utils.hh"
+
+// stored data is prefixed by a header and by the full key, so that
+// entries of an older format or with a colliding digest are ignored
+#define AREA_CACHE_MAGIC "GMVA0001"
+
+AreaCache::AreaCache(const SmartPtr<AreaSerializer>& s, const String& b, const String& c)
+  : serializer(s), backend(b), configuration(c), hits(0), misses(0)
+{
+  assert(serializer);
+}
+
+AreaCache::~AreaCache()
+{ }
+
+SmartPtr<AreaSerializer>
+AreaCache::getSerializer() const
+{ return serializer; }
+
+String
+AreaCache::getKey(const String& document, unsigned fontSize, const scaled& width) const
+{
+  std::ostringstream os;
+  os << document << ' ' << fontSize << ' ' << width.getValue() << ' ' << backend << ' ' << configuration;
+  return os.str();
+}
+
+AreaRef
+AreaCache::lookup(const String& document, unsigned fontSize, const scaled& width) const
+{
+  const String key = getKey(document, fontSize, width);
+  const String header = AREA_CACHE_MAGIC + key + '\n';
+
+  std::string data;
+  if (load(MathViewNS::digestString(key), data)
+      && data.compare(0, header.length(), header) == 0)
+    if (AreaRef area = serializer->deserialize(data.substr(header.length())))
+      {
+	hits++;
+	return area;
+      }
+
+  misses++;
+  return 0;
+}
+
+bool
+AreaCache::store(const String& document, unsigned fontSize, const scaled& width, const AreaRef& area)
+{
+  assert(area);
+  std::string data;
+  if (!serializer->serialize(area, data))
+    return false;
+
+  const String key = getKey(document, fontSize, width);
+  return save(MathViewNS::digestString(key), AREA_CACHE_MAGIC + key + '\n' + data);
+}
@@ -0,0 +1,69 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __AreaCache_hh__
+#define __AreaCache_hh__
+
+#include <string>
+
+#include "Area.hh"
+#include "String.hh"
+
+// AreaCache keeps formatted area trees across processes.  An entry
+// is identified by the digest of the document, the font size, the
+// available width, the backend and the configuration.  The last two
+// are fixed for a given cache, the document digest is computed by the
+// caller (typically from the source of the document).  Subclasses
+// implement the storage.
+class GMV_MathView_EXPORT AreaCache : public Object
+{
+protected:
+  AreaCache(const SmartPtr<class AreaSerializer>&, const String&, const String&);
+  virtual ~AreaCache();
+
+public:
+  AreaRef lookup(const String&, unsigned, const scaled&) const;
+  bool store(const String&, unsigned, const scaled&, const AreaRef&);
+
+  SmartPtr<class AreaSerializer> getSerializer(void) const;
+  String getBackend(void) const { return backend; }
+  String getConfiguration(void) const { return configuration; }
+
+  unsigned getHits(void) const { return hits; }
+  unsigned getMisses(void) const { return misses; }
+
+protected:
+  String getKey(const String&, unsigned, const scaled&) const;
+
+  // load and save the data associated with a key digest
+  virtual bool load(const String&, std::string&) const = 0;
+  virtual bool save(const String&, const std::string&) = 0;
+
+private:
+  SmartPtr<class AreaSerializer> serializer;
+  String backend;
+  String configuration;
+  mutable unsigned hits;
+  mutable unsigned misses;
+};
+
+#endif // __AreaCache_hh__
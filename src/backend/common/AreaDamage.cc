@@ -0,0 +1,97 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <typeinfo>
+
+#include "AreaDamage.hh"
+#include "ColorArea.hh"
+#include "ContainerArea.hh"
+#include "Point.hh"
+
+void
+AreaDamage::compare(const AreaRef& oldArea, const AreaRef& newArea, std::vector<Rectangle>& rects)
+{
+  compare(oldArea, scaled::zero(), scaled::zero(), newArea, scaled::zero(), scaled::zero(), rects);
+}
+
+void
+AreaDamage::compare(const AreaRef& oldArea, const scaled& oldX, const scaled& oldY,
+		    const AreaRef& newArea, const scaled& newX, const scaled& newY,
+		    std::vector<Rectangle>& rects)
+{
+  if (oldArea == newArea)
+    {
+      // areas are immutable, a shared subtree looks the same wherever it is
+      if (oldX != newX || oldY != newY)
+	{
+	  damage(oldArea, oldX, oldY, rects);
+	  damage(newArea, newX, newY, rects);
+	}
+    }
+  else if (sameLayout(oldArea, newArea))
+    for (AreaIndex i = 0; i < oldArea->size(); i++)
+      {
+	Point oldOrigin;
+	Point newOrigin;
+	oldArea->origin(i, oldOrigin);
+	newArea->origin(i, newOrigin);
+	compare(oldArea->node(i), oldX + oldOrigin.x, oldY + oldOrigin.y,
+		newArea->node(i), newX + newOrigin.x, newY + newOrigin.y,
+		rects);
+      }
+  else
+    {
+      damage(oldArea, oldX, oldY, rects);
+      damage(newArea, newX, newY, rects);
+    }
+}
+
+void
+AreaDamage::damage(const AreaRef& area, const scaled& x, const scaled& y, std::vector<Rectangle>& rects)
+{
+  const BoundingBox box = area->box();
+  if (box.defined())
+    {
+      const Rectangle rect(x, y, box);
+      if (!rect.isNull()) rects.push_back(rect);
+    }
+  else
+    for (AreaIndex i = 0; i < area->size(); i++)
+      {
+	Point origin;
+	area->origin(i, origin);
+	damage(area->node(i), x + origin.x, y + origin.y, rects);
+      }
+}
+
+bool
+AreaDamage::sameLayout(const AreaRef& oldArea, const AreaRef& newArea)
+{
+  // the children of two containers of the same kind can be compared
+  // pairwise, provided the container does not paint anything by itself
+  return is_a<const ContainerArea>(oldArea)
+    && !is_a<const ColorArea>(oldArea)
+    && typeid(*oldArea) == typeid(*newArea)
+    && oldArea->size() == newArea->size();
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __AreaDamage_hh__
+#define __AreaDamage_hh__
+
+#include <vector>
+
+#include "Area.hh"
+#include "Rectangle.hh"
+
+// AreaDamage compares two area trees and collects the rectangles
+// (relative to the origin of the roots) where they look different.
+// Subtrees shared by the two trees are skipped, unless they moved, in
+// which case both their old and their new place must be repainted
+class GMV_MathView_EXPORT AreaDamage
+{
+public:
+  static void compare(const AreaRef&, const AreaRef&, std::vector<Rectangle>&);
+
+protected:
+  static void compare(const AreaRef&, const scaled&, const scaled&,
+		      const AreaRef&, const scaled&, const scaled&,
+		      std::vector<Rectangle>&);
+  static void damage(const AreaRef&, const scaled&, const scaled&, std::vector<Rectangle>&);
+  static bool sameLayout(const AreaRef&, const AreaRef&);
+};
+
+#endif // __AreaDamage_hh__
@@ -0,0 +1,115 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "AreaPositionIndex.hh"
+#include "GlyphStringArea.hh"
+#include "GlyphWrapperArea.hh"
+#include "Element.hh"
+
+AreaPositionIndex::AreaPositionIndex(const AreaRef& r)
+  : root(r)
+{
+  assert(root);
+  build(root, scaled::zero(), scaled::zero(), root, Point());
+}
+
+AreaPositionIndex::~AreaPositionIndex()
+{ }
+
+void
+AreaPositionIndex::build(const AreaRef& area, const scaled& x, const scaled& y,
+			 const Area* owner, const Point& ownerOrigin)
+{
+  // areas may be shared, the first occurrence in depth-first order
+  // is the one that searchByArea would find
+  Point origin;
+  if ((area == root || area->getElement()) && index.find(area) == index.end())
+    {
+      Extents& extents = index[area];
+      extents.origin.set(x, y);
+      extents.box = area->box();
+      owner = area;
+      origin.set(x, y);
+    }
+  else
+    origin = ownerOrigin;
+
+  // the characters of the innermost indexed area are looked up in a
+  // glyph string only if nothing else in the area holds characters.
+  // Glyph strings and glyph wrappers are leaves as far as characters
+  // are concerned, and contain no area associated with an element
+  const bool string = is_a<const GlyphStringArea>(area);
+  const bool wrapper = is_a<const GlyphWrapperArea>(area);
+  if (string || wrapper || (area->size() == 0 && area->length() > 0))
+    {
+      Extents& extents = index[owner];
+      if (string && !extents.string && !extents.ambiguous && area->length() > 0)
+	{
+	  extents.string = smart_cast<const GlyphStringArea>(area);
+	  extents.stringOrigin.set(x - origin.x, y - origin.y);
+	}
+      else
+	{
+	  extents.string = 0;
+	  extents.ambiguous = true;
+	}
+    }
+  if (string || wrapper) return;
+
+  for (AreaIndex i = 0; i < area->size(); i++)
+    {
+      Point o;
+      area->origin(i, o);
+      build(area->node(i), x + o.x, y + o.y, owner, origin);
+    }
+}
+
+bool
+AreaPositionIndex::getExtents(const AreaRef& area, Point* origin, BoundingBox* box) const
+{
+  const Index::const_iterator p = index.find(area);
+  if (p != index.end())
+    {
+      if (origin) *origin = p->second.origin;
+      if (box) *box = p->second.box;
+      return true;
+    }
+  else
+    return false;
+}
+
+bool
+AreaPositionIndex::getGlyphString(const AreaRef& area, SmartPtr<const GlyphStringArea>& string,
+				  Point* origin) const
+{
+  const Index::const_iterator p = index.find(area);
+  if (p != index.end() && p->second.string)
+    {
+      string = p->second.string;
+      if (origin) *origin = p->second.stringOrigin;
+      return true;
+    }
+  else
+    return false;
+}
@@ -0,0 +1,78 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __AreaPositionIndex_hh__
+#define __AreaPositionIndex_hh__
+
+#include "Area.hh"
+#include "HashMap.hh"
+#include "Point.hh"
+
+// AreaPositionIndex records the origin (relative to the root) and the
+// bounding box of every area of a tree that is associated with an
+// element, so that element extents are found without searching.  When
+// all the characters of such an area are in one glyph string, the
+// glyph string and its origin are recorded as well, so that character
+// extents are found without searching either
+class GMV_MathView_EXPORT AreaPositionIndex : public Object
+{
+protected:
+  AreaPositionIndex(const AreaRef&);
+  virtual ~AreaPositionIndex();
+
+public:
+  static SmartPtr<AreaPositionIndex> create(const AreaRef& root)
+  { return new AreaPositionIndex(root); }
+
+  AreaRef getRoot(void) const { return root; }
+  unsigned getSize(void) const { return index.size(); }
+  bool getExtents(const AreaRef&, Point* = 0, BoundingBox* = 0) const;
+  // the origin is relative to the origin of the given area
+  bool getGlyphString(const AreaRef&, SmartPtr<const class GlyphStringArea>&, Point* = 0) const;
+
+protected:
+  void build(const AreaRef&, const scaled&, const scaled&, const Area*, const Point&);
+
+private:
+  struct Extents
+  {
+    Extents(void) : ambiguous(false) { }
+
+    Point origin;
+    BoundingBox box;
+    SmartPtr<const class GlyphStringArea> string;
+    Point stringOrigin;
+    bool ambiguous;
+  };
+
+  struct AreaHash
+  {
+    size_t operator()(const Area* area) const
+    { return reinterpret_cast<size_t>(area); }
+  };
+
+  typedef HASH_MAP_NS::hash_map<const Area*,Extents,AreaHash> Index;
+  const AreaRef root;
+  Index index;
+};
+
+#endif // __AreaPositionIndex_hh__
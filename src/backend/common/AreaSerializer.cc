@@ -0,0 +1,484 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cstring>
+
+#include "AreaFactory.hh"
+#include "AreaSerializer.hh"
+#include "GlyphArea.hh"
+#include "Point.hh"
+
+AreaSerializer::AreaSerializer(const SmartPtr<AreaFactory>& f)
+  : factory(f)
+{
+  assert(factory);
+}
+
+AreaSerializer::~AreaSerializer()
+{ }
+
+SmartPtr<AreaSerializer>
+AreaSerializer::create(const SmartPtr<AreaFactory>& factory)
+{ return new AreaSerializer(factory); }
+
+SmartPtr<AreaFactory>
+AreaSerializer::getFactory() const
+{ return factory; }
+
+void
+AreaSerializer::Output::putInt(int v)
+{
+  const Char32 w = v;
+  data.append(reinterpret_cast<const char*>(&w), sizeof(w));
+}
+
+void
+AreaSerializer::Output::putBoundingBox(const BoundingBox& box)
+{
+  putScaled(box.width);
+  putScaled(box.height);
+  putScaled(box.depth);
+}
+
+void
+AreaSerializer::Output::putRGBColor(const RGBColor& c)
+{ putInt((c.red << 24) | (c.green << 16) | (c.blue << 8) | c.alpha); }
+
+void
+AreaSerializer::Output::putString(const String& s)
+{
+  putInt(s.length());
+  data.append(s.data(), s.length());
+}
+
+int
+AreaSerializer::Input::getInt()
+{
+  Char32 w = 0;
+  if (!error && offset + sizeof(w) <= data.size())
+    {
+      memcpy(&w, data.data() + offset, sizeof(w));
+      offset += sizeof(w);
+    }
+  else
+    error = true;
+  return static_cast<int>(w);
+}
+
+BoundingBox
+AreaSerializer::Input::getBoundingBox()
+{
+  const scaled width = getScaled();
+  const scaled height = getScaled();
+  const scaled depth = getScaled();
+  return BoundingBox(width, height, depth);
+}
+
+RGBColor
+AreaSerializer::Input::getRGBColor()
+{
+  const unsigned c = getInt();
+  return RGBColor((c >> 24) & 0xff, (c >> 16) & 0xff, (c >> 8) & 0xff, c & 0xff);
+}
+
+String
+AreaSerializer::Input::getString()
+{
+  const int length = getInt();
+  if (!error && length >= 0 && offset + length <= data.size())
+    {
+      const String s(data.data() + offset, length);
+      offset += length;
+      return s;
+    }
+
+  error = true;
+  return String();
+}
+
+bool
+AreaSerializer::serialize(const AreaRef& area, std::string& data) const
+{
+  assert(area);
+  data.clear();
+  Output out(data);
+  const bool res = encodeArea(out, area);
+  encoded.clear();
+  return res;
+}
+
+AreaRef
+AreaSerializer::deserialize(const std::string& data) const
+{
+  Input in(data);
+  AreaRef area = decodeArea(in);
+  decoded.clear();
+  if (in.failed() || in.more())
+    return 0;
+  return area;
+}
+
+bool
+AreaSerializer::encodeArea(Output& out, const AreaRef& area) const
+{
+  if (!area)
+    {
+      out.putInt(T_NULL);
+      return true;
+    }
+
+  const EncodedMap::const_iterator p = encoded.find(area);
+  if (p != encoded.end())
+    {
+      out.putInt(T_REFERENCE);
+      out.putInt(p->second);
+      return true;
+    }
+
+  if (!encode(out, area))
+    return false;
+
+  // indices are given in post-order, as areas are decoded
+  const int index = encoded.size();
+  encoded[area] = index;
+  return true;
+}
+
+AreaRef
+AreaSerializer::decodeArea(Input& in) const
+{
+  const int tag = in.getInt();
+  if (in.failed()) return 0;
+
+  switch (tag)
+    {
+    case T_NULL:
+      return 0;
+    case T_REFERENCE:
+      {
+	const int index = in.getInt();
+	if (index >= 0 && index < static_cast<int>(decoded.size()))
+	  return decoded[index];
+	in.fail();
+	return 0;
+      }
+    default:
+      if (AreaRef area = decode(in, tag))
+	{
+	  decoded.push_back(area);
+	  return area;
+	}
+      in.fail();
+      return 0;
+    }
+}
+
+bool
+AreaSerializer::encodeChildren(Output& out, const AreaRef& area) const
+{
+  out.putInt(area->size());
+  for (AreaIndex i = 0; i < area->size(); i++)
+    if (!encodeArea(out, area->node(i)))
+      return false;
+  return true;
+}
+
+bool
+AreaSerializer::decodeChildren(Input& in, std::vector<AreaRef>& content) const
+{
+  const int n = in.getInt();
+  if (in.failed() || !in.fits(n)) return false;
+  content.reserve(n);
+  for (int i = 0; i < n; i++)
+    if (AreaRef area = decodeArea(in))
+      content.push_back(area);
+    else
+      return false;
+  return true;
+}
+
+bool
+AreaSerializer::encode(Output& out, const AreaRef& area) const
+{
+  if (SmartPtr<const HorizontalSpaceArea> space = smart_cast<const HorizontalSpaceArea>(area))
+    {
+      out.putInt(T_HORIZONTAL_SPACE);
+      out.putScaled(space->getWidth());
+      return true;
+    }
+  else if (SmartPtr<const VerticalSpaceArea> space = smart_cast<const VerticalSpaceArea>(area))
+    {
+      out.putInt(T_VERTICAL_SPACE);
+      out.putScaled(space->getHeight());
+      out.putScaled(space->getDepth());
+      return true;
+    }
+  else if (smart_cast<const HorizontalFillerArea>(area))
+    {
+      out.putInt(T_HORIZONTAL_FILLER);
+      return true;
+    }
+  else if (smart_cast<const VerticalFillerArea>(area))
+    {
+      out.putInt(T_VERTICAL_FILLER);
+      return true;
+    }
+  else if (SmartPtr<const GlyphStringArea> string = smart_cast<const GlyphStringArea>(area))
+    {
+      out.putInt(T_GLYPH_STRING);
+      out.putString(StringOfUCS4String(string->getSource()));
+      const std::vector<CharIndex>& counters = string->getCounters();
+      out.putInt(counters.size());
+      for (std::vector<CharIndex>::const_iterator p = counters.begin(); p != counters.end(); p++)
+	out.putInt(*p);
+      return encodeChildren(out, area);
+    }
+  else if (smart_cast<const HorizontalArrayArea>(area))
+    {
+      out.putInt(T_HORIZONTAL_ARRAY);
+      return encodeChildren(out, area);
+    }
+  else if (SmartPtr<const VerticalArrayArea> array = smart_cast<const VerticalArrayArea>(area))
+    {
+      out.putInt(T_VERTICAL_ARRAY);
+      out.putInt(array->getRefArea());
+      return encodeChildren(out, area);
+    }
+  else if (smart_cast<const OverlapArrayArea>(area))
+    {
+      out.putInt(T_OVERLAP_ARRAY);
+      return encodeChildren(out, area);
+    }
+  else if (smart_cast<const BoxedLayoutArea>(area))
+    {
+      out.putInt(T_BOXED_LAYOUT);
+      out.putBoundingBox(area->box());
+      out.putInt(area->size());
+      for (AreaIndex i = 0; i < area->size(); i++)
+	{
+	  Point p;
+	  area->origin(i, p);
+	  out.putScaled(p.x);
+	  out.putScaled(p.y);
+	  if (!encodeArea(out, area->node(i)))
+	    return false;
+	}
+      return true;
+    }
+  else if (SmartPtr<const CombinedGlyphArea> glyph = smart_cast<const CombinedGlyphArea>(area))
+    {
+      out.putInt(T_COMBINED_GLYPH);
+      out.putScaled(glyph->getDx());
+      out.putScaled(glyph->getDy());
+      out.putScaled(glyph->getDxUnder());
+      return encodeArea(out, glyph->getBase())
+	&& encodeArea(out, glyph->getAccent())
+	&& encodeArea(out, glyph->getUnder());
+    }
+  else if (SmartPtr<const BinContainerArea> bin = smart_cast<const BinContainerArea>(area))
+    {
+      // WrapperArea is a BoxArea, the element is not part of the cached data
+      if (smart_cast<const GlyphWrapperArea>(area))
+	{
+	  out.putInt(T_GLYPH_WRAPPER);
+	  out.putInt(area->length());
+	}
+      else if (smart_cast<const BoxArea>(area))
+	{
+	  out.putInt(T_BOX);
+	  out.putBoundingBox(area->box());
+	}
+      else if (SmartPtr<const ColorArea> color = smart_cast<const ColorArea>(area))
+	{
+	  out.putInt(T_COLOR);
+	  out.putRGBColor(color->getColor());
+	}
+      else if (smart_cast<const HideArea>(area))
+	out.putInt(T_HIDE);
+      else if (smart_cast<const IdArea>(area))
+	out.putInt(T_ID);
+      else if (smart_cast<const IgnoreArea>(area))
+	out.putInt(T_IGNORE);
+      else if (smart_cast<const InkArea>(area))
+	out.putInt(T_INK);
+      else if (SmartPtr<const ShiftArea> shift = smart_cast<const ShiftArea>(area))
+	{
+	  out.putInt(T_SHIFT);
+	  out.putScaled(shift->getShift());
+	}
+      else if (smart_cast<const StepArea>(area))
+	{
+	  out.putInt(T_STEP);
+	  out.putScaled(area->getStep() - bin->getChild()->getStep());
+	}
+      else
+	return false;
+      return encodeArea(out, bin->getChild());
+    }
+  else
+    // glyph areas depend on the backend
+    return false;
+}
+
+AreaRef
+AreaSerializer::decode(Input& in, int tag) const
+{
+  switch (tag)
+    {
+    case T_HORIZONTAL_SPACE:
+      {
+	const scaled width = in.getScaled();
+	return factory->horizontalSpace(width);
+      }
+    case T_VERTICAL_SPACE:
+      {
+	const scaled height = in.getScaled();
+	const scaled depth = in.getScaled();
+	return factory->verticalSpace(height, depth);
+      }
+    case T_HORIZONTAL_FILLER:
+      return factory->horizontalFiller();
+    case T_VERTICAL_FILLER:
+      return factory->verticalFiller();
+    case T_GLYPH_STRING:
+      {
+	const UCS4String source = UCS4StringOfString(in.getString());
+	const int n = in.getInt();
+	if (in.failed() || !in.fits(n)) return 0;
+	std::vector<CharIndex> counters;
+	counters.reserve(n);
+	for (int i = 0; i < n; i++)
+	  counters.push_back(in.getInt());
+	std::vector<AreaRef> content;
+	if (decodeChildren(in, content) && content.size() == counters.size())
+	  return factory->glyphString(content, counters, source);
+	return 0;
+      }
+    case T_HORIZONTAL_ARRAY:
+      {
+	std::vector<AreaRef> content;
+	if (decodeChildren(in, content))
+	  return factory->horizontalArray(content);
+	return 0;
+      }
+    case T_VERTICAL_ARRAY:
+      {
+	const AreaIndex ref = in.getInt();
+	std::vector<AreaRef> content;
+	if (decodeChildren(in, content) && ref >= 0 && ref < static_cast<AreaIndex>(content.size()))
+	  return factory->verticalArray(content, ref);
+	return 0;
+      }
+    case T_OVERLAP_ARRAY:
+      {
+	std::vector<AreaRef> content;
+	if (decodeChildren(in, content))
+	  return factory->overlapArray(content);
+	return 0;
+      }
+    case T_BOXED_LAYOUT:
+      {
+	const BoundingBox box = in.getBoundingBox();
+	const int n = in.getInt();
+	if (in.failed() || !in.fits(n)) return 0;
+	std::vector<BoxedLayoutArea::XYArea> content;
+	content.reserve(n);
+	for (int i = 0; i < n; i++)
+	  {
+	    const scaled dx = in.getScaled();
+	    const scaled dy = in.getScaled();
+	    if (AreaRef area = decodeArea(in))
+	      content.push_back(BoxedLayoutArea::XYArea(dx, dy, area));
+	    else
+	      return 0;
+	  }
+	return factory->boxedLayout(box, content);
+      }
+    case T_COMBINED_GLYPH:
+      {
+	const scaled dx = in.getScaled();
+	const scaled dy = in.getScaled();
+	const scaled dxUnder = in.getScaled();
+	const AreaRef base = decodeArea(in);
+	const AreaRef accent = decodeArea(in);
+	const AreaRef under = decodeArea(in);
+	if (base && !in.failed())
+	  return factory->combinedGlyph(base, accent, under, dx, dy, dxUnder);
+	return 0;
+      }
+    case T_GLYPH_WRAPPER:
+      {
+	const CharIndex length = in.getInt();
+	if (AreaRef area = decodeArea(in))
+	  return factory->glyphWrapper(area, length);
+	return 0;
+      }
+    case T_BOX:
+      {
+	const BoundingBox box = in.getBoundingBox();
+	if (AreaRef area = decodeArea(in))
+	  return factory->box(area, box);
+	return 0;
+      }
+    case T_COLOR:
+      {
+	const RGBColor color = in.getRGBColor();
+	if (AreaRef area = decodeArea(in))
+	  return factory->color(area, color);
+	return 0;
+      }
+    case T_HIDE:
+      if (AreaRef area = decodeArea(in))
+	return factory->hide(area);
+      return 0;
+    case T_ID:
+      if (AreaRef area = decodeArea(in))
+	return factory->id(area);
+      return 0;
+    case T_IGNORE:
+      if (AreaRef area = decodeArea(in))
+	return factory->ignore(area);
+      return 0;
+    case T_INK:
+      if (AreaRef area = decodeArea(in))
+	return factory->ink(area);
+      return 0;
+    case T_SHIFT:
+      {
+	const scaled shift = in.getScaled();
+	if (AreaRef area = decodeArea(in))
+	  return factory->shift(area, shift);
+	return 0;
+      }
+    case T_STEP:
+      {
+	const scaled step = in.getScaled();
+	if (AreaRef area = decodeArea(in))
+	  return factory->step(area, step);
+	return 0;
+      }
+    default:
+      return 0;
+    }
+}
@@ -0,0 +1,149 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __AreaSerializer_hh__
+#define __AreaSerializer_hh__
+
+#include <string>
+#include <vector>
+
+#include "Area.hh"
+#include "RGBColor.hh"
+#include "String.hh"
+#include "HashMap.hh"
+
+// AreaSerializer turns a formatted area tree into a flat byte string
+// and back.  Areas shared within the tree are written once and
+// referenced afterwards, so that leaf glyphs are rebuilt once per
+// tree.  Areas are rebuilt through the AreaFactory, hence the result
+// is made of the backend-specific classes.  Backends with their own
+// leaf areas redefine encode/decode to handle them.
+class GMV_MathView_EXPORT AreaSerializer : public Object
+{
+protected:
+  AreaSerializer(const SmartPtr<class AreaFactory>&);
+  virtual ~AreaSerializer();
+
+public:
+  static SmartPtr<AreaSerializer> create(const SmartPtr<class AreaFactory>&);
+
+  // return false if the tree contains areas that cannot be serialized
+  bool serialize(const AreaRef&, std::string&) const;
+  // return a null pointer if the data is malformed
+  AreaRef deserialize(const std::string&) const;
+
+  SmartPtr<class AreaFactory> getFactory(void) const;
+
+protected:
+  enum Tag
+    {
+      T_NULL,
+      T_REFERENCE,
+      T_HORIZONTAL_SPACE,
+      T_VERTICAL_SPACE,
+      T_HORIZONTAL_FILLER,
+      T_VERTICAL_FILLER,
+      T_GLYPH_STRING,
+      T_HORIZONTAL_ARRAY,
+      T_VERTICAL_ARRAY,
+      T_OVERLAP_ARRAY,
+      T_BOXED_LAYOUT,
+      T_COMBINED_GLYPH,
+      T_GLYPH_WRAPPER,
+      T_BOX,
+      T_COLOR,
+      T_HIDE,
+      T_ID,
+      T_IGNORE,
+      T_INK,
+      T_SHIFT,
+      T_STEP,
+
+      T_BACKEND = 64 // first tag available to subclasses
+    };
+
+  class Output
+  {
+  public:
+    Output(std::string& d) : data(d) { }
+
+    void putInt(int);
+    void putScaled(const scaled& s) { putInt(s.getValue()); }
+    void putBoundingBox(const BoundingBox&);
+    void putRGBColor(const RGBColor&);
+    void putString(const String&);
+
+  private:
+    std::string& data;
+  };
+
+  class Input
+  {
+  public:
+    Input(const std::string& d) : data(d), offset(0), error(false) { }
+
+    int getInt(void);
+    scaled getScaled(void) { return scaled(getInt(), true); }
+    BoundingBox getBoundingBox(void);
+    RGBColor getRGBColor(void);
+    String getString(void);
+
+    bool more(void) const { return !error && offset < data.size(); }
+    // every item takes at least one byte, a count larger than this
+    // comes from a corrupted entry
+    bool fits(int n) const
+    { return n >= 0 && static_cast<std::string::size_type>(n) <= data.size() - offset; }
+    bool failed(void) const { return error; }
+    void fail(void) { error = true; }
+
+  private:
+    const std::string& data;
+    std::string::size_type offset;
+    bool error;
+  };
+
+  bool encodeArea(Output&, const AreaRef&) const;
+  AreaRef decodeArea(Input&) const;
+
+  // encode must write the tag first and return false for unknown areas,
+  // decode receives the tag already read
+  virtual bool encode(Output&, const AreaRef&) const;
+  virtual AreaRef decode(Input&, int) const;
+
+private:
+  bool encodeChildren(Output&, const AreaRef&) const;
+  bool decodeChildren(Input&, std::vector<AreaRef>&) const;
+
+  struct AreaPtrHash
+  {
+    size_t operator()(const Area* area) const
+    { return reinterpret_cast<size_t>(area); }
+  };
+
+  typedef HASH_MAP_NS::hash_map<const Area*, int, AreaPtrHash> EncodedMap;
+  mutable EncodedMap encoded;
+  mutable std::vector<AreaRef> decoded;
+
+  SmartPtr<class AreaFactory> factory;
+};
+
+#endif // __AreaSerializer_hh__
@@ -25,6 +25,7 @@
 #include "AbstractLogger.hh"
 #include "Backend.hh"
 #include "ShaperManager.hh"
+#include "AreaSerializer.hh"
 #include "MathGraphicDevice.hh"
 #if GMV_ENABLE_BOXML
 #include "BoxGraphicDevice.hh"
@@ -44,6 +45,14 @@ SmartPtr<ShaperManager>
 Backend::getShaperManager() const
 { return shaperManager; }
 
+void
+Backend::setAreaSerializer(const SmartPtr<AreaSerializer>& serializer)
+{ areaSerializer = serializer; }
+
+SmartPtr<AreaSerializer>
+Backend::getAreaSerializer() const
+{ return areaSerializer; }
+
 void
 Backend::setMathGraphicDevice(const SmartPtr<MathGraphicDevice>& mgd)
 {
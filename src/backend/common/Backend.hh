@@ -35,6 +35,9 @@ protected:
 
 public:
   SmartPtr<class ShaperManager> getShaperManager(void) const;
+  void setAreaSerializer(const SmartPtr<class AreaSerializer>&);
+  // null if areas produced by this backend cannot be serialized
+  SmartPtr<class AreaSerializer> getAreaSerializer(void) const;
   void setMathGraphicDevice(const SmartPtr<class MathGraphicDevice>&);
   virtual SmartPtr<class MathGraphicDevice> getMathGraphicDevice(void) const;
 #if GMV_ENABLE_BOXML
@@ -44,6 +47,7 @@ public:
 
 private:
   SmartPtr<class ShaperManager> shaperManager;
+  SmartPtr<class AreaSerializer> areaSerializer;
   SmartPtr<class MathGraphicDevice> mathGraphicDevice;
 #if GMV_ENABLE_BOXML
   SmartPtr<class BoxGraphicDevice> boxGraphicDevice;
@@ -22,12 +22,14 @@
 
 #include <config.h>
 
+#include <algorithm>
 #include <cassert>
 
 #include "AreaFactory.hh"
 #include "BoxGraphicDevice.hh"
 #include "BoxMLElement.hh"
 #include "FormattingContext.hh"
+#include "LineBreaker.hh"
 #include "ShaperManager.hh"
 
 BoxGraphicDevice::BoxGraphicDevice(const SmartPtr<AbstractLogger>& logger)
@@ -66,3 +68,50 @@ BoxGraphicDevice::string(const FormattingContext& context, const String& str, co
 						source);
   return res;
 }
+
+void
+BoxGraphicDevice::paragraph(const FormattingContext&, const std::vector<AreaRef>& content,
+			    const scaled& spacing, const scaled& firstWidth, const scaled& restWidth,
+			    std::vector<AreaRef>& lines) const
+{
+  // lines are not justified, the stretchability of the spaces is
+  // only a measure of how ragged the right margin is allowed to be
+  const scaled stretch = std::max(restWidth, scaled::zero()) / 3;
+
+  LineBreaker breaker;
+  std::vector<AreaRef> c;
+  c.reserve(content.size());
+  for (std::vector<AreaRef>::const_iterator p = content.begin(); p != content.end(); p++)
+    if (*p)
+      {
+	if (!c.empty()) breaker.appendGlue(spacing, stretch);
+	breaker.appendBox((*p)->box().width);
+	c.push_back(*p);
+      }
+
+  std::vector<unsigned> breaks;
+  breaker.breakLines(firstWidth, restWidth, breaks);
+
+  const AreaRef spacingArea = getFactory()->horizontalSpace(spacing);
+
+  // boxes and glues alternate, the i-th area being the 2i-th item
+  unsigned first = 0;
+  for (std::vector<unsigned>::const_iterator b = breaks.begin(); b != breaks.end(); b++)
+    {
+      const unsigned last = (*b + 1) / 2;
+      if (last - first == 1)
+	lines.push_back(c[first]);
+      else if (last > first)
+	{
+	  std::vector<AreaRef> line;
+	  line.reserve(2 * (last - first) - 1);
+	  for (unsigned i = first; i < last; i++)
+	    {
+	      if (i > first && spacing != scaled::zero()) line.push_back(spacingArea);
+	      line.push_back(c[i]);
+	    }
+	  lines.push_back(getFactory()->horizontalArray(line));
+	}
+      first = last;
+    }
+}
@@ -23,6 +23,8 @@
 #ifndef __BoxGraphicDevice_hh__
 #define __BoxGraphicDevice_hh__
 
+#include <vector>
+
 #include "Area.hh"
 #include "String.hh"
 #include "GraphicDevice.hh"
@@ -38,6 +40,12 @@ public:
   virtual AreaRef string(const class FormattingContext&, const String&, const scaled&) const;
   virtual AreaRef dummy(const class FormattingContext&) const;
   virtual AreaRef wrapper(const class FormattingContext&, const AreaRef&) const;
+  // breaks the areas into lines with the total-fit algorithm, the
+  // first line being firstWidth wide and the others restWidth wide.
+  // The areas are only measured, not formatted again
+  virtual void paragraph(const class FormattingContext&, const std::vector<AreaRef>&,
+			 const scaled&, const scaled&, const scaled&,
+			 std::vector<AreaRef>&) const;
 };
 
 #endif // __BoxGraphicDevice_hh__
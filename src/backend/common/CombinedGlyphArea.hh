@@ -64,6 +64,13 @@ public:
   virtual SmartPtr<const class GlyphArea> getGlyphArea(void) const;
   virtual SmartPtr<const class GlyphStringArea> getGlyphStringArea(void) const;  
 
+  AreaRef getBase(void) const { return base; }
+  AreaRef getAccent(void) const { return accent; }
+  AreaRef getUnder(void) const { return under; }
+  scaled getDx(void) const { return dx; }
+  scaled getDy(void) const { return dy; }
+  scaled getDxUnder(void) const { return dxUnder; }
+
 protected:
  BoundingBox bbox;
  AreaRef base;
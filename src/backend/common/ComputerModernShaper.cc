@@ -1725,34 +1725,137 @@ ComputerModernShaper::shapeChar(ShapingContext& context, ComputerModernFamily::F
   return true;
 }
 
+void
+ComputerModernShaper::clearStretchyCache() const
+{
+  stretchyCache.clear();
+  frozenStretchyCache.clear();
+  stretchyStats = StretchyCacheStats();
+}
+
+static void
+makeAreasImmortal(const std::vector<AreaRef>& v)
+{
+  for (std::vector<AreaRef>::const_iterator p = v.begin(); p != v.end(); p++)
+    if (*p) (*p)->makeImmortal();
+}
+
+void
+ComputerModernShaper::freezeCache() const
+{
+  for (StretchyCache::const_iterator p = stretchyCache.begin(); p != stretchyCache.end(); p++)
+    {
+      const StretchyParts& parts = p->second;
+      makeAreasImmortal(parts.normal);
+      makeAreasImmortal(parts.assembly);
+      if (parts.first) parts.first->makeImmortal();
+      if (parts.glue) parts.glue->makeImmortal();
+      if (parts.middle) parts.middle->makeImmortal();
+      if (parts.last) parts.last->makeImmortal();
+      frozenStretchyCache[p->first] = parts;
+    }
+  stretchyCache.clear();
+}
+
+ComputerModernShaper::StretchyParts&
+ComputerModernShaper::getStretchyPartsV(MathVariant variant, UChar8 index, const scaled& size) const
+{
+  const StretchyKey key(true, index, variant, size);
+  StretchyCache::iterator p = stretchyCache.find(key);
+  if (p != stretchyCache.end())
+    {
+      stretchyStats.partsHits++;
+      return p->second;
+    }
+  StretchyCache::const_iterator q = frozenStretchyCache.find(key);
+  if (q != frozenStretchyCache.end())
+    {
+      stretchyStats.partsHits++;
+      return (stretchyCache[key] = q->second);
+    }
+
+  stretchyStats.partsMisses++;
+  StretchyParts& parts = stretchyCache[key];
+  const VStretchyChar& charSpec = vMap[index];
+  for (unsigned i = 0; i < 5; i++)
+    if (AreaRef normal = getGlyphArea(variant, charSpec.normal[i], size))
+      parts.normal.push_back(normal);
+  parts.first = getGlyphArea(variant, charSpec.top, size);
+  parts.glue = getGlyphArea(variant, charSpec.glue, size);
+  parts.middle = getGlyphArea(variant, charSpec.middle, size);
+  parts.last = getGlyphArea(variant, charSpec.bottom, size);
+  return parts;
+}
+
+ComputerModernShaper::StretchyParts&
+ComputerModernShaper::getStretchyPartsH(MathVariant variant, UChar8 index, const scaled& size) const
+{
+  const StretchyKey key(false, index, variant, size);
+  StretchyCache::iterator p = stretchyCache.find(key);
+  if (p != stretchyCache.end())
+    {
+      stretchyStats.partsHits++;
+      return p->second;
+    }
+  StretchyCache::const_iterator q = frozenStretchyCache.find(key);
+  if (q != frozenStretchyCache.end())
+    {
+      stretchyStats.partsHits++;
+      return (stretchyCache[key] = q->second);
+    }
+
+  stretchyStats.partsMisses++;
+  StretchyParts& parts = stretchyCache[key];
+  const HStretchyChar& charSpec = hMap[index];
+  if (AreaRef normal = getGlyphArea(variant, charSpec.normal, size))
+    parts.normal.push_back(normal);
+  parts.first = getGlyphArea(variant, charSpec.left, size);
+  parts.glue = getGlyphArea(variant, charSpec.glue, size);
+  parts.last = getGlyphArea(variant, charSpec.right, size);
+  return parts;
+}
+
+AreaRef
+ComputerModernShaper::getStretchyAssembly(StretchyParts& parts, const SmartPtr<AreaFactory>& factory,
+					  bool vertical, int n) const
+{
+  const AreaRef normal = parts.normal.empty() ? AreaRef() : parts.normal.back();
+  if (n < 0) return normal;
+
+  if (unsigned(n) < parts.assembly.size() && parts.assembly[n])
+    {
+      stretchyStats.assemblyHits++;
+      return parts.assembly[n];
+    }
+
+  stretchyStats.assemblyMisses++;
+  const AreaRef res =
+    vertical
+    ? assembleStretchyCharV(factory, normal, parts.first, parts.glue, parts.middle, parts.last, n)
+    : assembleStretchyCharH(factory, normal, parts.first, parts.glue, parts.last, n);
+  if (unsigned(n) >= parts.assembly.size()) parts.assembly.resize(n + 1);
+  parts.assembly[n] = res;
+  return res;
+}
+
 bool
 ComputerModernShaper::shapeStretchyCharV(ShapingContext& context) const
 {
   const MathVariant variant = context.getMathVariant();
-  const SmartPtr<AreaFactory> factory = context.getFactory();
   const scaled size = context.getSize();
   const scaled span = context.getVSpan() - (1 * size) / 10; // use tex formula
-  const VStretchyChar& charSpec = vMap[context.getSpec().getGlyphId()];
+  StretchyParts& parts = getStretchyPartsV(variant, context.getSpec().getGlyphId(), size);
 
-  AreaRef normal = 0;
-  for (unsigned i = 0; i < 5; i++)
-    if (AreaRef tryNormal = getGlyphArea(variant, charSpec.normal[i], size))
+  for (std::vector<AreaRef>::const_iterator p = parts.normal.begin(); p != parts.normal.end(); p++)
+    if ((*p)->box().verticalExtent() >= span)
       {
-	if (tryNormal->box().verticalExtent() >= span)
-	  {
-	    context.pushArea(1, tryNormal);
-	    return true;
-	  }
-	else
-	  normal = tryNormal;
+	context.pushArea(1, *p);
+	return true;
       }
 
-  AreaRef top = getGlyphArea(variant, charSpec.top, size);
-  AreaRef glue = getGlyphArea(variant, charSpec.glue, size);
-  AreaRef middle = getGlyphArea(variant, charSpec.middle, size);
-  AreaRef bottom = getGlyphArea(variant, charSpec.bottom, size);
-
-  context.pushArea(1, composeStretchyCharV(factory, normal, top, glue, middle, bottom, span));
+  const AreaRef normal = parts.normal.empty() ? AreaRef() : parts.normal.back();
+  const int n = stretchyGlueCountV(normal, parts.first, parts.glue, parts.middle, parts.last, span);
+  context.pushArea(1, getStretchyAssembly(parts, context.getFactory(), true, n));
 
   return true;
 }
@@ -1761,17 +1864,13 @@ bool
 ComputerModernShaper::shapeStretchyCharH(ShapingContext& context) const
 {
   const MathVariant variant = context.getMathVariant();
-  const SmartPtr<AreaFactory> factory = context.getFactory();
   const scaled size = context.getSize();
   const scaled span = context.getHSpan() - (1 * size) / 10; // use tex formula also for H?
-  const HStretchyChar& charSpec = hMap[context.getSpec().getGlyphId()];
-
-  AreaRef normal = getGlyphArea(variant, charSpec.normal, size);
-  AreaRef left = getGlyphArea(variant, charSpec.left, size);
-  AreaRef glue = getGlyphArea(variant, charSpec.glue, size);
-  AreaRef right = getGlyphArea(variant, charSpec.right, size);
+  StretchyParts& parts = getStretchyPartsH(variant, context.getSpec().getGlyphId(), size);
 
-  context.pushArea(1, composeStretchyCharH(factory, normal, left, glue, right, span));
+  const AreaRef normal = parts.normal.empty() ? AreaRef() : parts.normal.back();
+  const int n = stretchyGlueCountH(normal, parts.first, parts.glue, parts.last, span);
+  context.pushArea(1, getStretchyAssembly(parts, context.getFactory(), false, n));
 
   return true;
 }
@@ -23,9 +23,12 @@
 #ifndef __ComputerModernShaper_hh__
 #define __ComputerModernShaper_hh__
 
+#include <vector>
+
 #include "Char.hh"
 #include "Shaper.hh"
 #include "ComputerModernFamily.hh"
+#include "HashMap.hh"
 
 class GMV_MathView_EXPORT ComputerModernShaper : public Shaper
 {
@@ -104,6 +107,20 @@ public:
 
   static UChar8 toTTFGlyphIndex(ComputerModernFamily::FontEncId, UChar8);
 
+  struct StretchyCacheStats
+  {
+    StretchyCacheStats(void) : partsHits(0), partsMisses(0), assemblyHits(0), assemblyMisses(0) { }
+
+    unsigned partsHits;
+    unsigned partsMisses;
+    unsigned assemblyHits;
+    unsigned assemblyMisses;
+  };
+
+  const StretchyCacheStats& getStretchyCacheStats(void) const { return stretchyStats; }
+  void clearStretchyCache(void) const;
+  virtual void freezeCache(void) const;
+
 protected:
   virtual void postShape(class ShapingContext&) const;
   virtual AreaRef getGlyphArea(ComputerModernFamily::FontNameId,
@@ -120,9 +137,54 @@ protected:
   bool shapeSpecialStretchyChar(class ShapingContext&) const;
   virtual bool shapeCombiningChar(class ShapingContext&) const;
 
+  // The parts of a stretchy character only depend on the character,
+  // the variant and the size, and its assembly on the number of glue
+  // pieces, so they are cached independently of the exact span
+  struct StretchyKey
+  {
+    StretchyKey(bool v, UChar8 i, MathVariant mv, const scaled& s)
+      : vertical(v), index(i), variant(mv), size(s) { }
+
+    bool operator==(const StretchyKey& key) const
+    { return vertical == key.vertical && index == key.index && variant == key.variant && size == key.size; }
+
+    bool vertical;
+    UChar8 index;
+    MathVariant variant;
+    scaled size;
+  };
+
+  struct StretchyKeyHash
+  {
+    size_t operator()(const StretchyKey& key) const
+    { return key.size.getValue() ^ (key.index << 16) ^ (key.variant << 24) ^ key.vertical; }
+  };
+
+  struct StretchyParts
+  {
+    std::vector<AreaRef> normal; // by increasing size
+    AreaRef first;               // top or left
+    AreaRef glue;
+    AreaRef middle;
+    AreaRef last;                // bottom or right
+    std::vector<AreaRef> assembly; // by number of glue pieces
+  };
+
+  StretchyParts& getStretchyPartsV(MathVariant, UChar8, const scaled&) const;
+  StretchyParts& getStretchyPartsH(MathVariant, UChar8, const scaled&) const;
+  AreaRef getStretchyAssembly(StretchyParts&, const SmartPtr<class AreaFactory>&, bool, int) const;
+
 protected:
   PostShapingMode postShapingMode;
   SmartPtr<ComputerModernFamily> family;
+
+private:
+  typedef HASH_MAP_NS::hash_map<StretchyKey, StretchyParts, StretchyKeyHash> StretchyCache;
+  mutable StretchyCache stretchyCache;
+  // only read, parts found here are copied into stretchyCache before
+  // their assemblies are extended
+  mutable StretchyCache frozenStretchyCache;
+  mutable StretchyCacheStats stretchyStats;
 };
 
 #endif // __ComputerModernShaper_hh__
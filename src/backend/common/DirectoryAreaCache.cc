@@ -0,0 +1,190 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "DirectoryAreaCache.hh"
+
+#define AREA_CACHE_SUFFIX ".area"
+
+DirectoryAreaCache::DirectoryAreaCache(const SmartPtr<AreaSerializer>& serializer,
+				       const String& backend, const String& configuration,
+				       const String& p, unsigned long max)
+  : AreaCache(serializer, backend, configuration), path(p), maxSize(max),
+    currentSize(0), currentSizeKnown(false)
+{ }
+
+DirectoryAreaCache::~DirectoryAreaCache()
+{ }
+
+SmartPtr<DirectoryAreaCache>
+DirectoryAreaCache::create(const SmartPtr<AreaSerializer>& serializer,
+			   const String& backend, const String& configuration,
+			   const String& path, unsigned long maxSize)
+{ return new DirectoryAreaCache(serializer, backend, configuration, path, maxSize); }
+
+String
+DirectoryAreaCache::getEntryPath(const String& digest) const
+{ return path + "/" + digest + AREA_CACHE_SUFFIX; }
+
+bool
+DirectoryAreaCache::load(const String& digest, std::string& data) const
+{
+  const String entryPath = getEntryPath(digest);
+  std::ifstream is(entryPath.c_str(), std::ios::in | std::ios::binary);
+  if (!is) return false;
+
+  std::ostringstream os;
+  os << is.rdbuf();
+  data = os.str();
+
+  // the modification time is used as last access time for eviction
+  utime(entryPath.c_str(), 0);
+  return true;
+}
+
+bool
+DirectoryAreaCache::save(const String& digest, const std::string& data)
+{
+  const String entryPath = getEntryPath(digest);
+  std::ostringstream tmpPath;
+  tmpPath << entryPath << "." << getpid();
+
+  {
+    std::ofstream os(tmpPath.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!os) return false;
+    os.write(data.data(), data.length());
+    if (!os)
+      {
+	os.close();
+	unlink(tmpPath.str().c_str());
+	return false;
+      }
+  }
+
+  // an existing entry for the same digest is replaced
+  unsigned long oldSize = 0;
+  struct stat st;
+  if (stat(entryPath.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+    oldSize = st.st_size;
+
+  // readers never see a partially written entry
+  if (rename(tmpPath.str().c_str(), entryPath.c_str()) != 0)
+    {
+      unlink(tmpPath.str().c_str());
+      return false;
+    }
+
+  if (!currentSizeKnown)
+    {
+      currentSize = computeSize();
+      currentSizeKnown = true;
+    }
+  else
+    currentSize = currentSize - std::min(currentSize, oldSize) + data.length();
+
+  if (currentSize > maxSize)
+    evict();
+
+  return true;
+}
+
+namespace {
+
+  struct Entry
+  {
+    Entry(const String& p, time_t t, unsigned long s) : path(p), time(t), size(s) { }
+
+    bool operator<(const Entry& e) const { return time < e.time; }
+
+    String path;
+    time_t time;
+    unsigned long size;
+  };
+
+  void
+  listEntries(const String& path, std::vector<Entry>& entries)
+  {
+    if (DIR* dir = opendir(path.c_str()))
+      {
+	const String suffix = AREA_CACHE_SUFFIX;
+	while (struct dirent* d = readdir(dir))
+	  {
+	    const String name = d->d_name;
+	    if (name.length() > suffix.length()
+		&& name.compare(name.length() - suffix.length(), suffix.length(), suffix) == 0)
+	      {
+		const String entryPath = path + "/" + name;
+		struct stat st;
+		if (stat(entryPath.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+		  entries.push_back(Entry(entryPath, st.st_mtime, st.st_size));
+	      }
+	  }
+	closedir(dir);
+      }
+  }
+
+}
+
+unsigned long
+DirectoryAreaCache::computeSize() const
+{
+  std::vector<Entry> entries;
+  listEntries(path, entries);
+  unsigned long size = 0;
+  for (std::vector<Entry>::const_iterator p = entries.begin(); p != entries.end(); p++)
+    size += p->size;
+  return size;
+}
+
+void
+DirectoryAreaCache::evict()
+{
+  std::vector<Entry> entries;
+  listEntries(path, entries);
+  std::sort(entries.begin(), entries.end());
+
+  currentSize = 0;
+  for (std::vector<Entry>::const_iterator p = entries.begin(); p != entries.end(); p++)
+    currentSize += p->size;
+
+  // remove down to three quarters of the limit so that eviction
+  // does not happen at every store
+  const unsigned long target = maxSize - maxSize / 4;
+  for (std::vector<Entry>::const_iterator p = entries.begin();
+       p != entries.end() && currentSize > target;
+       p++)
+    if (unlink(p->path.c_str()) == 0)
+      currentSize -= p->size;
+}
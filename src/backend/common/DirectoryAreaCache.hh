@@ -0,0 +1,63 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __DirectoryAreaCache_hh__
+#define __DirectoryAreaCache_hh__
+
+#include "AreaCache.hh"
+
+// DirectoryAreaCache stores one file per entry in a local directory.
+// When the total size of the entries exceeds the given limit the
+// least recently used entries are removed.  The directory may be
+// shared by several processes.
+class GMV_MathView_EXPORT DirectoryAreaCache : public AreaCache
+{
+protected:
+  DirectoryAreaCache(const SmartPtr<class AreaSerializer>&, const String&, const String&,
+		     const String&, unsigned long);
+  virtual ~DirectoryAreaCache();
+
+public:
+  static SmartPtr<DirectoryAreaCache> create(const SmartPtr<class AreaSerializer>&,
+					     const String&, const String&,
+					     const String&, unsigned long);
+
+  String getPath(void) const { return path; }
+  unsigned long getMaxSize(void) const { return maxSize; }
+
+protected:
+  virtual bool load(const String&, std::string&) const;
+  virtual bool save(const String&, const std::string&);
+
+  String getEntryPath(const String&) const;
+  unsigned long computeSize(void) const;
+  void evict(void);
+
+private:
+  String path;
+  unsigned long maxSize;
+  // approximate, other processes may be using the same directory
+  unsigned long currentSize;
+  bool currentSizeKnown;
+};
+
+#endif // __DirectoryAreaCache_hh__
@@ -99,6 +99,10 @@ SmartPtr<MathGraphicDevice>
 FormattingContext::MGD() const
 { return mathGraphicDevice; }
 
+const GraphicMetrics&
+FormattingContext::getMetrics() const
+{ return mathGraphicDevice->metrics(*this); }
+
 #if GMV_ENABLE_BOXML
 void
 FormattingContext::push(const SmartPtr<BoxMLElement>& el)
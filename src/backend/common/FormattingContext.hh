@@ -30,6 +30,7 @@
 // full path needed for Win32
 #include "../../common/mathvariants/MathVariant.hh"
 #include "FastScopedHashMap.hh"
+#include "GraphicMetrics.hh"
 
 class GMV_MathView_EXPORT FormattingContext
 {
@@ -124,6 +125,8 @@ public:
   void push(const SmartPtr<class MathMLElement>&);
   SmartPtr<class MathMLElement> getMathMLElement(void) const;
   SmartPtr<class MathGraphicDevice> MGD(void) const;
+  // metrics of the current size and variant, as computed by the MGD
+  const GraphicMetrics& getMetrics(void) const;
 
 #if GMV_ENABLE_BOXML  
   void push(const SmartPtr<class BoxMLElement>&);
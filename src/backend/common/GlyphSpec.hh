@@ -25,20 +25,38 @@
 
 #include "gmv_defines.h"
 
+// GlyphSpec packs the shaper, the font and the glyph of a character
+// in a single 32-bit word, so that the glyph map of ShaperManager
+// stores one word per character and specs compare as integers
 class GMV_MathView_EXPORT GlyphSpec
 {
 public:
-  GlyphSpec(void) : shaperId(0), fontId(0), glyphId(0) { }
-  GlyphSpec(unsigned si, unsigned fi, unsigned gi) : shaperId(si), fontId(fi), glyphId(gi) { }
+  GlyphSpec(void) : spec(0) { }
+  GlyphSpec(unsigned si, unsigned fi, unsigned gi)
+    : spec(((si & SHAPER_MASK) << SHAPER_SHIFT) | ((fi & FONT_MASK) << FONT_SHIFT) | (gi & GLYPH_MASK))
+  { }
 
-  unsigned getGlyphId(void) const { return glyphId; }
-  unsigned getShaperId(void) const { return shaperId; }
-  unsigned getFontId(void) const { return fontId; }
+  unsigned getGlyphId(void) const { return spec & GLYPH_MASK; }
+  unsigned getShaperId(void) const { return (spec >> SHAPER_SHIFT) & SHAPER_MASK; }
+  unsigned getFontId(void) const { return (spec >> FONT_SHIFT) & FONT_MASK; }
+
+  // true if the two specs refer to the same font of the same shaper
+  bool sameFont(const GlyphSpec& s) const { return (spec >> FONT_SHIFT) == (s.spec >> FONT_SHIFT); }
+
+  bool operator==(const GlyphSpec& s) const { return spec == s.spec; }
+  bool operator!=(const GlyphSpec& s) const { return spec != s.spec; }
 
 private:
-  unsigned shaperId : 8; // this can be lowered to match ShaperManager::MAX_SHAPERS
-  unsigned fontId : 8;
-  unsigned glyphId : 16;
+  // the shaper id can be lowered to match ShaperManager::MAX_SHAPERS
+  enum {
+    GLYPH_MASK = 0xffff,
+    FONT_SHIFT = 16,
+    FONT_MASK = 0xff,
+    SHAPER_SHIFT = 24,
+    SHAPER_MASK = 0xff
+  };
+
+  unsigned spec;
 };
 
 #endif // __GlyphSpec_hh__
@@ -54,7 +54,7 @@ GlyphStringArea::indexOfPosition(const scaled& x0, const scaled& y, CharIndex& i
   scaled x = x0;
   for (std::vector<AreaRef>::const_iterator p = content.begin(); p != content.end(); p++)
     {
-      const BoundingBox pbox((*p)->box().width, bbox.height, bbox.depth);
+      const BoundingBox pbox(childWidth[p - content.begin()], bbox.height, bbox.depth);
       if (Rectangle(scaled::zero(), scaled::zero(), pbox).isInside(x, y))
 	{
 	  CharIndex i;
@@ -72,7 +72,7 @@ GlyphStringArea::indexOfPosition(const scaled& x0, const scaled& y, CharIndex& i
       else
 	{
 	  index += counters[p - content.begin()];
-	  x -= (*p)->box().width;
+	  x -= pbox.width;
 	}
     }      
 
@@ -91,8 +91,8 @@ GlyphStringArea::positionOfIndex(CharIndex index, Point* point, BoundingBox* b)
 	  return true;
 	else if (index == *p)
 	  {
-	    point->x += content[p - counters.begin()]->box().width;
-	    if (b) *b = content[p - counters.begin()]->box();
+	    point->x += childWidth[p - counters.begin()];
+	    if (b) *b = childBox(p - counters.begin());
 	    return true;
 	  }
 	else
@@ -102,7 +102,7 @@ GlyphStringArea::positionOfIndex(CharIndex index, Point* point, BoundingBox* b)
       {
 // 	std::cerr << "GlyphStringArea::positionOfIndex iterating index = " << index << std::endl;
 	index -= *p;
-	point->x += content[p - counters.begin()]->box().width;
+	point->x += childWidth[p - counters.begin()];
       }
 
   return false;
@@ -44,6 +44,7 @@ public:
   virtual bool indexOfPosition(const scaled&, const scaled&, CharIndex&) const;
   virtual bool positionOfIndex(CharIndex, class Point*, BoundingBox*) const;
   const UCS4String& getSource() const { return source; }
+  const std::vector<CharIndex>& getCounters(void) const { return counters; }
   
   virtual SmartPtr<const class GlyphStringArea> getGlyphStringArea(void) const;  
   
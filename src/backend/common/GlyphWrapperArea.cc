@@ -22,23 +22,9 @@
 
 #include <config.h>
 
-#include <cassert>
-
 #include "GlyphWrapperArea.hh"
 #include "Rectangle.hh"
 
-AreaRef
-GlyphWrapperArea::node(AreaIndex) const
-{ assert(false); }
-
-CharIndex
-GlyphWrapperArea::lengthTo(AreaIndex) const
-{ assert(false); }
-
-void
-GlyphWrapperArea::origin(AreaIndex, Point&) const
-{ assert(false); }
-
 bool
 GlyphWrapperArea::indexOfPosition(const scaled& x, const scaled& y, CharIndex& index) const
 {
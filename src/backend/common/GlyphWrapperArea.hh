@@ -39,9 +39,6 @@ public:
   { return create(area, length()); }
 
   virtual CharIndex length(void) const { return contentLength; }
-  virtual CharIndex lengthTo(AreaIndex) const;
-  virtual AreaRef node(AreaIndex) const;
-  virtual void origin(AreaIndex, class Point&) const;
   virtual bool indexOfPosition(const scaled&, const scaled&, CharIndex&) const;
   virtual bool positionOfIndex(CharIndex, class Point*, BoundingBox*) const;
   virtual bool searchByArea(class AreaId&, const AreaRef&) const;
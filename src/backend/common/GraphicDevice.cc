@@ -28,7 +28,7 @@
 #include "ShaperManager.hh"
 
 GraphicDevice::GraphicDevice(const SmartPtr<AbstractLogger>& l)
-  : logger(l)
+  : logger(l), lastMetrics(0)
 { }
 
 GraphicDevice::~GraphicDevice()
@@ -44,7 +44,10 @@ GraphicDevice::setFactory(const SmartPtr<AreaFactory>& f)
 
 void
 GraphicDevice::setShaperManager(const SmartPtr<ShaperManager>& sm)
-{ shaperManager = sm; }
+{
+  shaperManager = sm;
+  clearMetrics();
+}
 
 SmartPtr<ShaperManager>
 GraphicDevice::getShaperManager() const
@@ -64,11 +67,11 @@ GraphicDevice::evaluate(const FormattingContext& context,
     case Length::INFINITY_UNIT:
       return scaled::max();
     case Length::LT_UNIT:
-      return defaultLineThickness(context) * length.value;
+      return metrics(context).lineThickness * length.value;
     case Length::EM_UNIT:
-      return em(context) * length.value;
+      return metrics(context).em * length.value;
     case Length::EX_UNIT:
-      return ex(context) * length.value;
+      return metrics(context).ex * length.value;
     case Length::PX_UNIT:
       return scaled((72.27 * length.value) / dpi(context));
     case Length::IN_UNIT:
@@ -120,3 +123,38 @@ GraphicDevice::defaultLineThickness(const FormattingContext& context) const
   // at least 1px thick
   return std::max(context.getSize() / 10, scaled(72.27f / dpi(context)));
 }
+
+const GraphicMetrics&
+GraphicDevice::metrics(const FormattingContext& context) const
+{
+  const MetricsKey key(context.getSize(), context.getVariant());
+  if (lastMetrics && key == lastKey) return *lastMetrics;
+
+  MetricsCache::iterator p = metricsCache.find(key);
+  if (p == metricsCache.end())
+    {
+      GraphicMetrics m;
+      computeMetrics(context, m);
+      p = metricsCache.insert(std::make_pair(key, m)).first;
+    }
+
+  lastKey = key;
+  lastMetrics = &p->second;
+  return *lastMetrics;
+}
+
+void
+GraphicDevice::clearMetrics() const
+{
+  lastMetrics = 0;
+  metricsCache.clear();
+}
+
+void
+GraphicDevice::computeMetrics(const FormattingContext& context, GraphicMetrics& m) const
+{
+  m.em = em(context);
+  m.ex = ex(context);
+  m.axis = m.ex / 2;
+  m.lineThickness = defaultLineThickness(context);
+}
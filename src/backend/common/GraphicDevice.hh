@@ -26,7 +26,11 @@
 #include "Object.hh"
 #include "Length.hh"
 #include "scaled.hh"
+#include "HashMap.hh"
 #include "AreaFactory.hh"
+#include "GraphicMetrics.hh"
+// full path needed for Win32
+#include "../../common/mathvariants/MathVariant.hh"
 
 class GMV_MathView_EXPORT GraphicDevice : public Object
 {
@@ -49,12 +53,42 @@ public:
   virtual scaled ex(const class FormattingContext&) const = 0;
   virtual scaled defaultLineThickness(const class FormattingContext&) const;
 
+  // the metrics depend only on the size and the variant of the
+  // context, they are computed once and then looked up
+  const GraphicMetrics& metrics(const class FormattingContext&) const;
+  void clearMetrics(void) const;
+
 protected:
+  virtual void computeMetrics(const class FormattingContext&, GraphicMetrics&) const;
+
  SmartPtr<class ShaperManager> shaperManager;
 
 private:
   SmartPtr<class AbstractLogger> logger;
   SmartPtr<AreaFactory> factory;
+
+  struct MetricsKey
+  {
+    MetricsKey(const scaled& s = scaled::zero(), MathVariant v = NORMAL_VARIANT) : size(s), variant(v) { }
+
+    bool operator==(const MetricsKey& key) const
+    { return size == key.size && variant == key.variant; }
+
+    scaled size;
+    MathVariant variant;
+  };
+
+  struct MetricsKeyHash
+  {
+    size_t operator()(const MetricsKey& key) const
+    { return key.size.getValue() ^ (key.variant << 24); }
+  };
+
+  typedef HASH_MAP_NS::hash_map<MetricsKey,GraphicMetrics,MetricsKeyHash> MetricsCache;
+  mutable MetricsCache metricsCache;
+  // consecutive lookups are mostly for the same size and variant
+  mutable MetricsKey lastKey;
+  mutable const GraphicMetrics* lastMetrics;
 };
 
 #endif // __GraphicDevice_hh__
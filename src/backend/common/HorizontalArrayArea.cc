@@ -25,6 +25,26 @@
 #include "AreaId.hh"
 #include "Point.hh"
 #include "HorizontalArrayArea.hh"
+#include "RenderingContext.hh"
+
+HorizontalArrayArea::HorizontalArrayArea(const std::vector<AreaRef>& children)
+  : LinearContainerArea(children), childStep(children.size())
+{
+  for (std::vector<AreaRef>::size_type i = 0; i < content.size(); i++)
+    childStep[i] = content[i]->getStep();
+
+  // each child is shifted vertically by the steps of the children
+  // preceding it, the resulting box is relative to the baseline
+  scaled s = 0;
+  for (std::vector<AreaRef>::size_type i = 0; i < content.size(); i++)
+    {
+      bbox.width += childWidth[i];
+      if (childHeight[i] != scaled::min()) bbox.height = std::max(bbox.height, childHeight[i] + s);
+      if (childDepth[i] != scaled::min()) bbox.depth = std::max(bbox.depth, childDepth[i] - s);
+      s += childStep[i];
+    }
+  step = s;
+}
 
 SmartPtr<HorizontalArrayArea>
 HorizontalArrayArea::create(const std::vector<AreaRef>& children)
@@ -50,7 +70,8 @@ HorizontalArrayArea::flattenAux(std::vector<AreaRef>& dest, const std::vector<Ar
 AreaRef
 HorizontalArrayArea::flatten(void) const
 {
-  std::vector<AreaRef> newContent(content.size());
+  std::vector<AreaRef> newContent;
+  newContent.reserve(content.size());
   flattenAux(newContent, content);
   if (newContent != content)
     return clone(newContent);
@@ -60,38 +81,19 @@ HorizontalArrayArea::flatten(void) const
 
 BoundingBox
 HorizontalArrayArea::box() const
-{
-  BoundingBox bbox;
-  scaled step = 0;
-  for (std::vector<AreaRef>::const_iterator p = content.begin();
-       p != content.end();
-       p++)
-    {
-      bbox.append((*p)->box());
-      const scaled childStep = (*p)->getStep();
-      bbox.height -= childStep;
-      bbox.depth += childStep;
-      step += childStep;
-    }
-  // must restore the baseline
-  bbox.height += step;
-  bbox.depth -= step;
-
-  return bbox;
-}
+{ return bbox; }
 
 void
 HorizontalArrayArea::render(class RenderingContext& context, const scaled& x0, const scaled& y0) const
 {
   scaled x = x0;
   scaled y = y0;
-  for (std::vector<AreaRef>::const_iterator p = content.begin();
-       p != content.end();
-       p++)
+  for (std::vector<AreaRef>::size_type i = 0; i < content.size(); i++)
     {
-      (*p)->render(context, x, y);
-      x += (*p)->box().horizontalExtent();
-      y += (*p)->getStep();
+      if (context.isVisible(x, y, childBox(i)))
+	content[i]->render(context, x, y);
+      x += childWidth[i];
+      y += childStep[i];
     }
 }
 
@@ -105,8 +107,8 @@ HorizontalArrayArea::searchByCoords(AreaId& id, const scaled& x, const scaled& y
       id.append(p - content.begin(), *p, offset, scaled::zero());
       if ((*p)->searchByCoords(id, x - offset, y)) return true;
       id.pop_back();
-      offset += (*p)->box().horizontalExtent();
-      y += (*p)->getStep();
+      offset += childWidth[p - content.begin()];
+      y += childStep[p - content.begin()];
     }
 
   return false;
@@ -123,7 +125,7 @@ HorizontalArrayArea::leftEdge() const
     {
       scaled pedge = (*p)->leftEdge();
       if (pedge < scaled::max()) edge = std::min(edge, d + pedge);
-      d += (*p)->box().horizontalExtent();
+      d += childWidth[p - content.begin()];
     }
   return edge;
 }
@@ -139,7 +141,7 @@ HorizontalArrayArea::rightEdge() const
     {
       scaled pedge = (*p)->rightEdge();
       if (pedge > scaled::min()) edge = std::max(edge, d + pedge);
-      d += (*p)->box().horizontalExtent();
+      d += childWidth[p - content.begin()];
     }
   return edge;
 }
@@ -167,7 +169,7 @@ HorizontalArrayArea::rightSide(AreaIndex i) const
   while (ledge == scaled::max() && r + 1 < content.size())
     ledge = content[r++]->leftEdge();
 
-  return (ledge != scaled::max()) ? originX(i) + ledge : box().width;
+  return (ledge != scaled::max()) ? originX(i) + ledge : bbox.width;
 }
 
 void
@@ -193,7 +195,6 @@ HorizontalArrayArea::fit(const scaled& width, const scaled& height, const scaled
 {
   int sw, sh, sd;
   strength(sw, sh, sd);
-  BoundingBox box0 = box();
 
   std::vector<AreaRef> newContent;
   newContent.reserve(content.size());
@@ -203,13 +204,13 @@ HorizontalArrayArea::fit(const scaled& width, const scaled& height, const scaled
     {
       int pw, ph, pd;
       (*p)->strength(pw, ph, pd);
-      BoundingBox pbox = (*p)->box();
+      const scaled cwidth = childWidth[p - content.begin()];
 
       if (sw == 0 || pw == 0)
-	newContent.push_back((*p)->fit(pbox.width, height, depth));
+	newContent.push_back((*p)->fit(cwidth, height, depth));
       else
 	{
-	  scaled pwidth = (std::max(pbox.width, width - box0.width) * pw) / sw;
+	  scaled pwidth = (std::max(cwidth, width - bbox.width) * pw) / sw;
 	  newContent.push_back((*p)->fit(pwidth, height, depth));
 	}
     }
@@ -224,18 +225,13 @@ void
 HorizontalArrayArea::origin(AreaIndex i, Point& point) const
 {
   assert(i >= 0 && i < content.size());
-  for (std::vector<AreaRef>::const_iterator p = content.begin(); p != content.begin() + i; p++)
+  scaled x = 0;
+  scaled y = 0;
+  for (AreaIndex j = 0; j < i; j++)
     {
-      point.x += (*p)->box().horizontalExtent();
-      point.y += (*p)->getStep();
+      x += childWidth[j];
+      y += childStep[j];
     }
-}
-
-scaled
-HorizontalArrayArea::getStep() const
-{
-  scaled step = 0;
-  for (std::vector<AreaRef>::const_iterator p = content.begin(); p != content.end(); p++)
-    step += (*p)->getStep();
-  return step;
+  point.x += x;
+  point.y += y;
 }
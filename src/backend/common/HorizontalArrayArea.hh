@@ -28,7 +28,7 @@
 class GMV_MathView_EXPORT HorizontalArrayArea : public LinearContainerArea
 {
 protected:
-  HorizontalArrayArea(const std::vector<AreaRef>& children) : LinearContainerArea(children) { }
+  HorizontalArrayArea(const std::vector<AreaRef>&);
   virtual ~HorizontalArrayArea() { }
 
 public:
@@ -43,7 +43,7 @@ public:
   virtual AreaRef fit(const scaled&, const scaled&, const scaled&) const;
   virtual void strength(int&, int&, int&) const;
   virtual void origin(AreaIndex, class Point&) const;
-  virtual scaled getStep(void) const;
+  virtual scaled getStep(void) const { return step; }
 
   virtual bool searchByCoords(class AreaId&, const scaled&, const scaled&) const;
 
@@ -51,6 +51,10 @@ public:
   scaled rightSide(AreaIndex) const;
 
 private:
+  std::vector<scaled> childStep;
+  BoundingBox bbox;
+  scaled step;
+
   static void flattenAux(std::vector<AreaRef>&, const std::vector<AreaRef>&);
 };
 
@@ -0,0 +1,235 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "LineBreaker.hh"
+
+// badness of a line that cannot be stretched nor shrunk to the
+// required width, still acceptable when no better break exists
+#define MAX_BADNESS 10000.0
+// added to the badness of every line, so that fewer lines are preferred
+#define LINE_PENALTY 10.0
+// added to the demerits of an overfull line that is accepted only
+// because there is no way to avoid it
+#define OVERFULL_DEMERITS 1.0e12
+
+LineBreaker::LineBreaker()
+{ }
+
+LineBreaker::~LineBreaker()
+{ }
+
+void
+LineBreaker::appendBox(const scaled& width)
+{
+  items.push_back(Item(BOX, width, scaled::zero(), scaled::zero(), 0));
+}
+
+void
+LineBreaker::appendGlue(const scaled& width, const scaled& stretch, const scaled& shrink)
+{
+  items.push_back(Item(GLUE, width, stretch, shrink, 0));
+}
+
+void
+LineBreaker::appendPenalty(const scaled& width, int penalty)
+{
+  items.push_back(Item(PENALTY, width, scaled::zero(), scaled::zero(),
+		       std::max(-INFINITE_PENALTY, std::min(penalty, (int) INFINITE_PENALTY))));
+}
+
+void
+LineBreaker::clear()
+{
+  items.clear();
+}
+
+bool
+LineBreaker::isFeasibleBreak(unsigned i) const
+{
+  if (i == items.size())
+    return true;
+  else if (items[i].type == GLUE)
+    return i > 0 && items[i - 1].type == BOX;
+  else if (items[i].type == PENALTY)
+    return items[i].penalty < INFINITE_PENALTY;
+  else
+    return false;
+}
+
+bool
+LineBreaker::isForcedBreak(unsigned i) const
+{
+  return i == items.size() || (items[i].type == PENALTY && items[i].penalty == -INFINITE_PENALTY);
+}
+
+unsigned
+LineBreaker::lineStart(unsigned i) const
+{
+  // glues and penalties following a break are discarded
+  if (i < items.size()) i++;
+  while (i < items.size() && items[i].type != BOX && !isForcedBreak(i))
+    i++;
+  return i;
+}
+
+double
+LineBreaker::badness(const scaled& width, const scaled& stretch, const scaled& shrink,
+		     const scaled& lineWidth, bool last, bool& overfull) const
+{
+  overfull = false;
+  if (width < lineWidth)
+    {
+      if (last)
+	return 0;
+      else if (stretch > scaled::zero())
+	{
+	  const double r = (lineWidth - width).toFloat() / stretch.toFloat();
+	  return std::min(100 * r * r * r, MAX_BADNESS);
+	}
+      else
+	return MAX_BADNESS;
+    }
+  else if (width > lineWidth)
+    {
+      const double r = (shrink > scaled::zero()) ? (width - lineWidth).toFloat() / shrink.toFloat() : 2;
+      if (r > 1)
+	{
+	  overfull = true;
+	  return MAX_BADNESS;
+	}
+      return 100 * r * r * r;
+    }
+  else
+    return 0;
+}
+
+double
+LineBreaker::demerits(double bad, unsigned i) const
+{
+  const double d = (LINE_PENALTY + bad) * (LINE_PENALTY + bad);
+  const int penalty = (i < items.size() && items[i].type == PENALTY) ? items[i].penalty : 0;
+  if (penalty >= 0)
+    return d + penalty * penalty;
+  else if (penalty > -INFINITE_PENALTY)
+    return d - penalty * penalty;
+  else
+    return d;
+}
+
+void
+LineBreaker::breakLines(const scaled& firstWidth, const scaled& restWidth, std::vector<unsigned>& breaks) const
+{
+  const unsigned n = items.size();
+
+  // running totals of the items up to (and excluding) the i-th one
+  std::vector<scaled> sumWidth(n + 1);
+  std::vector<scaled> sumStretch(n + 1);
+  std::vector<scaled> sumShrink(n + 1);
+  for (unsigned i = 0; i < n; i++)
+    {
+      sumWidth[i + 1] = sumWidth[i] + items[i].width;
+      sumStretch[i + 1] = sumStretch[i] + items[i].stretch;
+      sumShrink[i + 1] = sumShrink[i] + items[i].shrink;
+    }
+
+  std::vector<Node> nodes;
+  nodes.push_back(Node(0, 0, 0, 0, -1));
+  // the active nodes are those that can still begin the line ending
+  // at the current break. A node is deactivated as soon as the line
+  // starting from it gets overfull, so that the number of active nodes
+  // is bounded by the number of breaks that fit in a line
+  std::vector<unsigned> active;
+  active.push_back(0);
+
+  for (unsigned b = 0; b <= n; b++)
+    if (isFeasibleBreak(b))
+      {
+	const bool forced = isForcedBreak(b);
+	int best = -1;
+	double bestDemerits = 0;
+	int rescue = -1;
+
+	unsigned last = 0;
+	for (unsigned k = 0; k < active.size(); k++)
+	  {
+	    const unsigned a = active[k];
+	    const Node& node = nodes[a];
+	    if (node.start > b)
+	      {
+		active[last++] = a;
+		continue;
+	      }
+
+	    scaled width = sumWidth[b] - sumWidth[node.start];
+	    if (b < n && items[b].type == PENALTY) width += items[b].width;
+	    bool overfull;
+	    const double bad = badness(width,
+				       sumStretch[b] - sumStretch[node.start] + lineStretch,
+				       sumShrink[b] - sumShrink[node.start],
+				       (node.line == 0) ? firstWidth : restWidth,
+				       b == n, overfull);
+	    if (overfull)
+	      {
+		// the shortest overfull line is the least bad one
+		if (rescue < 0 || node.start > nodes[rescue].start
+		    || (node.start == nodes[rescue].start && node.demerits < nodes[rescue].demerits))
+		  rescue = a;
+		continue;
+	      }
+
+	    if (!forced) active[last++] = a;
+
+	    const double d = node.demerits + demerits(bad, b);
+	    if (best < 0 || d < bestDemerits)
+	      {
+		best = a;
+		bestDemerits = d;
+	      }
+	  }
+	active.resize(last);
+
+	if (best < 0 && active.empty() && rescue >= 0)
+	  {
+	    best = rescue;
+	    bestDemerits = nodes[rescue].demerits + demerits(MAX_BADNESS, b) + OVERFULL_DEMERITS;
+	  }
+
+	if (best >= 0)
+	  {
+	    active.push_back(nodes.size());
+	    nodes.push_back(Node(b, lineStart(b), nodes[best].line + 1, bestDemerits, best));
+	  }
+      }
+
+  assert(!nodes.empty() && nodes.back().index == n);
+
+  breaks.clear();
+  for (int i = nodes.size() - 1; i > 0; i = nodes[i].previous)
+    breaks.push_back(nodes[i].index);
+  std::reverse(breaks.begin(), breaks.end());
+}
@@ -0,0 +1,103 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __LineBreaker_hh__
+#define __LineBreaker_hh__
+
+#include <vector>
+
+#include "scaled.hh"
+
+// LineBreaker implements the total-fit line breaking algorithm by
+// Knuth and Plass. The paragraph is described as a sequence of boxes
+// (unbreakable material), glues (breakable, possibly stretchable
+// space) and penalties (explicit break opportunities with a cost).
+// Only item widths are needed, hence the same paragraph can be
+// broken for several line widths without formatting anything again
+class GMV_MathView_EXPORT LineBreaker
+{
+public:
+  LineBreaker(void);
+  ~LineBreaker();
+
+  enum { INFINITE_PENALTY = 10000 };
+
+  void appendBox(const scaled&);
+  void appendGlue(const scaled&, const scaled& = scaled::zero(), const scaled& = scaled::zero());
+  // a penalty of INFINITE_PENALTY forbids the break, a penalty
+  // of -INFINITE_PENALTY forces it
+  void appendPenalty(const scaled&, int);
+  void clear(void);
+
+  // stretchability added to every line, for material that is set
+  // ragged right and has no stretchable glue of its own
+  void setLineStretch(const scaled& s) { lineStretch = s; }
+  scaled getLineStretch(void) const { return lineStretch; }
+
+  unsigned getSize(void) const { return items.size(); }
+
+  // computes the breaks minimizing the total demerits when the first
+  // line is firstWidth wide and all the others are restWidth wide.
+  // Each break is the index of the item ending a line, the last line
+  // ending at getSize(). Overfull lines are produced only when there
+  // is no other way to break the paragraph
+  void breakLines(const scaled&, const scaled&, std::vector<unsigned>&) const;
+
+protected:
+  enum ItemType { BOX, GLUE, PENALTY };
+
+  struct Item
+  {
+    Item(ItemType t, const scaled& w, const scaled& st, const scaled& sh, int p)
+      : type(t), width(w), stretch(st), shrink(sh), penalty(p) { }
+
+    ItemType type;
+    scaled width;
+    scaled stretch;
+    scaled shrink;
+    int penalty;
+  };
+
+  struct Node
+  {
+    Node(unsigned i, unsigned s, unsigned l, double d, int p)
+      : index(i), start(s), line(l), demerits(d), previous(p) { }
+
+    unsigned index;
+    unsigned start;
+    unsigned line;
+    double demerits;
+    int previous;
+  };
+
+  bool isFeasibleBreak(unsigned) const;
+  bool isForcedBreak(unsigned) const;
+  unsigned lineStart(unsigned) const;
+  double badness(const scaled&, const scaled&, const scaled&, const scaled&, bool, bool&) const;
+  double demerits(double, unsigned) const;
+
+private:
+  std::vector<Item> items;
+  scaled lineStretch;
+};
+
+#endif // __LineBreaker_hh__
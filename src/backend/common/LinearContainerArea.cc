@@ -25,6 +25,18 @@
 #include "GlyphStringArea.hh"
 #include "GlyphArea.hh"
 
+LinearContainerArea::LinearContainerArea(const std::vector<AreaRef>& c)
+  : content(c), childWidth(c.size()), childHeight(c.size()), childDepth(c.size())
+{
+  for (std::vector<AreaRef>::size_type i = 0; i < content.size(); i++)
+    {
+      const BoundingBox box = content[i]->box();
+      childWidth[i] = box.width;
+      childHeight[i] = box.height;
+      childDepth[i] = box.depth;
+    }
+}
+
 void
 LinearContainerArea::render(class RenderingContext& context, const scaled& x, const scaled& y) const
 {
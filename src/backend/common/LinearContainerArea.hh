@@ -30,7 +30,7 @@
 class GMV_MathView_EXPORT LinearContainerArea : public ContainerArea
 {
 protected:
-  LinearContainerArea(const std::vector<AreaRef>& c) : content(c) { }
+  LinearContainerArea(const std::vector<AreaRef>&);
   virtual ~LinearContainerArea() { }
 
 public:
@@ -53,7 +53,15 @@ public:
   const std::vector<AreaRef> getChildren(void) const { return content; }
 
 protected:
+  BoundingBox childBox(AreaIndex i) const
+  { return BoundingBox(childWidth[i], childHeight[i], childDepth[i]); }
+
   std::vector<AreaRef> content;
+  // the extents of the children, kept in parallel arrays so that
+  // container metrics are computed without visiting the children
+  std::vector<scaled> childWidth;
+  std::vector<scaled> childHeight;
+  std::vector<scaled> childDepth;
 };
 
 #endif // __LinearContainerArea_hh__
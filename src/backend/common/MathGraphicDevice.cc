@@ -58,6 +58,13 @@ MathGraphicDevice::axis(const FormattingContext& context) const
   return (pbox.height - pbox.depth) / 2;
 }
 
+void
+MathGraphicDevice::computeMetrics(const FormattingContext& context, GraphicMetrics& m) const
+{
+  GraphicDevice::computeMetrics(context, m);
+  m.axis = axis(context);
+}
+
 AreaRef
 MathGraphicDevice::wrapper(const FormattingContext&, const AreaRef& area) const
 {
@@ -73,28 +80,84 @@ MathGraphicDevice::dummy(const FormattingContext& context) const
 #include "CachedShapedString.hh"
 #include "HashMap.hh"
 typedef HASH_MAP_NS::hash_map<CachedShapedStringKey, AreaRef, CachedShapedStringKeyHash> ShapedStringCache;
-typedef HASH_MAP_NS::hash_map<CachedShapedStretchyStringKey, AreaRef, CachedShapedStringKeyHash> ShapedStretchyStringCache;
+typedef HASH_MAP_NS::hash_map<CachedShapedStretchyStringKey, AreaRef, CachedShapedStretchyStringKeyHash> ShapedStretchyStringCache;
 
 static ShapedStretchyStringCache stretchyStringCache;
+static unsigned stretchyStringHits = 0;
+static unsigned stretchyStringMisses = 0;
 static ShapedStringCache stringCache;
+// the frozen caches are only read, see freezeCache
+static ShapedStretchyStringCache frozenStretchyStringCache;
+static ShapedStringCache frozenStringCache;
 
 void
 MathGraphicDevice::clearCache() const
 {
   stretchyStringCache.clear();
+  stretchyStringHits = stretchyStringMisses = 0;
   stringCache.clear();
+  frozenStretchyStringCache.clear();
+  frozenStringCache.clear();
+  clearMetrics();
+}
+
+void
+MathGraphicDevice::freezeCache() const
+{
+  // the counters of the frozen areas must not be written either
+  for (ShapedStretchyStringCache::const_iterator p = stretchyStringCache.begin(); p != stretchyStringCache.end(); p++)
+    if (p->second) p->second->makeImmortal();
+  for (ShapedStringCache::const_iterator p = stringCache.begin(); p != stringCache.end(); p++)
+    if (p->second) p->second->makeImmortal();
+
+  if (frozenStretchyStringCache.empty())
+    frozenStretchyStringCache.swap(stretchyStringCache);
+  else
+    {
+      frozenStretchyStringCache.insert(stretchyStringCache.begin(), stretchyStringCache.end());
+      stretchyStringCache.clear();
+    }
+
+  if (frozenStringCache.empty())
+    frozenStringCache.swap(stringCache);
+  else
+    {
+      frozenStringCache.insert(stringCache.begin(), stringCache.end());
+      stringCache.clear();
+    }
+
+  getShaperManager()->freezeCache();
+}
+
+void
+MathGraphicDevice::getStretchyCacheStats(unsigned& hits, unsigned& misses) const
+{
+  hits = stretchyStringHits;
+  misses = stretchyStringMisses;
 }
 
 AreaRef
-MathGraphicDevice::stretchedString(const FormattingContext& context, const String& str) const
+MathGraphicDevice::stretchedString(const FormattingContext& context, const String& str,
+				   const UCS4String* s) const
 {
   CachedShapedStretchyStringKey key(str, context.getVariant(), context.getSize(),
 				    context.getStretchH(), context.getStretchV());
 #if 1
+  if (!frozenStretchyStringCache.empty())
+    {
+      ShapedStretchyStringCache::const_iterator p = frozenStretchyStringCache.find(key);
+      if (p != frozenStretchyStringCache.end())
+	{
+	  stretchyStringHits++;
+	  return p->second;
+	}
+    }
+
   std::pair<ShapedStretchyStringCache::iterator, bool> r = stretchyStringCache.insert(std::make_pair(key, AreaRef(0)));
   if (r.second)
     {
-      UCS4String source = UCS4StringOfString(str);
+      stretchyStringMisses++;
+      UCS4String source = s ? *s : UCS4StringOfString(str);
       if (context.getMathMode())
 	mapMathVariant(context.getVariant(), source);
       r.first->second = getShaperManager()->shapeStretchy(context,
@@ -106,14 +169,17 @@ MathGraphicDevice::stretchedString(const FormattingContext& context, const Strin
       return r.first->second;
     }
   else
-    return r.first->second;
+    {
+      stretchyStringHits++;
+      return r.first->second;
+    }
 #else
   ShapedStretchyStringCache::const_iterator p = stretchyStringCache.find(key);
   if (p != stretchyStringCache.end())
     return p->second;
   else
     {
-      UCS4String source = UCS4StringOfString(str);
+      UCS4String source = s ? *s : UCS4StringOfString(str);
       mapMathVariant(context.getVariant(), source);
       return (stretchyStringCache[key] = getShaperManager()->shapeStretchy(context,
 									   context.getMathMLElement(),
@@ -126,15 +192,23 @@ MathGraphicDevice::stretchedString(const FormattingContext& context, const Strin
 }
 
 AreaRef
-MathGraphicDevice::unstretchedString(const FormattingContext& context, const String& str) const
+MathGraphicDevice::unstretchedString(const FormattingContext& context, const String& str,
+				     const UCS4String* s) const
 {
   CachedShapedStringKey key(str, context.getVariant(), context.getSize());
 
 #if 1
+  if (!frozenStringCache.empty())
+    {
+      ShapedStringCache::const_iterator p = frozenStringCache.find(key);
+      if (p != frozenStringCache.end())
+	return p->second;
+    }
+
   std::pair<ShapedStringCache::iterator, bool> r = stringCache.insert(std::make_pair(key, AreaRef(0)));
   if (r.second)
     {
-      UCS4String source = UCS4StringOfString(str);
+      UCS4String source = s ? *s : UCS4StringOfString(str);
       if (context.getMathMode())
 	mapMathVariant(context.getVariant(), source);
       r.first->second = getShaperManager()->shape(context,
@@ -151,7 +225,7 @@ MathGraphicDevice::unstretchedString(const FormattingContext& context, const Str
     return p->second;
   else
     {
-      UCS4String source = UCS4StringOfString(str);
+      UCS4String source = s ? *s : UCS4StringOfString(str);
       mapMathVariant(context.getVariant(), source);
       return (stringCache[key] = getShaperManager()->shape(context,
 							   context.getMathMLElement(),
@@ -173,6 +247,18 @@ MathGraphicDevice::string(const FormattingContext& context,
     return unstretchedString(context, str);
 }
 
+AreaRef
+MathGraphicDevice::string(const FormattingContext& context,
+			  const String& str, const UCS4String& source) const
+{
+  if (str.length() == 0)
+    return dummy(context);
+  else if (context.getMathMLElement() == context.getStretchOperator())
+    return stretchedString(context, str, &source);
+  else
+    return unstretchedString(context, str, &source);
+}
+
 AreaRef
 MathGraphicDevice::stretchStringV(const FormattingContext& context,
 				  const String& str,
@@ -200,7 +286,7 @@ MathGraphicDevice::fraction(const FormattingContext& context,
 			    const AreaRef& denominator,
 			    const Length& lineThickness) const
 {
-  const scaled RULE = defaultLineThickness(context);
+  const scaled RULE = metrics(context).lineThickness;
 
   std::vector<AreaRef> v;
 
@@ -213,7 +299,7 @@ MathGraphicDevice::fraction(const FormattingContext& context,
   v.push_back(s);
   v.push_back(numerator);
 
-  return getFactory()->shift(getFactory()->verticalArray(v, 2), axis(context));
+  return getFactory()->shift(getFactory()->verticalArray(v, 2), metrics(context).axis);
 }
 
 AreaRef
@@ -239,7 +325,7 @@ MathGraphicDevice::radical(const FormattingContext& context,
 			   const AreaRef& base,
 			   const AreaRef& index) const
 {
-  const scaled RULE = defaultLineThickness(context);
+  const scaled RULE = metrics(context).lineThickness;
   const UCS4String root(1, 0x221a);
   const BoundingBox baseBox = base->box();
   const AreaRef rootArea = stretchStringV(context, StringOfUCS4String(root), baseBox.height + 2 * RULE, baseBox.depth);
@@ -281,9 +367,10 @@ MathGraphicDevice::calculateDefaultScriptShift(const FormattingContext& context,
 {
   assert(baseBox.defined());
 
-  const scaled EX = ex(context);
-  const scaled AXIS = axis(context);
-  const scaled RULE = defaultLineThickness(context);
+  const GraphicMetrics& m = metrics(context);
+  const scaled EX = m.ex;
+  const scaled AXIS = m.axis;
+  const scaled RULE = m.lineThickness;
 
   u = std::max(EX, baseBox.height - AXIS);
   v = std::max(AXIS, baseBox.depth + AXIS);
@@ -552,7 +639,7 @@ MathGraphicDevice::underOver(const FormattingContext& context,
   
   //the next instructions represent the default behavior
   //in which overScript and underScript aren't single char
-  const scaled RULE = defaultLineThickness(context);
+  const scaled RULE = metrics(context).lineThickness;
   const AreaRef singleSpace = getFactory()->verticalSpace(RULE, 0);
   const AreaRef tripleSpace = getFactory()->verticalSpace(3 * RULE, 0);
 
@@ -593,8 +680,8 @@ MathGraphicDevice::enclose(const FormattingContext& context,
 
       AreaRef res = base;
 
-      AreaRef vobj = getFactory()->verticalLine(defaultLineThickness(context), context.getColor());
-      AreaRef hobj = getFactory()->horizontalLine(defaultLineThickness(context), context.getColor());
+      AreaRef vobj = getFactory()->verticalLine(metrics(context).lineThickness, context.getColor());
+      AreaRef hobj = getFactory()->horizontalLine(metrics(context).lineThickness, context.getColor());
 
       if (notation == "box" || notation == "longdiv" || notation == "left") c.push_back(vobj);
       c.push_back(res);
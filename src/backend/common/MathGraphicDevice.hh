@@ -34,6 +34,15 @@ protected:
 
 public:
   virtual void clearCache(void) const;
+  // moves the shaped strings cached so far, and the caches of the
+  // shapers, into tables that are only looked up from then on, new
+  // strings go into fresh tables. The cached areas become immortal so
+  // that their reference counters are not written either. A server
+  // freezes the cache after warming it up and before forking, so that
+  // the warmed tables stay in pages shared with the workers
+  void freezeCache(void) const;
+  // hits and misses of the cache of stretched strings keyed on the exact span
+  void getStretchyCacheStats(unsigned&, unsigned&) const;
 
   // Length evaluation, fundamental properties
 
@@ -43,6 +52,8 @@ public:
   // token formatting
 
   AreaRef string(const class FormattingContext&, const String& str) const;
+  // the same when the decoded string is at hand
+  AreaRef string(const class FormattingContext&, const String& str, const UCS4String& source) const;
   virtual AreaRef glyph(const class FormattingContext&,
 			const String& alt, const String& fontFamily,
 			unsigned long index) const;
@@ -83,8 +94,11 @@ public:
   virtual AreaRef dummy(const class FormattingContext& context) const;
 
 protected:
-  AreaRef stretchedString(const class FormattingContext&, const String& str) const;
-  AreaRef unstretchedString(const class FormattingContext&, const String& str) const;
+  virtual void computeMetrics(const class FormattingContext&, GraphicMetrics&) const;
+  // the source is the decoded string, if it is not given the string
+  // is decoded only when it is not found in the cache
+  AreaRef stretchedString(const class FormattingContext&, const String& str, const UCS4String* source = 0) const;
+  AreaRef unstretchedString(const class FormattingContext&, const String& str, const UCS4String* source = 0) const;
   AreaRef stretchStringV(const class FormattingContext&,
 			 const String& str,
 			 const scaled& height,
@@ -0,0 +1,63 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "OpenTypeGlyphArea.hh"
+#include "OpenTypeGlyphRenderer.hh"
+#include "OpenTypeMathFont.hh"
+#include "RenderingContext.hh"
+
+OpenTypeGlyphArea::OpenTypeGlyphArea(const SmartPtr<OpenTypeMathFont>& f, unsigned g, const scaled& s)
+  : font(f), glyph(g), size(s)
+{ }
+
+OpenTypeGlyphArea::~OpenTypeGlyphArea()
+{ }
+
+SmartPtr<OpenTypeGlyphArea>
+OpenTypeGlyphArea::create(const SmartPtr<OpenTypeMathFont>& font, unsigned glyph, const scaled& size)
+{ return new OpenTypeGlyphArea(font, glyph, size); }
+
+SmartPtr<OpenTypeMathFont>
+OpenTypeGlyphArea::getFont() const
+{ return font; }
+
+BoundingBox
+OpenTypeGlyphArea::box() const
+{ return font->getGlyphBoundingBox(glyph, size); }
+
+scaled
+OpenTypeGlyphArea::leftEdge() const
+{ return font->getGlyphLeftEdge(glyph, size); }
+
+scaled
+OpenTypeGlyphArea::rightEdge() const
+{ return font->getGlyphRightEdge(glyph, size); }
+
+void
+OpenTypeGlyphArea::render(RenderingContext& c, const scaled& x, const scaled& y) const
+{
+  // backends that cannot draw OpenType glyphs leave the space empty
+  if (OpenTypeGlyphRenderer* renderer = dynamic_cast<OpenTypeGlyphRenderer*>(&c))
+    renderer->drawOpenTypeGlyph(x, y, *font, glyph, size);
+}
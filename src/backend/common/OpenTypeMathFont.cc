@@ -0,0 +1,298 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_TRUETYPE_TABLES_H
+
+#include "AbstractLogger.hh"
+#include "OpenTypeMathFont.hh"
+
+// the MATH table is big-endian, offsets are relative to the start of
+// the subtable that contains them and a null offset means the
+// subtable is missing. Reads past the end of the table give 0
+
+static unsigned
+getU16(const unsigned char* data, unsigned long length, unsigned long offset)
+{ return (offset + 2 <= length) ? ((data[offset] << 8) | data[offset + 1]) : 0; }
+
+static int
+getS16(const unsigned char* data, unsigned long length, unsigned long offset)
+{ return static_cast<short>(getU16(data, length, offset)); }
+
+// the glyphs of a coverage table, in the order of their coverage index
+static void
+getCoverage(const unsigned char* data, unsigned long length, unsigned long offset,
+	    std::vector<unsigned>& glyph)
+{
+  glyph.clear();
+  switch (getU16(data, length, offset))
+    {
+    case 1:
+      {
+	const unsigned n = getU16(data, length, offset + 2);
+	glyph.reserve(n);
+	for (unsigned i = 0; i < n; i++)
+	  glyph.push_back(getU16(data, length, offset + 4 + 2 * i));
+      }
+      break;
+    case 2:
+      {
+	const unsigned n = getU16(data, length, offset + 2);
+	for (unsigned i = 0; i < n; i++)
+	  {
+	    const unsigned long range = offset + 4 + 6 * i;
+	    const unsigned first = getU16(data, length, range);
+	    const unsigned last = getU16(data, length, range + 2);
+	    const unsigned index = getU16(data, length, range + 4);
+	    if (first > last) continue;
+	    if (glyph.size() < index + last - first + 1) glyph.resize(index + last - first + 1);
+	    for (unsigned g = first; g <= last; g++)
+	      glyph[index + g - first] = g;
+	  }
+      }
+      break;
+    default:
+      break;
+    }
+}
+
+OpenTypeMathFont::OpenTypeMathFont(const String& fn)
+  : fileName(fn), unitsPerEm(1000), minConnectorOverlap(0)
+{
+  std::fill(constant, constant + N_CONSTANTS, 0);
+}
+
+OpenTypeMathFont::~OpenTypeMathFont()
+{ }
+
+SmartPtr<OpenTypeMathFont>
+OpenTypeMathFont::create(const SmartPtr<AbstractLogger>& logger, const String& fileName)
+{
+  FT_Library library;
+  if (FT_Init_FreeType(&library))
+    {
+      logger->out(LOG_ERROR, "could not initialize FreeType");
+      return 0;
+    }
+
+  SmartPtr<OpenTypeMathFont> font;
+  FT_Face face;
+  if (FT_New_Face(library, fileName.c_str(), 0, &face))
+    logger->out(LOG_ERROR, "could not open font `%s'", fileName.c_str());
+  else
+    {
+      font = new OpenTypeMathFont(fileName);
+      if (!font->load(logger, face)) font = 0;
+      FT_Done_Face(face);
+    }
+
+  FT_Done_FreeType(library);
+  return font;
+}
+
+bool
+OpenTypeMathFont::load(const SmartPtr<AbstractLogger>& logger, FT_Face face)
+{
+  unitsPerEm = face->units_per_EM ? face->units_per_EM : 1000;
+
+  glyphs.resize(face->num_glyphs);
+  for (unsigned i = 0; i < glyphs.size(); i++)
+    {
+      GlyphMetrics& m = glyphs[i];
+      if (FT_Load_Glyph(face, i, FT_LOAD_NO_SCALE | FT_LOAD_NO_HINTING | FT_LOAD_IGNORE_TRANSFORM) == 0)
+	{
+	  const FT_Glyph_Metrics& metrics = face->glyph->metrics;
+	  m.advance = metrics.horiAdvance;
+	  m.xMin = metrics.horiBearingX;
+	  m.xMax = metrics.horiBearingX + metrics.width;
+	  m.yMax = metrics.horiBearingY;
+	  m.yMin = metrics.horiBearingY - metrics.height;
+	}
+      else
+	m.advance = m.xMin = m.xMax = m.yMin = m.yMax = 0;
+    }
+
+  if (FT_Select_Charmap(face, FT_ENCODING_UNICODE) == 0)
+    {
+      FT_UInt index;
+      for (FT_ULong ch = FT_Get_First_Char(face, &index); index != 0; ch = FT_Get_Next_Char(face, ch, &index))
+	charMap.push_back(std::make_pair(Char32(ch), unsigned(index)));
+    }
+
+  FT_ULong length = 0;
+  const FT_ULong tag = FT_MAKE_TAG('M', 'A', 'T', 'H');
+  if (FT_Load_Sfnt_Table(face, tag, 0, 0, &length) || length == 0)
+    {
+      logger->out(LOG_ERROR, "font `%s' has no MATH table", fileName.c_str());
+      return false;
+    }
+
+  std::vector<unsigned char> data(length);
+  if (FT_Load_Sfnt_Table(face, tag, 0, &data[0], &length)
+      || !parseMathTable(&data[0], length))
+    {
+      logger->out(LOG_ERROR, "could not read the MATH table of font `%s'", fileName.c_str());
+      return false;
+    }
+
+  logger->out(LOG_DEBUG, "loaded font `%s': %d glyphs, %d characters, %d constructions",
+	      fileName.c_str(), glyphs.size(), charMap.size(), constructions.size());
+
+  return true;
+}
+
+bool
+OpenTypeMathFont::parseMathTable(const unsigned char* data, unsigned long length)
+{
+  if (getU16(data, length, 0) != 1) return false;
+
+  const unsigned long constants = getU16(data, length, 4);
+  const unsigned long glyphInfo = getU16(data, length, 6);
+  const unsigned long variants = getU16(data, length, 8);
+
+  if (constants)
+    {
+      // four 16-bit values, the math value records (a value followed
+      // by a device table offset) and one last 16-bit value
+      for (unsigned i = 0; i < 4; i++)
+	constant[i] = getS16(data, length, constants + 2 * i);
+      for (unsigned i = MATH_LEADING; i < RADICAL_DEGREE_BOTTOM_RAISE_PERCENT; i++)
+	constant[i] = getS16(data, length, constants + 8 + 4 * (i - MATH_LEADING));
+      constant[RADICAL_DEGREE_BOTTOM_RAISE_PERCENT] =
+	getS16(data, length, constants + 8 + 4 * (RADICAL_DEGREE_BOTTOM_RAISE_PERCENT - MATH_LEADING));
+    }
+
+  italicCorrection.assign(glyphs.size(), 0);
+  if (glyphInfo)
+    if (const unsigned long italics = getU16(data, length, glyphInfo))
+      {
+	std::vector<unsigned> covered;
+	getCoverage(data, length, glyphInfo + italics + getU16(data, length, glyphInfo + italics), covered);
+	const unsigned n = std::min<unsigned>(covered.size(), getU16(data, length, glyphInfo + italics + 2));
+	for (unsigned i = 0; i < n; i++)
+	  if (covered[i] < italicCorrection.size())
+	    italicCorrection[covered[i]] = getS16(data, length, glyphInfo + italics + 4 + 4 * i);
+      }
+
+  vConstruction.assign(glyphs.size(), -1);
+  hConstruction.assign(glyphs.size(), -1);
+  if (variants)
+    {
+      minConnectorOverlap = getU16(data, length, variants);
+      const unsigned nV = getU16(data, length, variants + 6);
+      const unsigned nH = getU16(data, length, variants + 8);
+      parseConstructions(data, length, variants, getU16(data, length, variants + 2),
+			 nV, variants + 10, vConstruction);
+      parseConstructions(data, length, variants, getU16(data, length, variants + 4),
+			 nH, variants + 10 + 2 * nV, hConstruction);
+    }
+
+  return true;
+}
+
+void
+OpenTypeMathFont::parseConstructions(const unsigned char* data, unsigned long length,
+				     unsigned long variants, unsigned long coverage,
+				     unsigned n, unsigned long offsets, std::vector<int>& index)
+{
+  if (!coverage) return;
+
+  std::vector<unsigned> covered;
+  getCoverage(data, length, variants + coverage, covered);
+  n = std::min<unsigned>(n, covered.size());
+  for (unsigned i = 0; i < n; i++)
+    {
+      const unsigned long c = getU16(data, length, offsets + 2 * i);
+      if (!c || covered[i] >= index.size()) continue;
+
+      Construction construction;
+      const unsigned long cons = variants + c;
+      const unsigned nVariants = getU16(data, length, cons + 2);
+      construction.variants.reserve(nVariants);
+      for (unsigned j = 0; j < nVariants; j++)
+	{
+	  Variant v;
+	  v.glyph = getU16(data, length, cons + 4 + 4 * j);
+	  v.advance = getU16(data, length, cons + 6 + 4 * j);
+	  if (v.glyph < glyphs.size()) construction.variants.push_back(v);
+	}
+
+      if (const unsigned long a = getU16(data, length, cons))
+	{
+	  // the italic correction of the assembly comes first
+	  const unsigned long assembly = cons + a;
+	  const unsigned nParts = getU16(data, length, assembly + 4);
+	  construction.parts.reserve(nParts);
+	  for (unsigned j = 0; j < nParts; j++)
+	    {
+	      const unsigned long part = assembly + 6 + 10 * j;
+	      Part p;
+	      p.glyph = getU16(data, length, part);
+	      p.startConnector = getU16(data, length, part + 2);
+	      p.endConnector = getU16(data, length, part + 4);
+	      p.fullAdvance = getU16(data, length, part + 6);
+	      p.extender = getU16(data, length, part + 8) & 0x0001;
+	      if (p.glyph < glyphs.size()) construction.parts.push_back(p);
+	    }
+	}
+
+      if (!construction.variants.empty() || !construction.parts.empty())
+	{
+	  index[covered[i]] = constructions.size();
+	  constructions.push_back(construction);
+	}
+    }
+}
+
+unsigned
+OpenTypeMathFont::getGlyphIndex(Char32 ch) const
+{
+  std::vector< std::pair<Char32, unsigned> >::const_iterator p =
+    std::lower_bound(charMap.begin(), charMap.end(), std::make_pair(ch, 0u));
+  return (p != charMap.end() && p->first == ch) ? p->second : 0;
+}
+
+BoundingBox
+OpenTypeMathFont::getGlyphBoundingBox(unsigned glyph, const scaled& size) const
+{
+  if (glyph >= glyphs.size()) return BoundingBox(scaled::zero(), scaled::zero(), scaled::zero());
+  const GlyphMetrics& m = glyphs[glyph];
+  return BoundingBox(toScaled(m.advance, size), toScaled(m.yMax, size), toScaled(-m.yMin, size));
+}
+
+scaled
+OpenTypeMathFont::getGlyphLeftEdge(unsigned glyph, const scaled& size) const
+{ return (glyph < glyphs.size()) ? toScaled(glyphs[glyph].xMin, size) : scaled::zero(); }
+
+scaled
+OpenTypeMathFont::getGlyphRightEdge(unsigned glyph, const scaled& size) const
+{ return (glyph < glyphs.size()) ? toScaled(glyphs[glyph].xMax, size) : scaled::zero(); }
+
+scaled
+OpenTypeMathFont::getItalicCorrection(unsigned glyph, const scaled& size) const
+{ return (glyph < italicCorrection.size()) ? toScaled(italicCorrection[glyph], size) : scaled::zero(); }
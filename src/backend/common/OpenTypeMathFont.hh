@@ -0,0 +1,190 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __OpenTypeMathFont_hh__
+#define __OpenTypeMathFont_hh__
+
+#include <vector>
+#include <utility>
+
+#include "Char.hh"
+#include "Object.hh"
+#include "SmartPtr.hh"
+#include "String.hh"
+#include "BoundingBox.hh"
+
+// OpenTypeMathFont is an OpenType font with a MATH table. The font is
+// read once with FreeType and everything the engine needs (character
+// map, glyph metrics, math constants, italic corrections, variants
+// and assemblies) is kept in tables indexed by glyph, in font units
+class GMV_MathView_EXPORT OpenTypeMathFont : public Object
+{
+protected:
+  OpenTypeMathFont(const String&);
+  virtual ~OpenTypeMathFont();
+
+public:
+  // returns 0 if the font cannot be read or it has no MATH table
+  static SmartPtr<OpenTypeMathFont> create(const SmartPtr<class AbstractLogger>&, const String&);
+
+  // the constants of the MATH table, in the order they are stored
+  enum Constant
+    {
+      SCRIPT_PERCENT_SCALE_DOWN,
+      SCRIPT_SCRIPT_PERCENT_SCALE_DOWN,
+      DELIMITED_SUB_FORMULA_MIN_HEIGHT,
+      DISPLAY_OPERATOR_MIN_HEIGHT,
+      MATH_LEADING,
+      AXIS_HEIGHT,
+      ACCENT_BASE_HEIGHT,
+      FLATTENED_ACCENT_BASE_HEIGHT,
+      SUBSCRIPT_SHIFT_DOWN,
+      SUBSCRIPT_TOP_MAX,
+      SUBSCRIPT_BASELINE_DROP_MIN,
+      SUPERSCRIPT_SHIFT_UP,
+      SUPERSCRIPT_SHIFT_UP_CRAMPED,
+      SUPERSCRIPT_BOTTOM_MIN,
+      SUPERSCRIPT_BASELINE_DROP_MAX,
+      SUB_SUPERSCRIPT_GAP_MIN,
+      SUPERSCRIPT_BOTTOM_MAX_WITH_SUBSCRIPT,
+      SPACE_AFTER_SCRIPT,
+      UPPER_LIMIT_GAP_MIN,
+      UPPER_LIMIT_BASELINE_RISE_MIN,
+      LOWER_LIMIT_GAP_MIN,
+      LOWER_LIMIT_BASELINE_DROP_MIN,
+      STACK_TOP_SHIFT_UP,
+      STACK_TOP_DISPLAY_STYLE_SHIFT_UP,
+      STACK_BOTTOM_SHIFT_DOWN,
+      STACK_BOTTOM_DISPLAY_STYLE_SHIFT_DOWN,
+      STACK_GAP_MIN,
+      STACK_DISPLAY_STYLE_GAP_MIN,
+      STRETCH_STACK_TOP_SHIFT_UP,
+      STRETCH_STACK_BOTTOM_SHIFT_DOWN,
+      STRETCH_STACK_GAP_ABOVE_MIN,
+      STRETCH_STACK_GAP_BELOW_MIN,
+      FRACTION_NUMERATOR_SHIFT_UP,
+      FRACTION_NUMERATOR_DISPLAY_STYLE_SHIFT_UP,
+      FRACTION_DENOMINATOR_SHIFT_DOWN,
+      FRACTION_DENOMINATOR_DISPLAY_STYLE_SHIFT_DOWN,
+      FRACTION_NUMERATOR_GAP_MIN,
+      FRACTION_NUM_DISPLAY_STYLE_GAP_MIN,
+      FRACTION_RULE_THICKNESS,
+      FRACTION_DENOMINATOR_GAP_MIN,
+      FRACTION_DENOM_DISPLAY_STYLE_GAP_MIN,
+      SKEWED_FRACTION_HORIZONTAL_GAP,
+      SKEWED_FRACTION_VERTICAL_GAP,
+      OVERBAR_VERTICAL_GAP,
+      OVERBAR_RULE_THICKNESS,
+      OVERBAR_EXTRA_ASCENDER,
+      UNDERBAR_VERTICAL_GAP,
+      UNDERBAR_RULE_THICKNESS,
+      UNDERBAR_EXTRA_DESCENDER,
+      RADICAL_VERTICAL_GAP,
+      RADICAL_DISPLAY_STYLE_VERTICAL_GAP,
+      RADICAL_RULE_THICKNESS,
+      RADICAL_EXTRA_ASCENDER,
+      RADICAL_KERN_BEFORE_DEGREE,
+      RADICAL_KERN_AFTER_DEGREE,
+      RADICAL_DEGREE_BOTTOM_RAISE_PERCENT,
+      N_CONSTANTS
+    };
+
+  struct Variant
+  {
+    unsigned glyph;
+    int advance;
+  };
+
+  struct Part
+  {
+    unsigned glyph;
+    int startConnector;
+    int endConnector;
+    int fullAdvance;
+    bool extender;
+  };
+
+  // the variants are by increasing size, the parts go from bottom
+  // to top or from left to right
+  struct Construction
+  {
+    std::vector<Variant> variants;
+    std::vector<Part> parts;
+  };
+
+  String getFileName(void) const { return fileName; }
+  unsigned getUnitsPerEm(void) const { return unitsPerEm; }
+  unsigned getGlyphCount(void) const { return glyphs.size(); }
+
+  // pairs of character and glyph, by increasing character
+  const std::vector< std::pair<Char32, unsigned> >& getCharMap(void) const { return charMap; }
+  unsigned getGlyphIndex(Char32) const;
+
+  scaled toScaled(int units, const scaled& size) const
+  { return scaled((size.toFloat() * units) / unitsPerEm); }
+
+  int getConstantValue(Constant c) const { return constant[c]; }
+  scaled getConstant(Constant c, const scaled& size) const
+  { return toScaled(constant[c], size); }
+  int getMinConnectorOverlapValue(void) const { return minConnectorOverlap; }
+  scaled getMinConnectorOverlap(const scaled& size) const
+  { return toScaled(minConnectorOverlap, size); }
+
+  BoundingBox getGlyphBoundingBox(unsigned, const scaled&) const;
+  scaled getGlyphLeftEdge(unsigned, const scaled&) const;
+  scaled getGlyphRightEdge(unsigned, const scaled&) const;
+  scaled getItalicCorrection(unsigned, const scaled&) const;
+
+  const Construction* getVerticalConstruction(unsigned glyph) const
+  { return (glyph < vConstruction.size() && vConstruction[glyph] >= 0) ? &constructions[vConstruction[glyph]] : 0; }
+  const Construction* getHorizontalConstruction(unsigned glyph) const
+  { return (glyph < hConstruction.size() && hConstruction[glyph] >= 0) ? &constructions[hConstruction[glyph]] : 0; }
+
+protected:
+  bool load(const SmartPtr<class AbstractLogger>&, struct FT_FaceRec_*);
+  bool parseMathTable(const unsigned char*, unsigned long);
+  void parseConstructions(const unsigned char*, unsigned long, unsigned long,
+			  unsigned long, unsigned, unsigned long, std::vector<int>&);
+
+  struct GlyphMetrics
+  {
+    int advance;
+    int xMin;
+    int yMin;
+    int xMax;
+    int yMax;
+  };
+
+private:
+  String fileName;
+  unsigned unitsPerEm;
+  std::vector< std::pair<Char32, unsigned> > charMap;
+  std::vector<GlyphMetrics> glyphs;
+  std::vector<int> italicCorrection;
+  int constant[N_CONSTANTS];
+  int minConnectorOverlap;
+  std::vector<Construction> constructions;
+  std::vector<int> vConstruction;
+  std::vector<int> hConstruction;
+};
+
+#endif // __OpenTypeMathFont_hh__
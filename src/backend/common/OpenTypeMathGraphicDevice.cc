@@ -0,0 +1,123 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "AbstractLogger.hh"
+#include "AreaFactory.hh"
+#include "FormattingContext.hh"
+#include "OpenTypeGlyphArea.hh"
+#include "OpenTypeMathFont.hh"
+#include "OpenTypeMathGraphicDevice.hh"
+
+OpenTypeMathGraphicDevice::OpenTypeMathGraphicDevice(const SmartPtr<AbstractLogger>& l)
+  : MathGraphicDevice(l)
+{ }
+
+OpenTypeMathGraphicDevice::~OpenTypeMathGraphicDevice()
+{ }
+
+SmartPtr<OpenTypeMathGraphicDevice>
+OpenTypeMathGraphicDevice::create(const SmartPtr<AbstractLogger>& l)
+{ return new OpenTypeMathGraphicDevice(l); }
+
+void
+OpenTypeMathGraphicDevice::setFont(const SmartPtr<OpenTypeMathFont>& f)
+{
+  font = f;
+  clearMetrics();
+}
+
+SmartPtr<OpenTypeMathFont>
+OpenTypeMathGraphicDevice::getFont() const
+{ return font; }
+
+scaled
+OpenTypeMathGraphicDevice::ex(const FormattingContext& context) const
+{
+  if (font)
+    if (const unsigned glyph = font->getGlyphIndex('x'))
+      return font->getGlyphBoundingBox(glyph, context.getSize()).height;
+  return MathGraphicDevice::ex(context);
+}
+
+scaled
+OpenTypeMathGraphicDevice::axis(const FormattingContext& context) const
+{
+  if (font)
+    return font->getConstant(OpenTypeMathFont::AXIS_HEIGHT, context.getSize());
+  else
+    return MathGraphicDevice::axis(context);
+}
+
+scaled
+OpenTypeMathGraphicDevice::defaultLineThickness(const FormattingContext& context) const
+{
+  if (font)
+    return font->getConstant(OpenTypeMathFont::FRACTION_RULE_THICKNESS, context.getSize());
+  else
+    return MathGraphicDevice::defaultLineThickness(context);
+}
+
+void
+OpenTypeMathGraphicDevice::computeMetrics(const FormattingContext& context, GraphicMetrics& m) const
+{
+  if (font)
+    {
+      m.em = em(context);
+      m.ex = ex(context);
+      m.axis = axis(context);
+      m.lineThickness = defaultLineThickness(context);
+    }
+  else
+    MathGraphicDevice::computeMetrics(context, m);
+}
+
+AreaRef
+OpenTypeMathGraphicDevice::script(const FormattingContext& context,
+				  const AreaRef& base,
+				  const AreaRef& subScript, const Length& subScriptShift,
+				  const AreaRef& superScript, const Length& superScriptShift) const
+{
+  AreaRef nucleus = base;
+  while (nucleus && is_a<const BinContainerArea>(nucleus))
+    nucleus = smart_cast<const BinContainerArea>(nucleus)->getChild();
+
+  AreaRef newSuperScript = superScript;
+  if (superScript)
+    if (SmartPtr<const OpenTypeGlyphArea> glyph = smart_cast<const OpenTypeGlyphArea>(nucleus))
+      {
+	const scaled ic = glyph->getFont()->getItalicCorrection(glyph->getGlyph(), glyph->getSize());
+	if (ic != scaled::zero())
+	  {
+	    std::vector<AreaRef> c;
+	    c.reserve(2);
+	    c.push_back(getFactory()->horizontalSpace(ic));
+	    c.push_back(superScript);
+	    newSuperScript = getFactory()->horizontalArray(c);
+	  }
+      }
+
+  return MathGraphicDevice::script(context, base,
+				   subScript, subScriptShift,
+				   newSuperScript, superScriptShift);
+}
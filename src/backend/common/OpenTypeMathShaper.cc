@@ -0,0 +1,216 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cassert>
+
+#include "AbstractLogger.hh"
+#include "AreaFactory.hh"
+#include "OpenTypeGlyphArea.hh"
+#include "OpenTypeMathShaper.hh"
+#include "ShaperManager.hh"
+#include "ShapingContext.hh"
+
+#define NORMAL_FONT_INDEX     0
+#define H_STRETCHY_FONT_INDEX 1
+#define V_STRETCHY_FONT_INDEX 2
+
+OpenTypeMathShaper::OpenTypeMathShaper(const SmartPtr<AbstractLogger>& l, const SmartPtr<OpenTypeMathFont>& f)
+  : logger(l), font(f)
+{
+  assert(font);
+}
+
+OpenTypeMathShaper::~OpenTypeMathShaper()
+{ }
+
+SmartPtr<OpenTypeMathShaper>
+OpenTypeMathShaper::create(const SmartPtr<AbstractLogger>& logger, const SmartPtr<OpenTypeMathFont>& font)
+{ return new OpenTypeMathShaper(logger, font); }
+
+void
+OpenTypeMathShaper::registerShaper(const SmartPtr<ShaperManager>& sm, unsigned shaperId)
+{
+  assert(sm);
+
+  const std::vector< std::pair<Char32, unsigned> >& charMap = font->getCharMap();
+  unsigned n = 0;
+  for (std::vector< std::pair<Char32, unsigned> >::const_iterator p = charMap.begin();
+       p != charMap.end();
+       p++)
+    {
+      // the glyph index must fit in a GlyphSpec
+      if (p->first == 0 || p->first > 0x10FFFF || p->second == 0 || p->second > 0xFFFF) continue;
+
+      sm->registerChar(p->first, GlyphSpec(shaperId, NORMAL_FONT_INDEX, p->second));
+      if (font->getVerticalConstruction(p->second))
+	sm->registerStretchyChar(p->first, GlyphSpec(shaperId, V_STRETCHY_FONT_INDEX, p->second));
+      else if (font->getHorizontalConstruction(p->second))
+	sm->registerStretchyChar(p->first, GlyphSpec(shaperId, H_STRETCHY_FONT_INDEX, p->second));
+      n++;
+    }
+
+  logger->out(LOG_DEBUG, "registered %d characters from font `%s'", n, font->getFileName().c_str());
+}
+
+void
+OpenTypeMathShaper::unregisterShaper(const SmartPtr<ShaperManager>&, unsigned)
+{
+  // nothing to do
+}
+
+void
+OpenTypeMathShaper::shape(ShapingContext& context) const
+{
+  for (unsigned n = context.chunkSize(); n > 0; n--)
+    {
+      AreaRef res;
+      switch (context.getSpec().getFontId())
+	{
+	case H_STRETCHY_FONT_INDEX:
+	  res = shapeStretchyCharH(context);
+	  break;
+	case V_STRETCHY_FONT_INDEX:
+	  res = shapeStretchyCharV(context);
+	  break;
+	default:
+	  break;
+	}
+
+      if (!res) res = shapeChar(context);
+      if (!res) break;
+
+      context.pushArea(1, res);
+    }
+}
+
+AreaRef
+OpenTypeMathShaper::getGlyphArea(unsigned glyph, const scaled& size) const
+{ return OpenTypeGlyphArea::create(font, glyph, size); }
+
+AreaRef
+OpenTypeMathShaper::shapeChar(const ShapingContext& context) const
+{ return getGlyphArea(context.getSpec().getGlyphId(), context.getSize()); }
+
+bool
+OpenTypeMathShaper::assembleParts(const OpenTypeMathFont::Construction& construction,
+				  const scaled& size, const scaled& span,
+				  std::vector<const OpenTypeMathFont::Part*>& res) const
+{
+  if (construction.parts.empty()) return false;
+
+  // with r repetitions of the extenders the assembly is
+  // fixedAdvance + r * extenderAdvance long, parts overlapping by
+  // the minimum connector overlap
+  const int overlap = font->getMinConnectorOverlapValue();
+  int fixedAdvance = overlap;
+  int extenderAdvance = 0;
+  for (std::vector<OpenTypeMathFont::Part>::const_iterator p = construction.parts.begin();
+       p != construction.parts.end();
+       p++)
+    if (p->extender)
+      extenderAdvance += p->fullAdvance - overlap;
+    else
+      fixedAdvance += p->fullAdvance - overlap;
+
+  const scaled fixedSpan = font->toScaled(fixedAdvance, size);
+  const scaled extenderSpan = font->toScaled(extenderAdvance, size);
+  int r = 0;
+  if (span > fixedSpan && extenderSpan > scaled::zero())
+    r = static_cast<int>((span - fixedSpan).toFloat() / extenderSpan.toFloat()) + 1;
+
+  res.clear();
+  for (std::vector<OpenTypeMathFont::Part>::const_iterator p = construction.parts.begin();
+       p != construction.parts.end();
+       p++)
+    if (p->extender)
+      for (int i = 0; i < r; i++) res.push_back(&*p);
+    else
+      res.push_back(&*p);
+
+  return !res.empty();
+}
+
+AreaRef
+OpenTypeMathShaper::shapeStretchyCharV(const ShapingContext& context) const
+{
+  const OpenTypeMathFont::Construction* construction = font->getVerticalConstruction(context.getSpec().getGlyphId());
+  if (!construction) return 0;
+
+  const scaled size = context.getSize();
+  const scaled span = context.getVSpan() - (1 * size) / 10;
+
+  for (std::vector<OpenTypeMathFont::Variant>::const_iterator p = construction->variants.begin();
+       p != construction->variants.end();
+       p++)
+    if (font->toScaled(p->advance, size) >= span)
+      return getGlyphArea(p->glyph, size);
+
+  std::vector<const OpenTypeMathFont::Part*> parts;
+  if (!assembleParts(*construction, size, span, parts))
+    return construction->variants.empty() ? AreaRef() : getGlyphArea(construction->variants.back().glyph, size);
+
+  const SmartPtr<AreaFactory> factory = context.getFactory();
+  const AreaRef overlap = factory->verticalSpace(-font->getMinConnectorOverlap(size), scaled::zero());
+  std::vector<AreaRef> v;
+  v.reserve(2 * parts.size());
+  for (std::vector<const OpenTypeMathFont::Part*>::const_iterator p = parts.begin(); p != parts.end(); p++)
+    {
+      if (p != parts.begin()) v.push_back(overlap);
+      v.push_back(getGlyphArea((*p)->glyph, size));
+    }
+
+  return factory->glyphWrapper(factory->verticalArray(v, 0), 1);
+}
+
+AreaRef
+OpenTypeMathShaper::shapeStretchyCharH(const ShapingContext& context) const
+{
+  const OpenTypeMathFont::Construction* construction = font->getHorizontalConstruction(context.getSpec().getGlyphId());
+  if (!construction) return 0;
+
+  const scaled size = context.getSize();
+  const scaled span = context.getHSpan();
+
+  for (std::vector<OpenTypeMathFont::Variant>::const_iterator p = construction->variants.begin();
+       p != construction->variants.end();
+       p++)
+    if (font->toScaled(p->advance, size) >= span)
+      return getGlyphArea(p->glyph, size);
+
+  std::vector<const OpenTypeMathFont::Part*> parts;
+  if (!assembleParts(*construction, size, span, parts))
+    return construction->variants.empty() ? AreaRef() : getGlyphArea(construction->variants.back().glyph, size);
+
+  const SmartPtr<AreaFactory> factory = context.getFactory();
+  const AreaRef overlap = factory->horizontalSpace(-font->getMinConnectorOverlap(size));
+  std::vector<AreaRef> h;
+  h.reserve(2 * parts.size());
+  for (std::vector<const OpenTypeMathFont::Part*>::const_iterator p = parts.begin(); p != parts.end(); p++)
+    {
+      if (p != parts.begin()) h.push_back(overlap);
+      h.push_back(getGlyphArea((*p)->glyph, size));
+    }
+
+  return factory->glyphWrapper(factory->horizontalArray(h), 1);
+}
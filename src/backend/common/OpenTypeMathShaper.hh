@@ -0,0 +1,63 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __OpenTypeMathShaper_hh__
+#define __OpenTypeMathShaper_hh__
+
+#include "Shaper.hh"
+#include "OpenTypeMathFont.hh"
+
+// OpenTypeMathShaper shapes every character covered by an
+// OpenTypeMathFont. Stretchy characters pick the smallest variant
+// that covers the span or are assembled from the parts in the MATH
+// table, everything is looked up in the tables of the font
+class GMV_MathView_EXPORT OpenTypeMathShaper : public Shaper
+{
+protected:
+  OpenTypeMathShaper(const SmartPtr<class AbstractLogger>&, const SmartPtr<OpenTypeMathFont>&);
+  virtual ~OpenTypeMathShaper();
+
+public:
+  static SmartPtr<OpenTypeMathShaper> create(const SmartPtr<class AbstractLogger>&, const SmartPtr<OpenTypeMathFont>&);
+
+  virtual void registerShaper(const SmartPtr<class ShaperManager>&, unsigned);
+  virtual void unregisterShaper(const SmartPtr<class ShaperManager>&, unsigned);
+  virtual void shape(class ShapingContext&) const;
+
+  SmartPtr<OpenTypeMathFont> getFont(void) const { return font; }
+
+protected:
+  AreaRef getGlyphArea(unsigned, const scaled&) const;
+  AreaRef shapeChar(const class ShapingContext&) const;
+  AreaRef shapeStretchyCharV(const class ShapingContext&) const;
+  AreaRef shapeStretchyCharH(const class ShapingContext&) const;
+  // the parts of an assembly, with the extenders repeated enough
+  // times to cover the span
+  bool assembleParts(const OpenTypeMathFont::Construction&, const scaled&, const scaled&,
+		     std::vector<const OpenTypeMathFont::Part*>&) const;
+
+private:
+  SmartPtr<class AbstractLogger> logger;
+  SmartPtr<OpenTypeMathFont> font;
+};
+
+#endif // __OpenTypeMathShaper_hh__
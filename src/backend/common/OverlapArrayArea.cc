@@ -49,7 +49,8 @@ OverlapArrayArea::flattenAux(std::vector<AreaRef>& dest, const std::vector<AreaR
 AreaRef
 OverlapArrayArea::flatten(void) const
 {
-  std::vector<AreaRef> newContent(content.size());
+  std::vector<AreaRef> newContent;
+  newContent.reserve(content.size());
   flattenAux(newContent, content);
   if (newContent != content)
     return clone(newContent);
@@ -24,12 +24,31 @@
 #define __RenderingContext_hh__
 
 #include "gmv_defines.h"
+#include "Rectangle.hh"
 
 class GMV_MathView_EXPORT RenderingContext
 {
 public:
-  RenderingContext(void) { }
+  RenderingContext(void) : zoom(1.0f), clipping(false) { }
   virtual ~RenderingContext() { }
+
+  // the area tree is rendered scaled by the zoom factor, so that a
+  // document can be magnified without being formatted again. Only
+  // the backends able to transform their output honor it
+  void setZoom(float z) { zoom = z; }
+  float getZoom(void) const { return zoom; }
+
+  // containers skip the areas lying entirely outside the clip
+  // rectangle, which is given in the coordinates of the areas
+  void setClipRectangle(const Rectangle& r) { clip = r; clipping = true; }
+  void resetClipRectangle(void) { clipping = false; }
+  bool isVisible(const scaled& x, const scaled& y, const BoundingBox& box) const
+  { return !clipping || !box.defined() || clip.overlaps(Rectangle(x, y, box)); }
+
+private:
+  float zoom;
+  bool clipping;
+  Rectangle clip;
 };
 
 #endif // __RenderingContext_hh__
@@ -27,18 +27,17 @@
 #include "Shaper.hh"
 #include "AreaFactory.hh"
 
-AreaRef
-Shaper::composeStretchyCharH(const SmartPtr<class AreaFactory>& factory,
-			     const AreaRef& normal,
-			     const AreaRef& left, const AreaRef& glue, const AreaRef& right,
-			     const scaled& span) const
+int
+Shaper::stretchyGlueCountH(const AreaRef& normal,
+			   const AreaRef& left, const AreaRef& glue, const AreaRef& right,
+			   const scaled& span)
 {
   const scaled normalSize = normal ? normal->box().width : 0;
   const scaled leftSize = left ? left->box().width : 0;
   const scaled rightSize = right ? right->box().width : 0;
   const scaled glueSize = glue ? glue->box().width : 0;
 
-  if (normalSize >= span) return normal;
+  if (normalSize >= span) return -1;
 
   // Compute first the number of glue segments we have to use
   const int n =
@@ -48,23 +47,15 @@ Shaper::composeStretchyCharH(const SmartPtr<class AreaFactory>& factory,
 
   // Then the final number of glyphs
   const int gsN = (left ? 1 : 0) + n + (right ? 1 : 0);
-  if (gsN == 0) return normal;
-
-  std::vector<AreaRef> h;
-  h.reserve(gsN);
+  if (gsN == 0) return -1;
 
-  if (left) h.push_back(left);
-  for (int i = 0; i < n; i++) h.push_back(glue);
-  if (right) h.push_back(right);
-
-  return factory->glyphWrapper(factory->horizontalArray(h), 1);
+  return n;
 }
 
-AreaRef
-Shaper::composeStretchyCharV(const SmartPtr<class AreaFactory>& factory,
-			     const AreaRef& normal, 
-			     const AreaRef& top, const AreaRef& glue, const AreaRef& middle, const AreaRef& bottom,
-			     const scaled& span) const
+int
+Shaper::stretchyGlueCountV(const AreaRef& normal, 
+			   const AreaRef& top, const AreaRef& glue, const AreaRef& middle, const AreaRef& bottom,
+			   const scaled& span)
 {
   const scaled normalSize = normal ? normal->box().verticalExtent() : 0;
   const scaled topSize = top ? top->box().verticalExtent() : 0;
@@ -72,7 +63,7 @@ Shaper::composeStretchyCharV(const SmartPtr<class AreaFactory>& factory,
   const scaled middleSize = middle ? middle->box().verticalExtent() : 0;
   const scaled bottomSize = bottom ? bottom->box().verticalExtent() : 0;			
 
-  if (normalSize >= span) return normal;
+  if (normalSize >= span) return -1;
 
   int n =
     (glueSize > scaled::zero())
@@ -84,10 +75,39 @@ Shaper::composeStretchyCharV(const SmartPtr<class AreaFactory>& factory,
   if (n % 2 == 1 && middle) n++;
   
   const int gsN = (top ? 1 : 0) + (middle ? 1 : 0) + n + (bottom ? 1 : 0);
-  if (gsN == 0) return normal;
+  if (gsN == 0) return -1;
+
+  return n;
+}
+
+AreaRef
+Shaper::assembleStretchyCharH(const SmartPtr<class AreaFactory>& factory,
+			      const AreaRef& normal,
+			      const AreaRef& left, const AreaRef& glue, const AreaRef& right,
+			      int n) const
+{
+  if (n < 0) return normal;
+
+  std::vector<AreaRef> h;
+  h.reserve((left ? 1 : 0) + n + (right ? 1 : 0));
+
+  if (left) h.push_back(left);
+  for (int i = 0; i < n; i++) h.push_back(glue);
+  if (right) h.push_back(right);
+
+  return factory->glyphWrapper(factory->horizontalArray(h), 1);
+}
+
+AreaRef
+Shaper::assembleStretchyCharV(const SmartPtr<class AreaFactory>& factory,
+			      const AreaRef& normal, 
+			      const AreaRef& top, const AreaRef& glue, const AreaRef& middle, const AreaRef& bottom,
+			      int n) const
+{
+  if (n < 0) return normal;
 
   std::vector<AreaRef> v;
-  v.reserve(gsN);
+  v.reserve((top ? 1 : 0) + (middle ? 1 : 0) + n + (bottom ? 1 : 0));
 
   if (bottom) v.push_back(bottom);
   if (middle)
@@ -97,7 +117,7 @@ Shaper::composeStretchyCharV(const SmartPtr<class AreaFactory>& factory,
       for (int i = 0; i < n / 2; i++) v.push_back(glue);
     }
   else
-    for (unsigned i = 0; i < n; i++) v.push_back(glue);
+    for (int i = 0; i < n; i++) v.push_back(glue);
   if (top) v.push_back(top);
 
   // FIXME the 1 constant should not be hardcoded, the method
@@ -106,10 +126,34 @@ Shaper::composeStretchyCharV(const SmartPtr<class AreaFactory>& factory,
   return factory->glyphWrapper(factory->verticalArray(v, 0), 1);
 }
 
+AreaRef
+Shaper::composeStretchyCharH(const SmartPtr<class AreaFactory>& factory,
+			     const AreaRef& normal,
+			     const AreaRef& left, const AreaRef& glue, const AreaRef& right,
+			     const scaled& span) const
+{
+  return assembleStretchyCharH(factory, normal, left, glue, right,
+			       stretchyGlueCountH(normal, left, glue, right, span));
+}
+
+AreaRef
+Shaper::composeStretchyCharV(const SmartPtr<class AreaFactory>& factory,
+			     const AreaRef& normal, 
+			     const AreaRef& top, const AreaRef& glue, const AreaRef& middle, const AreaRef& bottom,
+			     const scaled& span) const
+{
+  return assembleStretchyCharV(factory, normal, top, glue, middle, bottom,
+			       stretchyGlueCountV(normal, top, glue, middle, bottom, span));
+}
+
 bool
 Shaper::isDefaultShaper() const
 { return false; }
 
+void
+Shaper::freezeCache() const
+{ }
+
 bool
 Shaper::shapeCombiningChar(const ShapingContext&) const
 { return false; }
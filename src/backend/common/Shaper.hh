@@ -36,6 +36,8 @@ public:
   virtual void unregisterShaper(const SmartPtr<class ShaperManager>&, unsigned) = 0;
   virtual void shape(class ShapingContext&) const = 0;
   virtual bool isDefaultShaper(void) const;
+  // see MathGraphicDevice::freezeCache
+  virtual void freezeCache(void) const;
 
   virtual bool shapeCombiningChar(const ShapingContext&) const;
   virtual bool computeCombiningCharOffsetsAbove(const AreaRef&, const AreaRef&,
@@ -50,6 +52,20 @@ protected:
   virtual AreaRef composeStretchyCharH(const SmartPtr<class AreaFactory>&,
 				       const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&,
 				       const scaled&) const;
+
+  // the composition of a stretchy character depends on the span only
+  // through the number of glue pieces it needs, -1 meaning that the
+  // normal glyph is large enough
+  static int stretchyGlueCountV(const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&,
+				const scaled&);
+  static int stretchyGlueCountH(const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&,
+				const scaled&);
+  AreaRef assembleStretchyCharV(const SmartPtr<class AreaFactory>&,
+				const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&,
+				int) const;
+  AreaRef assembleStretchyCharH(const SmartPtr<class AreaFactory>&,
+				const AreaRef&, const AreaRef&, const AreaRef&, const AreaRef&,
+				int) const;
 };
 
 #endif // __Shaper_hh__
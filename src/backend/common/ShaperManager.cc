@@ -37,7 +37,7 @@
 #include "GlyphArea.hh"
 
 ShaperManager::ShaperManager(const SmartPtr<AbstractLogger>& l)
-  : nextShaperId(0), logger(l), errorShaper(smart_cast<Shaper>(NullShaper::create(l)))
+  : nextShaperId(0), registeredShapers(0), logger(l), errorShaper(smart_cast<Shaper>(NullShaper::create(l)))
 {
   for (unsigned i = 0; i < MAX_SHAPERS; i++)
     shaper[i] = 0;
@@ -80,13 +80,10 @@ AreaRef
 ShaperManager::shape(const FormattingContext& ctxt,
 		     const SmartPtr<Element>& elem,
 		     const SmartPtr<AreaFactory>& factory,
-		     const UCS4String& source) const
+		     const Char32* source, UCS4String::size_type length) const
 {
-  std::vector<GlyphSpec> spec;
-  spec.reserve(source.length());
-  for (unsigned i = 0; i < source.length(); i++)
-    spec.push_back(map(source[i]));
-  ShapingContext context(elem, factory, source, spec,
+  registerPendingShapers();
+  ShapingContext context(elem, factory, source, length, *this, false,
 			 ctxt.getSize(), ctxt.getVariant(), ctxt.getMathMode());
   return shapeAux(context);
 }
@@ -95,15 +92,12 @@ AreaRef
 ShaperManager::shapeStretchy(const FormattingContext& ctxt,
 			     const SmartPtr<Element>& elem,
 			     const SmartPtr<AreaFactory>& factory,
-			     const UCS4String& source,
+			     const Char32* source, UCS4String::size_type length,
 			     const scaled& vSpan,
 			     const scaled& hSpan) const
 {
-  std::vector<GlyphSpec> spec;
-  spec.reserve(source.length());
-  for (unsigned i = 0; i < source.length(); i++)
-    spec.push_back(mapStretchy(source[i]));
-  ShapingContext context(elem, factory, source, spec,
+  registerPendingShapers();
+  ShapingContext context(elem, factory, source, length, *this, true,
 			 ctxt.getSize(), ctxt.getVariant(), ctxt.getMathMode(), vSpan, hSpan);
   return shapeAux(context);
 }
@@ -121,10 +115,29 @@ ShaperManager::registerShaper(const SmartPtr<Shaper>& s)
   if (shaperId == 0 && !s->isDefaultShaper())
     shaperId = nextShaperId++;
   shaper[shaperId] = s;
-  s->registerShaper(this, shaperId);
   return shaperId;
 }
 
+void
+ShaperManager::registerPendingShapersAux() const
+{
+  // shapers are registered in the order they were added, so that
+  // later shapers override the characters of earlier ones as they
+  // did when registration was immediate. The counter is advanced
+  // before calling the shaper because registerChar may be called
+  // from within
+  ShaperManager* self = const_cast<ShaperManager*>(this);
+  while (registeredShapers < nextShaperId)
+    {
+      const unsigned shaperId = registeredShapers++;
+      if (shaper[shaperId])
+	{
+	  logger->out(LOG_DEBUG, "registering characters of shaper %d", shaperId);
+	  shaper[shaperId]->registerShaper(self, shaperId);
+	}
+    }
+}
+
 void
 ShaperManager::unregisterShapers()
 {
@@ -133,43 +146,35 @@ ShaperManager::unregisterShapers()
   // Now, if we call unregisterShaper then the ref counter gets incremented
   // and then decremented (the parameter is a smart pointer) resulting in
   // another call to the destructor
-  for (unsigned i = 0; i < nextShaperId; i++)
+  // shapers whose characters have never been registered need not
+  // be unregistered
+  for (unsigned i = 0; i < registeredShapers; i++)
     if (shaper[i])
       shaper[i]->unregisterShaper(this, i);
 }
 
+void
+ShaperManager::freezeCache() const
+{
+  for (unsigned i = 0; i < nextShaperId; i++)
+    if (shaper[i])
+      shaper[i]->freezeCache();
+}
+
 GlyphSpec
 ShaperManager::registerChar(Char32 ch, const GlyphSpec& spec)
 {
   assert(ch <= BIGGEST_CHAR);
-  GlyphSpec oldSpec = glyphSpec[ch];
   //printf("registering %x (old spec shaper id was %d new is %d)\n", ch, oldSpec.getShaperId(), spec.getShaperId());
-  glyphSpec.set(ch, spec);
-  return oldSpec;
+  return glyphSpec.set(ch, spec);
 }
 
 GlyphSpec
 ShaperManager::registerStretchyChar(Char32 ch, const GlyphSpec& spec)
 {
   assert(ch <= BIGGEST_CHAR);
-  GlyphSpec oldSpec = glyphSpec[ch];
   //printf("registering stretchy %x (old spec shaper id was %d new is %d)\n", ch, oldSpec.getShaperId(), spec.getShaperId());
-  glyphSpec.set(ch | STRETCHY_FLAG, spec);
-  return oldSpec;
-}
-
-const GlyphSpec&
-ShaperManager::map(Char32 ch) const
-{
-  assert(ch <= BIGGEST_CHAR);
-  return glyphSpec[ch];
-}
-
-const GlyphSpec&
-ShaperManager::mapStretchy(Char32 ch) const
-{
-  assert(ch <= BIGGEST_CHAR);
-  return glyphSpec[ch | STRETCHY_FLAG];
+  return glyphSpec.set(ch | STRETCHY_FLAG, spec);
 }
 
 SmartPtr<class Shaper>
@@ -186,6 +191,7 @@ ShaperManager::compose(const FormattingContext& context,
   scaled dy = scaled::zero();
   scaled dxUnder= scaled::zero();
 
+  registerPendingShapers();
   const GlyphSpec& baseGlyphSpec = map(baseSource[0]);
   const GlyphSpec& scriptGlyphSpec = map(scriptSource[0]);
   //we control if the base char and the combining char are render
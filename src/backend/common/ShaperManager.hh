@@ -26,7 +26,7 @@
 #include "String.hh"
 #include "scaled.hh"
 #include "GlyphSpec.hh"
-#include "SparseMap.hh"
+#include "MultiStageMap.hh"
 #include "Area.hh"
 #include "Object.hh"
 #include "SmartPtr.hh"
@@ -40,41 +40,67 @@ protected:
 public:
   static SmartPtr<ShaperManager> create(const SmartPtr<class AbstractLogger>&);
 
+  SmartPtr<const class Area> shape(const class FormattingContext& ctxt,
+				   const SmartPtr<class Element>& elem,
+				   const SmartPtr<class AreaFactory>& factory,
+				   const UCS4String& source) const
+  { return shape(ctxt, elem, factory, source.data(), source.length()); }
   SmartPtr<const class Area> shape(const class FormattingContext&,
 				   const SmartPtr<class Element>&,
 				   const SmartPtr<class AreaFactory>&,
-				   const UCS4String&) const;
+				   const Char32*, UCS4String::size_type) const;
+  SmartPtr<const class Area> shapeStretchy(const class FormattingContext& ctxt,
+					   const SmartPtr<class Element>& elem,
+					   const SmartPtr<class AreaFactory>& factory,
+					   const UCS4String& source,
+					   const scaled& vSpan = 0, const scaled& hSpan = 0) const
+  { return shapeStretchy(ctxt, elem, factory, source.data(), source.length(), vSpan, hSpan); }
   SmartPtr<const class Area> shapeStretchy(const class FormattingContext&,
 					   const SmartPtr<class Element>&,
 					   const SmartPtr<class AreaFactory>&,
-					   const UCS4String&,
+					   const Char32*, UCS4String::size_type,
 					   const scaled& = 0, const scaled& = 0) const;
   
+  // registerShaper only records the shaper and assigns its id, the
+  // characters it handles are registered in the glyph map by the
+  // first operation that needs the map (shaping or composing), so
+  // that creating a backend costs nothing for the shapers that end
+  // up being unused. registerPendingShapers forces this step
   unsigned registerShaper(const SmartPtr<class Shaper>&);
+  void registerPendingShapers(void) const
+  { if (registeredShapers < nextShaperId) registerPendingShapersAux(); }
   void unregisterShapers(void);
+  void freezeCache(void) const;
   GlyphSpec registerChar(Char32 ch, const GlyphSpec& spec);
   GlyphSpec registerStretchyChar(Char32 ch, const GlyphSpec& spec);
   AreaRef compose(const FormattingContext& context,
 	          const AreaRef base, const UCS4String baseSource,
 	          const AreaRef script, const UCS4String scriptSource,
 	          bool overScript);
+  SmartPtr<class Shaper> getShaper(unsigned) const;
+
+  // the lookups assume the pending shapers have been registered
+  const GlyphSpec& map(Char32 ch) const
+  { assert(ch <= BIGGEST_CHAR); return glyphSpec[ch]; }
+  const GlyphSpec& mapStretchy(Char32 ch) const
+  { assert(ch <= BIGGEST_CHAR); return glyphSpec[ch | STRETCHY_FLAG]; }
 
 private:
-  const GlyphSpec& map(Char32 ch) const;
-  const GlyphSpec& mapStretchy(Char32 ch) const;
   SmartPtr<const class Area> shapeAux(class ShapingContext&) const;
-  SmartPtr<class Shaper> getShaper(unsigned) const;
+  void registerPendingShapersAux(void) const;
 
   static const unsigned MAX_SHAPERS = 16;
-  static const unsigned HIGH_BITS = 16;
-  static const unsigned LOW_BITS = 8;
-  static const unsigned STRETCHY_BIT = LOW_BITS + HIGH_BITS;
+  static const unsigned TOP_BITS = 10;
+  static const unsigned MID_BITS = 7;
+  static const unsigned LEAF_BITS = 7;
+  static const unsigned STRETCHY_BIT = TOP_BITS + MID_BITS + LEAF_BITS;
   static const unsigned STRETCHY_FLAG = 1 << STRETCHY_BIT;
-  static const Char32 BIGGEST_CHAR = (1 << (HIGH_BITS + 1 + LOW_BITS)) - 1;
+  static const Char32 BIGGEST_CHAR = STRETCHY_FLAG - 1;
 
-  SparseMap<GlyphSpec, HIGH_BITS + 1, LOW_BITS> glyphSpec;
+  MultiStageMap<GlyphSpec, TOP_BITS + 1, MID_BITS, LEAF_BITS> glyphSpec;
 
   unsigned nextShaperId;
+  mutable unsigned registeredShapers;
   SmartPtr<class AbstractLogger> logger;
   SmartPtr<class Shaper> errorShaper;
   SmartPtr<class Shaper> shaper[MAX_SHAPERS];
@@ -27,15 +27,19 @@
 #include "Element.hh"
 #include "AreaFactory.hh"
 #include "ShapingContext.hh"
+#include "ShaperManager.hh"
 
 ShapingContext::ShapingContext(const SmartPtr<Element>& el,
 			       const SmartPtr<AreaFactory>& f,
-			       const UCS4String& src,
-			       const std::vector<GlyphSpec>& s,
+			       const Char32* src,
+			       UCS4String::size_type len,
+			       const ShaperManager& sm,
+			       bool st,
 			       const scaled& sz,
 			       MathVariant mv, bool mm,
 			       const scaled& v, const scaled& h)
-  : element(el), factory(f), source(src), spec(s), size(sz), mathVariant(mv), mathMode(mm), vSpan(v), hSpan(h), index(0)
+  : element(el), factory(f), source(src), length(len), shaperManager(sm), stretchy(st),
+    size(sz), mathVariant(mv), mathMode(mm), vSpan(v), hSpan(h), index(0)
 { }
 
 SmartPtr<Element>
@@ -54,11 +58,8 @@ ShapingContext::chunkSize() const
   else
     {
       unsigned n = 1;
-      unsigned si = spec[index].getShaperId();
-      unsigned fi = spec[index].getFontId();
-      while (index + n < spec.size()
-	     && spec[index + n].getShaperId() == si
-	     && spec[index + n].getFontId() == fi) n++;
+      const GlyphSpec& first = getSpec();
+      while (index + n < length && getSpec(n).sameFont(first)) n++;
       return n;
     }
 }
@@ -67,21 +68,22 @@ unsigned
 ShapingContext::getShaperId() const
 {
   assert(!done());
-  return spec[index].getShaperId();
+  return getSpec().getShaperId();
 }
 
 const GlyphSpec&
 ShapingContext::getSpec(int n) const
 {
-  assert(index + n < spec.size());
-  return spec[index + n];
+  assert(index + n < length);
+  const Char32 ch = source[index + n];
+  return stretchy ? shaperManager.mapStretchy(ch) : shaperManager.map(ch);
 }
 
 const Char32*
 ShapingContext::data() const
 {
   assert(!done());
-  return source.data() + index;
+  return source + index;
 }
 
 AreaRef
@@ -95,7 +97,7 @@ ShapingContext::area() const
     else
 #endif
 
-    return factory->glyphString(res, res_n, source);
+    return factory->glyphString(res, res_n, UCS4String(source, length));
 }
 
 Char32
@@ -107,39 +109,39 @@ ShapingContext::prevChar() const
 Char32
 ShapingContext::thisChar() const
 {
-  return (index < source.length()) ? source[index] : 0;
+  return (index < length) ? source[index] : 0;
 }
 
 Char32
 ShapingContext::nextChar() const
 {
-  return (index + 1 < source.length()) ? source[index + 1] : 0;
+  return (index + 1 < length) ? source[index + 1] : 0;
 }
 
 UCS4String
 ShapingContext::prevString() const
 {
-  return source.substr(0, index);
+  return UCS4String(source, index);
 }
 
 UCS4String
 ShapingContext::prevString(UCS4String::size_type l) const
 {
   if (l > index) l = index;
-  return source.substr(index - l, l);
+  return UCS4String(source + index - l, l);
 }
 
 UCS4String
 ShapingContext::nextString() const
 {
-  return source.substr(index, source.length() - index);
+  return UCS4String(source + index, length - index);
 }
 
 UCS4String
 ShapingContext::nextString(UCS4String::size_type l) const
 {
-  if (l > source.length() - index) l = source.length() - index;
-  return source.substr(index, l);
+  if (l > length - index) l = length - index;
+  return UCS4String(source + index, l);
 }
 
 AreaRef
@@ -158,7 +160,7 @@ void
 ShapingContext::pushArea(CharIndex n, const AreaRef& area)
 {
   assert(area);
-  assert(index + n <= source.length());
+  assert(index + n <= length);
   index += n;
   res_n.push_back(n);
   res.push_back(area);
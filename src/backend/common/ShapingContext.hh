@@ -33,10 +33,15 @@
 class GMV_MathView_EXPORT ShapingContext
 {
 public:
+  // the context does not copy the source characters, they must
+  // outlive it. Glyph specs are looked up in the ShaperManager
+  // on demand, in its stretchy map if the flag is set
   ShapingContext(const SmartPtr<class Element>&,
 		 const SmartPtr<class AreaFactory>&,
-		 const UCS4String&,
-		 const std::vector<GlyphSpec>&,
+		 const Char32*,
+		 UCS4String::size_type,
+		 const class ShaperManager&,
+		 bool,
 		 const scaled&,
 		 MathVariant,
 		 bool,
@@ -46,8 +51,8 @@ public:
   bool inMathMode(void) const { return mathMode; }
   SmartPtr<class Element> getElement(void) const;
   SmartPtr<class AreaFactory> getFactory(void) const;
-  UCS4String getSource(void) const { return source; }
-  bool done(void) const { return index == source.length(); }
+  UCS4String getSource(void) const { return UCS4String(source, length); }
+  bool done(void) const { return index == length; }
   bool empty(void) const { return res.empty(); }
   scaled getSize(void) const { return size; }
   scaled getVSpan(void) const { return vSpan; }
@@ -76,8 +81,10 @@ public:
 private:
   SmartPtr<class Element> element;
   SmartPtr<class AreaFactory> factory;
-  UCS4String source;
-  std::vector<GlyphSpec> spec;
+  const Char32* source;
+  UCS4String::size_type length;
+  const class ShaperManager& shaperManager;
+  bool stretchy;
   scaled size;
   MathVariant mathVariant;
   bool mathMode;
@@ -38,11 +38,17 @@ TFMComputerModernMathGraphicDevice::~TFMComputerModernMathGraphicDevice()
 
 void
 TFMComputerModernMathGraphicDevice::setFamily(const SmartPtr<ComputerModernFamily>& f)
-{ family = f; }
+{
+  family = f;
+  clearMetrics();
+}
 
 void
 TFMComputerModernMathGraphicDevice::setTFMManager(const SmartPtr<TFMManager>& m)
-{ tfmManager = m; }
+{
+  tfmManager = m;
+  clearMetrics();
+}
 
 SmartPtr<TFMComputerModernMathGraphicDevice>
 TFMComputerModernMathGraphicDevice::create(const SmartPtr<AbstractLogger>& l)
@@ -92,6 +98,24 @@ TFMComputerModernMathGraphicDevice::axis(const FormattingContext& context) const
     return MathGraphicDevice::axis(context);
 }
 
+void
+TFMComputerModernMathGraphicDevice::computeMetrics(const FormattingContext& context, GraphicMetrics& m) const
+{
+  // all the parameters come from two fonts, each looked up once
+  const SmartPtr<TFM> sy = getTFM(context, ComputerModernFamily::FE_CMSY);
+  const SmartPtr<TFM> ex = getTFM(context, ComputerModernFamily::FE_CMEX);
+  if (sy && ex)
+    {
+      const float syScale = sy->getScale(context.getSize());
+      m.em = sy->getDimension(6) * syScale;
+      m.ex = sy->getDimension(5) * syScale;
+      m.axis = sy->getDimension(22) * syScale;
+      m.lineThickness = ex->getDimension(8) * ex->getScale(context.getSize());
+    }
+  else
+    MathGraphicDevice::computeMetrics(context, m);
+}
+
 AreaRef
 TFMComputerModernMathGraphicDevice::glyph(const class FormattingContext& context,
 					  const String& alt, const String& family,
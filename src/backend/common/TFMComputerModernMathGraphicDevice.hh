@@ -47,6 +47,7 @@ public:
 			unsigned long) const;
 
 protected:
+  virtual void computeMetrics(const class FormattingContext&, GraphicMetrics&) const;
   SmartPtr<class TFM> getTFM(const class FormattingContext&, ComputerModernFamily::FontEncId) const;
 
 private:
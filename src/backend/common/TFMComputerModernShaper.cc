@@ -26,6 +26,7 @@
 #include "TFM.hh"
 #include "TFMFont.hh"
 #include "TFMFontManager.hh"
+#include "TFMManager.hh"
 #include "TFMComputerModernShaper.hh"
 #include "AreaFactory.hh"
 #include "GlyphArea.hh"
@@ -33,7 +34,11 @@
 TFMComputerModernShaper::TFMComputerModernShaper(const SmartPtr<AbstractLogger>& l,
 						 const SmartPtr<Configuration>& conf)
   : ComputerModernShaper(l, conf)
-{ }
+{
+  for (int i = 0; i < ComputerModernFamily::FN_NOT_VALID; i++)
+    for (int j = 0; j < ComputerModernFamily::FS_NOT_VALID; j++)
+      tfmResolved[i][j] = false;
+}
 
 TFMComputerModernShaper::~TFMComputerModernShaper()
 { }
@@ -43,6 +48,13 @@ TFMComputerModernShaper::setFontManager(const SmartPtr<TFMFontManager>& fm)
 {
   assert(fm);
   tfmFontManager = fm;
+  for (int i = 0; i < ComputerModernFamily::FN_NOT_VALID; i++)
+    for (int j = 0; j < ComputerModernFamily::FS_NOT_VALID; j++)
+      {
+	tfm[i][j] = 0;
+	tfmResolved[i][j] = false;
+      }
+  clearStretchyCache();
 }
 
 SmartPtr<TFMFontManager>
@@ -130,8 +142,23 @@ TFMComputerModernShaper::getFont(ComputerModernFamily::FontNameId fontNameId,
 				 ComputerModernFamily::FontSizeId designSize, const scaled& size) const
 {
   assert(tfmFontManager);
-  return tfmFontManager->getFont(ComputerModernFamily::nameOfFont(fontNameId, designSize),
-				 size);
+  return tfmFontManager->getFont(getTFM(fontNameId, designSize), size);
+}
+
+SmartPtr<TFM>
+TFMComputerModernShaper::getTFM(ComputerModernFamily::FontNameId fontNameId,
+				ComputerModernFamily::FontSizeId designSize) const
+{
+  assert(ComputerModernFamily::validFontNameId(fontNameId));
+  assert(ComputerModernFamily::validFontSizeId(designSize));
+  assert(tfmFontManager);
+  if (!tfmResolved[fontNameId][designSize])
+    {
+      tfm[fontNameId][designSize] =
+	tfmFontManager->getTFMManager()->getTFM(ComputerModernFamily::nameOfFont(fontNameId, designSize));
+      tfmResolved[fontNameId][designSize] = true;
+    }
+  return tfm[fontNameId][designSize];
 }
 
 bool
@@ -38,6 +38,7 @@ public:
 protected:
   static ComputerModernFamily::FontNameId fontNameIdOfTFM(const SmartPtr<class TFM>&);
   virtual void postShape(class ShapingContext&) const;
+  SmartPtr<class TFM> getTFM(ComputerModernFamily::FontNameId, ComputerModernFamily::FontSizeId) const;
   virtual SmartPtr<class TFMFont> getFont(ComputerModernFamily::FontNameId,
 					  ComputerModernFamily::FontSizeId, const scaled&) const;
   virtual bool getGlyphData(const AreaRef&, SmartPtr<class TFMFont>&, UChar8&) const = 0;
@@ -46,6 +47,10 @@ protected:
   
 private:
   SmartPtr<class TFMFontManager> tfmFontManager;
+  // TFMs resolved by font and design size, so that the font name
+  // does not have to be built and looked up for every glyph
+  mutable SmartPtr<class TFM> tfm[ComputerModernFamily::FN_NOT_VALID][ComputerModernFamily::FS_NOT_VALID];
+  mutable bool tfmResolved[ComputerModernFamily::FN_NOT_VALID][ComputerModernFamily::FS_NOT_VALID];
 };
 
 
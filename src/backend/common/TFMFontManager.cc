@@ -37,6 +37,10 @@ SmartPtr<TFMFontManager>
 TFMFontManager::create(const SmartPtr<TFMManager>& tm)
 { return new TFMFontManager(tm); }
 
+SmartPtr<TFMManager>
+TFMFontManager::getTFMManager() const
+{ return tfmManager; }
+
 SmartPtr<TFMFont>
 TFMFontManager::createFont(const SmartPtr<TFM>& tfm, const scaled& size) const
 { return TFMFont::create(tfm, size); }
@@ -44,7 +48,8 @@ TFMFontManager::createFont(const SmartPtr<TFM>& tfm, const scaled& size) const
 SmartPtr<TFMFont>
 TFMFontManager::getFont(const SmartPtr<TFM>& tfm, const scaled& size) const
 {
-  const CachedFontKey key(tfm->getName(), size);
+  if (!tfm) return 0;
+  const CachedFontKey key(tfm, size);
   FontCache::iterator p = fontCache.find(key);
   if (p != fontCache.end())
     return p->second;
@@ -25,7 +25,6 @@
 
 #include "Object.hh"
 #include "String.hh"
-#include "StringHash.hh"
 #include "HashMap.hh"
 #include "SmartPtr.hh"
 #include "scaled.hh"
@@ -41,6 +40,7 @@ public:
 
   SmartPtr<class TFMFont> getFont(const SmartPtr<class TFM>&, const scaled&) const;
   SmartPtr<class TFMFont> getFont(const String&, const scaled&) const;
+  SmartPtr<class TFMManager> getTFMManager(void) const;
 
 protected:
   virtual SmartPtr<class TFMFont> createFont(const SmartPtr<class TFM>&, const scaled&) const;
@@ -48,20 +48,22 @@ protected:
 private:
   struct CachedFontKey
   {
-    CachedFontKey(const String& n, const scaled& sz)
-      : name(n), size(sz) { }
+    CachedFontKey(const class TFM* t, const scaled& sz)
+      : tfm(t), size(sz) { }
     
     bool operator==(const CachedFontKey& key) const
-    { return name == key.name && size == key.size; }
+    { return tfm == key.tfm && size == key.size; }
     
-    String name;
+    // TFMs are never released by the manager and the cached font
+    // holds a reference to its TFM, so the pointer is a valid key
+    const class TFM* tfm;
     scaled size;
   };
 
   struct CachedFontHash
   {
     size_t operator()(const CachedFontKey& key) const
-    { return StringHash()(key.name) ^ key.size.getValue(); }
+    { return reinterpret_cast<size_t>(key.tfm) ^ key.size.getValue(); }
   };
 
   typedef HASH_MAP_NS::hash_map<CachedFontKey,SmartPtr<class TFMFont>,CachedFontHash> FontCache;
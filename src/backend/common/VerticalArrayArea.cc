@@ -27,12 +27,29 @@
 #include "AreaId.hh"
 #include "Point.hh"
 #include "VerticalArrayArea.hh"
+#include "RenderingContext.hh"
 
 VerticalArrayArea::VerticalArrayArea(const std::vector<AreaRef>& children, AreaIndex r)
   : LinearContainerArea(children), refArea(r)
 {
   assert(content.size() > 0);
   assert(refArea >= 0 && refArea < content.size());
+
+  bbox = childBox(refArea);
+  refDepth = 0;
+  for (AreaIndex i = 0; i < static_cast<AreaIndex>(content.size()); i++)
+    {
+      const BoundingBox b = childBox(i);
+      if (i < refArea)
+	{
+	  bbox.over(b);
+	  if (b) refDepth += b.verticalExtent();
+	}
+      else if (i > refArea)
+	bbox.under(b);
+      else if (b)
+	refDepth += b.depth;
+    }
 }
 
 // unsigned
@@ -62,59 +79,17 @@ VerticalArrayArea::flatten(void) const
     return this;
 }
 
-BoundingBox
-VerticalArrayArea::box() const
-{
-  BoundingBox bbox = content[refArea]->box();
-  for (std::vector<AreaRef>::const_iterator p = content.begin();
-       p != content.end();
-       p++)
-    {
-      const AreaIndex i = p - content.begin();
-      if (i < refArea)
-	bbox.over((*p)->box());
-      else if (i > refArea)
-	bbox.under((*p)->box());
-    }
-  return bbox;
-}
-
-scaled
-VerticalArrayArea::prepareChildBoxes(std::vector<BoundingBox>& box) const
-{
-  box.reserve(content.size());
-  scaled depth = 0;
-  for (std::vector<AreaRef>::const_iterator p = content.begin();
-       p != content.end();
-       p++)
-    {
-      const AreaIndex i = p - content.begin();
-      box.push_back((*p)->box());
-      if (BoundingBox backBox = box.back())
-	if (i < refArea)
-	  depth += backBox.verticalExtent();
-	else if (i == refArea)
-	  depth += backBox.depth;
-    }
-
-  return depth;
-}
-
 void
 VerticalArrayArea::render(class RenderingContext& context, const scaled& x, const scaled& y0) const
 {
-  std::vector<BoundingBox> box;
-  scaled depth = prepareChildBoxes(box);
-
-  scaled y = y0 - depth;
-  for (std::vector<AreaRef>::const_iterator p = content.begin();
-       p != content.end();
-       p++)
+  scaled y = y0 - refDepth;
+  for (std::vector<AreaRef>::size_type i = 0; i < content.size(); i++)
     {
-      const AreaIndex i = p - content.begin();
-      if (box[i]) y += box[i].depth;
-      (*p)->render(context, x, y);
-      if (box[i]) y += box[i].height;
+      const BoundingBox b = childBox(i);
+      if (b) y += b.depth;
+      if (context.isVisible(x, y, b))
+	content[i]->render(context, x, y);
+      if (b) y += b.height;
     }  
 }
 
@@ -146,10 +121,9 @@ VerticalArrayArea::fit(const scaled& width, const scaled& height, const scaled&
 {
   int sw, sh, sd;
   strength(sw, sh, sd);
-  BoundingBox box0 = box();
 
-  scaled aheight = box0 ? std::max(scaled::zero(), height - box0.height) : scaled::zero();
-  scaled adepth = box0 ? std::max(scaled::zero(), depth - box0.depth) : scaled::zero();
+  scaled aheight = bbox ? std::max(scaled::zero(), height - bbox.height) : scaled::zero();
+  scaled adepth = bbox ? std::max(scaled::zero(), depth - bbox.depth) : scaled::zero();
 
   std::vector<AreaRef> newContent;
   newContent.reserve(content.size());
@@ -161,7 +135,7 @@ VerticalArrayArea::fit(const scaled& width, const scaled& height, const scaled&
 
       int pw, ph, pd;
       (*p)->strength(pw, ph, pd);
-      BoundingBox pbox = (*p)->box();
+      const BoundingBox pbox = childBox(p - content.begin());
 
       scaled pheight = pbox ? pbox.height : scaled::zero();
       scaled pdepth = pbox ? pbox.depth : scaled::zero();
@@ -194,20 +168,14 @@ VerticalArrayArea::fit(const scaled& width, const scaled& height, const scaled&
 bool
 VerticalArrayArea::searchByCoords(AreaId& id, const scaled& x, const scaled& y) const
 {
-  std::vector<BoundingBox> box;
-  scaled depth = prepareChildBoxes(box);
-
-  scaled offset = -depth;
-  for (std::vector<AreaRef>::const_iterator p = content.begin();
-       p != content.end();
-       p++)
+  scaled offset = -refDepth;
+  for (std::vector<AreaRef>::size_type i = 0; i < content.size(); i++)
     {
-      const AreaIndex i = p - content.begin();
-      offset += box[i].depth;
-      id.append(i, *p, scaled::zero(), offset);
-      if ((*p)->searchByCoords(id, x, y - offset)) return true;
+      offset += childDepth[i];
+      id.append(i, content[i], scaled::zero(), offset);
+      if (content[i]->searchByCoords(id, x, y - offset)) return true;
       id.pop_back();
-      offset += box[i].height;
+      offset += childHeight[i];
     }  
 
   return false;
@@ -232,26 +200,22 @@ VerticalArrayArea::origin(AreaIndex i, Point& point) const
   assert(i >= 0 && i < content.size());
   if (i < refArea)
     {
-      if (BoundingBox idBox = content[i]->box())
+      if (BoundingBox idBox = childBox(i))
 	point.y -= idBox.height;
-      if (BoundingBox refBox = content[refArea]->box())
+      if (BoundingBox refBox = childBox(refArea))
 	point.y -= refBox.depth;
-      for (std::vector<AreaRef>::const_iterator p = content.begin() + i + 1;
-	   p != content.begin() + refArea;
-	   p++)
-	if (BoundingBox b = (*p)->box())
+      for (AreaIndex j = i + 1; j < refArea; j++)
+	if (BoundingBox b = childBox(j))
 	  point.y -= b.verticalExtent();
     }
   else if (i > refArea)
     {
-      if (BoundingBox refBox = content[refArea]->box())
+      if (BoundingBox refBox = childBox(refArea))
 	point.y += refBox.height;
-      if (BoundingBox idBox = content[i]->box())
+      if (BoundingBox idBox = childBox(i))
 	point.y += idBox.depth;
-      for (std::vector<AreaRef>::const_iterator p = content.begin() + refArea + 1;
-	   p != content.begin() + i;
-	   p++)
-	if (BoundingBox b = (*p)->box())
+      for (AreaIndex j = refArea + 1; j < i; j++)
+	if (BoundingBox b = childBox(j))
 	  point.y += b.verticalExtent();
     }
 }
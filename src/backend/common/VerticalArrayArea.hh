@@ -39,7 +39,7 @@ public:
 
   virtual AreaRef flatten(void) const;
 
-  virtual BoundingBox box(void) const;
+  virtual BoundingBox box(void) const { return bbox; }
   virtual void render(class RenderingContext&, const scaled&, const scaled&) const;
   virtual void strength(int&, int&, int&) const;
   virtual AreaRef fit(const scaled&, const scaled&, const scaled&) const;
@@ -51,13 +51,14 @@ public:
   virtual bool searchByCoords(class AreaId&, const scaled&, const scaled&) const;
   virtual bool searchByIndex(class AreaId&, CharIndex) const;
 
-protected:
-  scaled prepareChildBoxes(std::vector<BoundingBox>&) const;
-
 private:
   //static void flattenAux(std::vector<AreaRef>&, const std::vector<AreaRef>&, unsigned);
 
   AreaIndex refArea;
+  BoundingBox bbox;
+  // distance between the baseline of the first child and that of the
+  // reference child
+  scaled refDepth;
 };
 
 #endif // __VerticalArrayArea_hh__
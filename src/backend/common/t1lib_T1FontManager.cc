@@ -29,14 +29,33 @@
 #include "t1lib_T1Font.hh"
 #include "t1lib_T1FontManager.hh"
 
-bool t1lib_T1FontManager::firstTime = true;
+unsigned t1lib_T1FontManager::libraryUsers = 0;
 
 // #include <iostream>
 
-t1lib_T1FontManager::t1lib_T1FontManager(const SmartPtr<AbstractLogger>& logger,
-					 const SmartPtr<Configuration>& configuration)
+t1lib_T1FontManager::t1lib_T1FontManager(const SmartPtr<AbstractLogger>& l,
+					 const SmartPtr<Configuration>& conf)
+  : libraryOpened(false), logger(l), configuration(conf)
+{ }
+
+t1lib_T1FontManager::~t1lib_T1FontManager()
+{
+  // the library is closed by the last manager that has used it
+  if (libraryOpened && --libraryUsers == 0)
+    {
+      const int res = T1_CloseLib();
+      assert(res == 0);
+    }
+
+  // should free the structures
+}
+
+void
+t1lib_T1FontManager::initT1Lib() const
 {
-  if (firstTime)
+  if (libraryOpened) return;
+
+  if (libraryUsers == 0)
     {
       if (getenv("T1LIB_CONFIG") == NULL)
 	{
@@ -48,18 +67,10 @@ t1lib_T1FontManager::t1lib_T1FontManager(const SmartPtr<AbstractLogger>& logger,
 
       const void* res = T1_InitLib(LOGFILE | IGNORE_FONTDATABASE);
       assert(res != 0);
-      firstTime = false;
       T1_SetLogLevel(T1LOG_DEBUG);
     }
-}
-
-t1lib_T1FontManager::~t1lib_T1FontManager()
-{
-  const int res = T1_CloseLib();
-  assert(res == 0);
-  firstTime = true;
-
-  // should free the structures
+  libraryUsers++;
+  libraryOpened = true;
 }
 
 SmartPtr<t1lib_T1FontManager>
@@ -83,6 +94,7 @@ t1lib_T1FontManager::loadFont(const String& name) const
 int
 t1lib_T1FontManager::getFontId(const String& name) const
 {
+  initT1Lib();
   const int n = T1_GetNoFonts();
   for (int i = 0; i < n; i++)
     if (name == T1_GetFontFileName(i))
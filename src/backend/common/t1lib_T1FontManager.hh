@@ -43,12 +43,19 @@ public:
   SmartPtr<class t1lib_T1Font> getT1Font(const String&, const scaled&) const;
 
 protected:
+  void initT1Lib(void) const;
   int loadFont(const String&) const;
   int getFontId(const String&) const;
   virtual SmartPtr<class t1lib_T1Font> createT1Font(const String&, const scaled&) const;
 
 private:
-  static bool firstTime;
+  // t1lib is initialized by the first font request rather than by
+  // the constructor, a backend that never uses Type1 fonts does not
+  // pay for it. libraryUsers counts the managers that have used it
+  static unsigned libraryUsers;
+  mutable bool libraryOpened;
+  SmartPtr<class AbstractLogger> logger;
+  SmartPtr<class Configuration> configuration;
 
   struct CachedT1FontKey
   {
@@ -103,30 +103,58 @@ scaled
 TFM::getGlyphItalicCorrection(UChar8 index) const
 { return scaledOfFIX(getCharacter(index).italicCorrection); }
 
+void
+TFM::setupPairs() const
+{
+  const unsigned n = font->nCharacters;
+  const Pair none = { 0, 0 };
+  pairs.assign(n * n, none);
+  for (unsigned index1 = 0; index1 < n; index1++)
+    {
+      const Character& c = getCharacter(index1);
+      assert(c.nKernings < 255 && c.nLigatures < 255);
+      // the first entry wins, as with a linear scan of the arrays
+      for (unsigned i = c.nKernings; i > 0; i--)
+	if (c.kerning[i - 1].index < n)
+	  pairs[index1 * n + c.kerning[i - 1].index].kerning = i;
+      for (unsigned i = c.nLigatures; i > 0; i--)
+	if (c.ligature[i - 1].index < n)
+	  pairs[index1 * n + c.ligature[i - 1].index].ligature = i;
+    }
+}
+
+const TFM::Pair&
+TFM::getPair(UChar8 index1, UChar8 index2) const
+{
+  static const Pair none = { 0, 0 };
+  const unsigned n = font->nCharacters;
+  assert(index1 < n);
+  if (index2 >= n) return none;
+  if (pairs.empty()) setupPairs();
+  return pairs[index1 * n + index2];
+}
+
 bool
 TFM::getGlyphKerning(UChar8 index1, UChar8 index2, scaled& result) const
 {
-  const Character& c = getCharacter(index1);
-  for (unsigned i = 0; i < c.nKernings; i++)
-    if (c.kerning[i].index == index2)
-      {
-	result = scaledOfFIX(c.kerning[i].value);
-	return true;
-      }
+  if (const unsigned i = getPair(index1, index2).kerning)
+    {
+      result = scaledOfFIX(getCharacter(index1).kerning[i - 1].value);
+      return true;
+    }
   return false;
 }
 
 bool
 TFM::getGlyphLigature(UChar8 index1, UChar8 index2, UChar8& result, UChar8& mode) const
 {
-  const Character& c = getCharacter(index1);
-  for (unsigned i = 0; i < c.nLigatures; i++)
-    if (c.ligature[i].index == index2)
-      {
-	result = c.ligature[i].result;
-	mode = c.ligature[i].mode;
-	return true;
-      }
+  if (const unsigned i = getPair(index1, index2).ligature)
+    {
+      const Ligature& ligature = getCharacter(index1).ligature[i - 1];
+      result = ligature.result;
+      mode = ligature.mode;
+      return true;
+    }
   return false;
 }
 
@@ -23,6 +23,8 @@
 #ifndef __TFM_hh__
 #define __TFM_hh__
 
+#include <vector>
+
 #include "Object.hh"
 #include "SmartPtr.hh"
 #include "scaled.hh"
@@ -109,11 +111,25 @@ protected:
   static scaled scaledOfFIX(int);
   const Character& getCharacter(UChar8) const;
 
+  // positions (plus one) of the kerning and of the ligature for a
+  // pair of characters in the per-character arrays, zero if none
+  struct Pair
+  {
+    UChar8 kerning;
+    UChar8 ligature;
+  };
+
+  const Pair& getPair(UChar8, UChar8) const;
+
 private:
+  void setupPairs(void) const;
+
   const String name;
   const Font* font;
   const Dimension* dimension;
   const Character* character;
+  // dense nCharacters x nCharacters table, built on first use
+  mutable std::vector<Pair> pairs;
 };
 
 #endif // __TFM_hh__
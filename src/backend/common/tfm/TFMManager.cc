@@ -22,9 +22,12 @@
 
 #include <config.h>
 
+#include <cassert>
+#include <cstring>
+
 #include "TFMManager.hh"
 
-#define DECLARE_TABLE(n) extern void n(TFM::Font*&, TFM::Dimension*&, TFM::Character*&);
+#define DECLARE_TABLE(n) extern void n(const TFM::Font*&, const TFM::Dimension*&, const TFM::Character*&);
 
 DECLARE_TABLE(cmr10_tables)
 DECLARE_TABLE(cmb10_tables)
@@ -42,46 +45,79 @@ DECLARE_TABLE(cmex10_tables)
 DECLARE_TABLE(msam10_tables)
 DECLARE_TABLE(msbm10_tables)
 
-TFMManager::TFMManager()
+typedef void (*TFMTables)(const TFM::Font*&, const TFM::Dimension*&, const TFM::Character*&);
+
+struct TFMTable
 {
-  static TFMTable table[] = {
-    { "cmr10", cmr10_tables },
-    { "cmb10", cmb10_tables },
-    { "cmbxti10", cmbxti10_tables },
-    { "cmti10", cmti10_tables },
-    { "cmss10", cmss10_tables },
-    { "cmssi10", cmssi10_tables },
-    { "cmssbx10", cmssbx10_tables },
-    { "cmtt10", cmtt10_tables },
-    { "cmsy10", cmsy10_tables },
-    { "cmbsy10", cmbsy10_tables },
-    { "cmmi10", cmmi10_tables },
-    { "cmmib10", cmmib10_tables },
-    { "cmex10", cmex10_tables },
-    { "msam10", msam10_tables },
-    { "msbm10", msbm10_tables },
-    { 0, 0 }
-  };
+  const char* name;
+  TFMTables tables;
+};
 
-  for (unsigned i = 0; table[i].name != 0; i++)
-    {
-      TFM::Font* font;
-      TFM::Dimension* dimension;
-      TFM::Character* character;
-      (table[i].tables)(font, dimension, character);
-      tfmCache[table[i].name] = TFM::create(table[i].name, font, dimension, character);
-    }
+// must be kept sorted by name
+static const TFMTable table[] = {
+  { "cmb10", cmb10_tables },
+  { "cmbsy10", cmbsy10_tables },
+  { "cmbxti10", cmbxti10_tables },
+  { "cmex10", cmex10_tables },
+  { "cmmi10", cmmi10_tables },
+  { "cmmib10", cmmib10_tables },
+  { "cmr10", cmr10_tables },
+  { "cmss10", cmss10_tables },
+  { "cmssbx10", cmssbx10_tables },
+  { "cmssi10", cmssi10_tables },
+  { "cmsy10", cmsy10_tables },
+  { "cmti10", cmti10_tables },
+  { "cmtt10", cmtt10_tables },
+  { "msam10", msam10_tables },
+  { "msbm10", msbm10_tables }
+};
+
+static const int N_TABLES = sizeof(table) / sizeof(table[0]);
+
+TFMManager::TFMManager()
+  : tfmCache(N_TABLES)
+{
+#ifndef NDEBUG
+  for (int i = 1; i < N_TABLES; i++)
+    assert(strcmp(table[i - 1].name, table[i].name) < 0);
+#endif // NDEBUG
 }
 
 TFMManager::~TFMManager()
 { }
 
+int
+TFMManager::indexOfTFM(const String& name)
+{
+  int first = 0;
+  int last = N_TABLES;
+  while (first < last)
+    {
+      const int middle = (first + last) / 2;
+      const int cmp = strcmp(name.c_str(), table[middle].name);
+      if (cmp == 0)
+	return middle;
+      else if (cmp < 0)
+	last = middle;
+      else
+	first = middle + 1;
+    }
+  return -1;
+}
+
 SmartPtr<TFM>
 TFMManager::getTFM(const String& name) const
 {
-  const TFMCache::const_iterator p = tfmCache.find(name);
-  if (p != tfmCache.end())
-    return p->second;
-  else
+  const int i = indexOfTFM(name);
+  if (i < 0)
     return 0;
+  else if (!tfmCache[i])
+    {
+      const TFM::Font* font;
+      const TFM::Dimension* dimension;
+      const TFM::Character* character;
+      (table[i].tables)(font, dimension, character);
+      tfmCache[i] = TFM::create(table[i].name, font, dimension, character);
+    }
+  return tfmCache[i];
 }
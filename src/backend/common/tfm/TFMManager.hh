@@ -23,11 +23,11 @@
 #ifndef __TFMManager_hh__
 #define __TFMManager_hh__
 
-#include "HashMap.hh"
+#include <vector>
+
 #include "Object.hh"
 #include "SmartPtr.hh"
 #include "String.hh"
-#include "StringHash.hh"
 #include "TFM.hh"
 #include "scaled.hh"
 
@@ -44,17 +44,12 @@ public:
   SmartPtr<class TFM> getTFM(const String&) const;
 
 protected:
-  typedef void (*TFMTables)(TFM::Font*&, TFM::Dimension*&, TFM::Character*&);
+  static int indexOfTFM(const String&);
 
 private:
-  typedef HASH_MAP_NS::hash_map<String,SmartPtr<class TFM>,StringHash> TFMCache;
-  mutable TFMCache tfmCache;  
-
-  struct TFMTable
-  {
-    const char* name;
-    TFMTables tables;
-  };
+  // TFM objects are wrapped around the static tables on first use,
+  // indexed by the position of the font in the (sorted) table
+  mutable std::vector< SmartPtr<class TFM> > tfmCache;
 };
 
 #endif // __TFMManager_hh__
@@ -36,6 +36,7 @@ void
 Gtk_ComputerModernShaper::setFontManager(const SmartPtr<Gtk_XftFontManager>& fm)
 {
   xftFontManager = fm;
+  clearStretchyCache();
 }
 
 #include <iostream>
@@ -116,22 +116,18 @@ Gtk_DefaultPangoShaper::shape(ShapingContext& context) const
 {
   const unsigned n = context.chunkSize();
   assert(n > 0);
-  // is it worth specializing this to the case when n == 1????
-  gunichar* uni_buffer = new gunichar[n];
-  for (unsigned i = 0; i < n; i++) uni_buffer[i] = context.data()[i];
-  context.pushArea(n, shapeString(context, uni_buffer, n));
-  delete [] uni_buffer;
+  // Char32 and gunichar have the same size, the source is encoded
+  // straight from the context
+  context.pushArea(n, shapeString(context, reinterpret_cast<const gunichar*>(context.data()), n));
 }
 
 AreaRef
 Gtk_DefaultPangoShaper::shapeString(const ShapingContext& context, const gunichar* uni_buffer, unsigned n) const
 {
-  glong length;
-  gchar* buffer = g_ucs4_to_utf8(uni_buffer, n, NULL, &length, NULL);
-  PangoLayout* layout = createPangoLayout(buffer, length,
+  const UTF8String buffer = UTF8StringOfUCS4String(reinterpret_cast<const Char32*>(uni_buffer), n);
+  PangoLayout* layout = createPangoLayout(buffer.data(), buffer.length(),
 					  context.getSize(),
 					  getDefaultTextAttributes());
-  g_free(buffer);
 
   SmartPtr<Gtk_AreaFactory> factory = smart_cast<Gtk_AreaFactory>(context.getFactory());
   assert(factory);
@@ -45,7 +45,10 @@ Gtk_PangoComputerModernShaper::create(const SmartPtr<AbstractLogger>& l,
 
 void
 Gtk_PangoComputerModernShaper::setPangoShaper(const SmartPtr<Gtk_DefaultPangoShaper>& shaper)
-{ pangoShaper = shaper; }
+{
+  pangoShaper = shaper;
+  clearStretchyCache();
+}
 
 SmartPtr<Gtk_DefaultPangoShaper>
 Gtk_PangoComputerModernShaper::getPangoShaper() const
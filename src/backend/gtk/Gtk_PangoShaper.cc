@@ -154,17 +154,15 @@ Gtk_PangoShaper::shapeChar(const ShapingContext& context) const
 AreaRef
 Gtk_PangoShaper::shapeChunk(const ShapingContext& context, unsigned n) const
 {
-  gunichar* uni_buffer = new gunichar[n];
+  UCS4String uni_buffer;
+  uni_buffer.reserve(n);
   for (unsigned i = 0; i < n; i++)
-    uni_buffer[i] = context.getSpec(i).getGlyphId();
+    uni_buffer.push_back(context.getSpec(i).getGlyphId());
 
-  glong length;
-  gchar* buffer = g_ucs4_to_utf8(uni_buffer, n, NULL, &length, NULL);
-  delete [] uni_buffer;
-  PangoLayout* layout = createPangoLayout(buffer, length,
+  const UTF8String buffer = UTF8StringOfUCS4String(uni_buffer);
+  PangoLayout* layout = createPangoLayout(buffer.data(), buffer.length(),
 					  context.getSize(),
 					  getTextAttributes(MathVariant(context.getSpec().getFontId() - MAPPED_BASE_INDEX + NORMAL_VARIANT)));
-  g_free(buffer);
 
   SmartPtr<Gtk_AreaFactory> factory = smart_cast<Gtk_AreaFactory>(context.getFactory());
   assert(factory);
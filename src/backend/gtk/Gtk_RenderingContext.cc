@@ -24,25 +24,29 @@
 
 #include <cassert>
 
-#include <gdk/gdkx.h>
 #if HAVE_LIBT1
-#include <t1lib.h>
-#include <t1libx.h>
 #include "t1lib_T1Font.hh"
+#include "Gtk_t1lib_T1GlyphCache.hh"
 #endif // HAVE_LIBT1
 
 #include "AbstractLogger.hh"
 #include "Gtk_RenderingContext.hh"
 
 Gtk_RenderingContext::Gtk_RenderingContext(const SmartPtr<AbstractLogger>& l)
-  : logger(l), style(NORMAL_STYLE), t1_opaque_mode(false), t1_aa_mode(false)
+  : logger(l), style(NORMAL_STYLE), t1_opaque_mode(false), t1_aa_mode(false), t1_glyph_cache(0)
 {
   assert(logger);
+#if HAVE_LIBT1
+  t1_glyph_cache = new Gtk_t1lib_T1GlyphCache();
+#endif // HAVE_LIBT1
 }
 
 Gtk_RenderingContext::~Gtk_RenderingContext()
 {
   releaseResources();
+#if HAVE_LIBT1
+  delete t1_glyph_cache;
+#endif // HAVE_LIBT1
 }
 
 void
@@ -62,20 +66,6 @@ Gtk_RenderingContext::setDrawable(const GObjectPtr<GdkDrawable>& drawable)
       for (unsigned i = 0; i < MAX_STYLE; i++)
 	data[i].gdk_gc = gdk_gc_new(gdk_drawable);
 
-#if HAVE_LIBT1
-      Display* xdisplay = GDK_DRAWABLE_XDISPLAY(drawable);
-      assert(xdisplay != NULL);
-      Colormap xcolormap = GDK_COLORMAP_XCOLORMAP(gdk_colormap);
-      GdkVisual* visual = gdk_colormap_get_visual(gdk_colormap);
-      assert(visual != NULL);
-      Visual* xvisual = GDK_VISUAL_XVISUAL(visual);
-      assert(xvisual != NULL);
-
-      T1_AASetBitsPerPixel(visual->depth);
-      logger->out(LOG_DEBUG, "t1lib: X11 depth = %d AAGetLevel = %d AAGetBitsPerPixel = %d", 
-		  visual->depth, T1_AAGetLevel(), T1_AAGetBitsPerPixel());
-      T1_SetX11Params(xdisplay, xvisual, visual->depth, xcolormap);
-#endif // HAVE_LIBT1
     }
   else
     {
@@ -84,6 +74,14 @@ Gtk_RenderingContext::setDrawable(const GObjectPtr<GdkDrawable>& drawable)
     }
 }
 
+void
+Gtk_RenderingContext::setClipRegion(const GdkRegion* region)
+{
+  for (unsigned i = 0; i < MAX_STYLE; i++)
+    if (data[i].gdk_gc)
+      gdk_gc_set_clip_region(data[i].gdk_gc, region);
+}
+
 void
 Gtk_RenderingContext::fill(const scaled& x, const scaled& y, const BoundingBox& box) const
 {
@@ -130,17 +128,78 @@ Gtk_RenderingContext::draw(const scaled& x, const scaled& y, PangoFont* font,
 
 #if HAVE_LIBT1
 void
-Gtk_RenderingContext::draw(const scaled& x, const scaled& y, const SmartPtr<t1lib_T1Font>& font, Char8 glyph) const
+Gtk_RenderingContext::draw(const scaled& x, const scaled& y, const SmartPtr<t1lib_T1Font>& font, Char8 index) const
 {
-  if (t1_aa_mode)
-    T1_AASetCharX(GDK_DRAWABLE_XID(getDrawable()),
-		  GDK_GC_XGC(getGC()), t1_opaque_mode ? T1_OPAQUE : T1_TRANSPARENT,
-		  Gtk_RenderingContext::toGtkX(x), Gtk_RenderingContext::toGtkY(y),
-		  font->getFontId(), glyph, font->getScale(), NULL);
+  Gtk_t1lib_T1GlyphCache::Glyph* glyph = t1_glyph_cache->get(font, index, t1_aa_mode);
+  if (!glyph || glyph->width == 0) return;
+
+  const int gx = Gtk_RenderingContext::toGtkX(x) + glyph->left;
+  const int gy = Gtk_RenderingContext::toGtkY(y) - glyph->top;
+  GdkGC* gc = getGC();
+  if (glyph->mask)
+    {
+      // the opaque stipple paints the background where the glyph is blank
+      gdk_gc_set_fill(gc, t1_opaque_mode ? GDK_OPAQUE_STIPPLED : GDK_STIPPLED);
+      gdk_gc_set_stipple(gc, glyph->mask);
+      gdk_gc_set_ts_origin(gc, gx, gy);
+      gdk_draw_rectangle(getDrawable(), gc, TRUE, gx, gy, glyph->width, glyph->height);
+      gdk_gc_set_fill(gc, GDK_SOLID);
+    }
   else
-    T1_SetCharX(GDK_DRAWABLE_XID(getDrawable()),
-		GDK_GC_XGC(getGC()), t1_opaque_mode ? T1_OPAQUE : T1_TRANSPARENT,
-		Gtk_RenderingContext::toGtkX(x), Gtk_RenderingContext::toGtkY(y),
-		font->getFontId(), glyph, font->getScale(), NULL);
+    {
+      if (t1_opaque_mode)
+	{
+	  const ContextData& d = data[getStyle()];
+	  gdk_gc_set_foreground(gc, &d.gdk_color[BACKGROUND_INDEX]);
+	  gdk_draw_rectangle(getDrawable(), gc, TRUE, gx, gy, glyph->width, glyph->height);
+	  gdk_gc_set_foreground(gc, &d.gdk_color[FOREGROUND_INDEX]);
+	}
+      t1_glyph_cache->paint(*glyph, data[getStyle()].color[FOREGROUND_INDEX]);
+      gdk_draw_pixbuf(getDrawable(), gc, glyph->pixbuf, 0, 0, gx, gy,
+		      glyph->width, glyph->height, GDK_RGB_DITHER_NONE, 0, 0);
+    }
+}
+#endif // HAVE_LIBT1
+
+void
+Gtk_RenderingContext::setT1GlyphCacheLimit(size_t limit)
+{
+#if HAVE_LIBT1
+  t1_glyph_cache->setLimit(limit);
+#endif // HAVE_LIBT1
 }
+
+size_t
+Gtk_RenderingContext::getT1GlyphCacheLimit() const
+{
+#if HAVE_LIBT1
+  return t1_glyph_cache->getLimit();
+#else
+  return 0;
 #endif // HAVE_LIBT1
+}
+
+void
+Gtk_RenderingContext::clearT1GlyphCache()
+{
+#if HAVE_LIBT1
+  t1_glyph_cache->clear();
+#endif // HAVE_LIBT1
+}
+
+void
+Gtk_RenderingContext::getT1GlyphCacheStats(unsigned& hits, unsigned& misses, unsigned& evictions,
+					   unsigned& entries, size_t& bytes) const
+{
+#if HAVE_LIBT1
+  const Gtk_t1lib_T1GlyphCache::Stats stats = t1_glyph_cache->getStats();
+  hits = stats.hits;
+  misses = stats.misses;
+  evictions = stats.evictions;
+  entries = stats.entries;
+  bytes = stats.bytes;
+#else
+  hits = misses = evictions = entries = 0;
+  bytes = 0;
+#endif // HAVE_LIBT1
+}
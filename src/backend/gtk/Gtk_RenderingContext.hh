@@ -61,6 +61,8 @@ public:
   void setDrawable(const GObjectPtr<GdkDrawable>&);
   GObjectPtr<GdkDrawable> getDrawable(void) const { return gdk_drawable; }
   GObjectPtr<GdkGC> getGC(void) const { return data[getStyle()].gdk_gc; }
+  // restricts drawing to a region of the drawable, 0 removes the restriction
+  void setClipRegion(const GdkRegion*);
 
   void setStyle(ColorStyle s) { style = s; }
   ColorStyle getStyle(void) const { return style; }
@@ -75,6 +77,12 @@ public:
   bool getT1OpaqueMode(void) const { return t1_opaque_mode; }
   void setT1AntiAliasedMode(bool b) { t1_aa_mode = b; }
   bool getT1AntiAliasedMode(void) const { return t1_aa_mode; }
+  // t1lib glyphs are rasterized once and then copied from a cache
+  // limited to the given number of bytes
+  void setT1GlyphCacheLimit(size_t);
+  size_t getT1GlyphCacheLimit(void) const;
+  void clearT1GlyphCache(void);
+  void getT1GlyphCacheStats(unsigned&, unsigned&, unsigned&, unsigned&, size_t&) const;
 
   static int toGtkPixels(const scaled& s)
   { return round(s * (72.27 / 72.0)).toInt(); }
@@ -165,6 +173,7 @@ protected:
   // t1lib-specific fields
   bool t1_opaque_mode;
   bool t1_aa_mode;
+  class Gtk_t1lib_T1GlyphCache* t1_glyph_cache;
 };
 
 #endif // __Gtk_RenderingContext_hh__
@@ -50,6 +50,7 @@ Gtk_T1ComputerModernShaper::setFontManager(const SmartPtr<t1lib_T1FontManager>&
 {
   assert(fm);
   t1FontManager = fm;
+  clearStretchyCache();
 }
 
 SmartPtr<t1lib_T1Font>
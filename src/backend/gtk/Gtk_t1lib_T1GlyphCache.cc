@@ -0,0 +1,213 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <t1lib.h>
+
+#include "t1lib_T1Font.hh"
+#include "Gtk_t1lib_T1GlyphCache.hh"
+
+Gtk_t1lib_T1GlyphCache::Gtk_t1lib_T1GlyphCache(size_t l)
+  : limit(l), bytes(0), hits(0), misses(0), evictions(0)
+{ }
+
+Gtk_t1lib_T1GlyphCache::~Gtk_t1lib_T1GlyphCache()
+{
+  clear();
+}
+
+void
+Gtk_t1lib_T1GlyphCache::release(Glyph* glyph) const
+{
+  assert(glyph);
+  if (glyph->mask) g_object_unref(glyph->mask);
+  if (glyph->pixbuf) g_object_unref(glyph->pixbuf);
+  delete [] glyph->coverage;
+  delete glyph;
+}
+
+void
+Gtk_t1lib_T1GlyphCache::clear()
+{
+  for (GlyphMap::iterator p = glyphMap.begin(); p != glyphMap.end(); p++)
+    release(p->second.glyph);
+  glyphMap.clear();
+  lruList.clear();
+  bytes = 0;
+}
+
+void
+Gtk_t1lib_T1GlyphCache::setLimit(size_t l)
+{
+  limit = l;
+  shrink(limit);
+}
+
+void
+Gtk_t1lib_T1GlyphCache::shrink(size_t size)
+{
+  while (bytes > size && !lruList.empty())
+    {
+      GlyphMap::iterator p = glyphMap.find(lruList.back());
+      assert(p != glyphMap.end());
+      bytes -= p->second.glyph->bytes;
+      release(p->second.glyph);
+      glyphMap.erase(p);
+      lruList.pop_back();
+      evictions++;
+    }
+}
+
+Gtk_t1lib_T1GlyphCache::Stats
+Gtk_t1lib_T1GlyphCache::getStats() const
+{
+  Stats stats;
+  stats.hits = hits;
+  stats.misses = misses;
+  stats.evictions = evictions;
+  stats.entries = glyphMap.size();
+  stats.bytes = bytes;
+  return stats;
+}
+
+Gtk_t1lib_T1GlyphCache::Glyph*
+Gtk_t1lib_T1GlyphCache::get(const SmartPtr<t1lib_T1Font>& font, Char8 index, bool aa)
+{
+  const Key key(font->getFontId(), index, font->getScale(), aa);
+  GlyphMap::iterator p = glyphMap.find(key);
+  if (p != glyphMap.end())
+    {
+      hits++;
+      lruList.splice(lruList.begin(), lruList, p->second.lru);
+      return p->second.glyph;
+    }
+
+  misses++;
+  Glyph* glyph = rasterize(key.fontId, index, key.scale, aa);
+  if (!glyph) return 0;
+
+  // the new glyph may be the only one to fit
+  shrink((glyph->bytes < limit) ? limit - glyph->bytes : 0);
+  lruList.push_front(key);
+  Entry entry;
+  entry.glyph = glyph;
+  entry.lru = lruList.begin();
+  glyphMap[key] = entry;
+  bytes += glyph->bytes;
+
+  return glyph;
+}
+
+Gtk_t1lib_T1GlyphCache::Glyph*
+Gtk_t1lib_T1GlyphCache::rasterize(int fontId, Char8 index, float scale, bool aa) const
+{
+  GLYPH* t1Glyph;
+  if (aa)
+    {
+      // with 8 bits per pixel and these gray values the anti-aliased
+      // bitmap is the coverage of each pixel
+      static unsigned long hGray[17];
+      for (unsigned i = 0; i < 17; i++) hGray[i] = (i * 255) / 16;
+      T1_AASetBitsPerPixel(8);
+      T1_AASetGrayValues(0, 64, 128, 192, 255);
+      T1_AAHSetGrayValues(hGray);
+      t1Glyph = T1_AASetChar(fontId, index, scale, 0);
+    }
+  else
+    t1Glyph = T1_SetChar(fontId, index, scale, 0);
+
+  if (!t1Glyph) return 0;
+
+  Glyph* glyph = new Glyph;
+  glyph->left = t1Glyph->metrics.leftSideBearing;
+  glyph->top = t1Glyph->metrics.ascent;
+  glyph->width = t1Glyph->metrics.rightSideBearing - t1Glyph->metrics.leftSideBearing;
+  glyph->height = t1Glyph->metrics.ascent - t1Glyph->metrics.descent;
+  glyph->mask = 0;
+  glyph->coverage = 0;
+  glyph->pixbuf = 0;
+  glyph->color = RGBColor(0, 0, 0, 0);
+  glyph->bytes = sizeof(Glyph);
+
+  if (!t1Glyph->bits || glyph->width <= 0 || glyph->height <= 0)
+    {
+      // blank glyphs are cached too, they are drawn as nothing
+      glyph->width = glyph->height = 0;
+      return glyph;
+    }
+
+  // t1lib pads each row to the bitmap pad, which is in bits
+  const int pad = T1_GetBitmapPad();
+  if (aa)
+    {
+      const int stride = ((glyph->width * 8 + pad - 1) / pad) * pad / 8;
+      glyph->coverage = new guchar[glyph->width * glyph->height];
+      for (int y = 0; y < glyph->height; y++)
+	memcpy(glyph->coverage + y * glyph->width, t1Glyph->bits + y * stride, glyph->width);
+      glyph->pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, TRUE, 8, glyph->width, glyph->height);
+      // transparent until it is painted
+      gdk_pixbuf_fill(glyph->pixbuf, 0);
+      glyph->bytes += glyph->width * glyph->height
+	+ glyph->height * gdk_pixbuf_get_rowstride(glyph->pixbuf);
+    }
+  else
+    {
+      // the bits are LSB first as in XBM data, which has rows padded
+      // to the byte
+      const int stride = ((glyph->width + pad - 1) / pad) * pad / 8;
+      const int xbmStride = (glyph->width + 7) / 8;
+      gchar* xbm = new gchar[xbmStride * glyph->height];
+      for (int y = 0; y < glyph->height; y++)
+	memcpy(xbm + y * xbmStride, t1Glyph->bits + y * stride, xbmStride);
+      glyph->mask = gdk_bitmap_create_from_data(0, xbm, glyph->width, glyph->height);
+      delete [] xbm;
+      glyph->bytes += xbmStride * glyph->height;
+    }
+
+  return glyph;
+}
+
+void
+Gtk_t1lib_T1GlyphCache::paint(Glyph& glyph, const RGBColor& color) const
+{
+  if (!glyph.pixbuf || glyph.color == color) return;
+
+  guchar* pixels = gdk_pixbuf_get_pixels(glyph.pixbuf);
+  const int rowstride = gdk_pixbuf_get_rowstride(glyph.pixbuf);
+  for (int y = 0; y < glyph.height; y++)
+    {
+      guchar* p = pixels + y * rowstride;
+      const guchar* c = glyph.coverage + y * glyph.width;
+      for (int x = 0; x < glyph.width; x++, p += 4)
+	{
+	  p[0] = color.red;
+	  p[1] = color.green;
+	  p[2] = color.blue;
+	  p[3] = (c[x] * color.alpha) / 255;
+	}
+    }
+  glyph.color = color;
+}
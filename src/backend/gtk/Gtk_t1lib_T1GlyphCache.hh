@@ -0,0 +1,126 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __Gtk_t1lib_T1GlyphCache_hh__
+#define __Gtk_t1lib_T1GlyphCache_hh__
+
+#include <list>
+
+#include <gdk/gdk.h>
+
+#include "Char.hh"
+#include "SmartPtr.hh"
+#include "RGBColor.hh"
+#include "HashMap.hh"
+
+// Gtk_t1lib_T1GlyphCache keeps the glyphs rasterized by t1lib so that
+// drawing a glyph again is a blit. Glyphs are keyed by font, index,
+// scale and anti-aliasing mode, the least recently used ones are
+// dropped when the cache goes over its memory limit. t1lib renders on
+// the pixel grid, hence there is no subpixel offset in the key
+class Gtk_t1lib_T1GlyphCache
+{
+public:
+  Gtk_t1lib_T1GlyphCache(size_t = DEFAULT_LIMIT);
+  ~Gtk_t1lib_T1GlyphCache();
+
+  static const size_t DEFAULT_LIMIT = 2 * 1024 * 1024;
+
+  // a glyph is drawn with its top-left pixel at (left, -top) from
+  // the origin. Plain glyphs are a bitmap to be used as stipple,
+  // anti-aliased glyphs are a coverage map and a pixbuf of the
+  // foreground color it was last painted with
+  struct Glyph
+  {
+    int left;
+    int top;
+    int width;
+    int height;
+    GdkBitmap* mask;
+    guchar* coverage;
+    GdkPixbuf* pixbuf;
+    RGBColor color;
+    size_t bytes;
+  };
+
+  struct Stats
+  {
+    unsigned hits;
+    unsigned misses;
+    unsigned evictions;
+    unsigned entries;
+    size_t bytes;
+  };
+
+  // returns 0 if t1lib cannot render the glyph
+  Glyph* get(const SmartPtr<class t1lib_T1Font>&, Char8, bool);
+  void paint(Glyph&, const RGBColor&) const;
+
+  void setLimit(size_t);
+  size_t getLimit(void) const { return limit; }
+  void clear(void);
+  Stats getStats(void) const;
+
+protected:
+  Glyph* rasterize(int, Char8, float, bool) const;
+  void release(Glyph*) const;
+  void shrink(size_t);
+
+  struct Key
+  {
+    Key(int f, Char8 i, float s, bool a) : fontId(f), index(i), scale(s), aa(a) { }
+
+    bool operator==(const Key& key) const
+    { return fontId == key.fontId && index == key.index && scale == key.scale && aa == key.aa; }
+
+    int fontId;
+    Char8 index;
+    float scale;
+    bool aa;
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const Key& key) const
+    { return (((key.fontId << 8) | key.index) << 1 | key.aa) ^ static_cast<size_t>(key.scale * 1024); }
+  };
+
+  typedef std::list<Key> LRUList;
+  struct Entry
+  {
+    Glyph* glyph;
+    LRUList::iterator lru;
+  };
+  typedef HASH_MAP_NS::hash_map<Key, Entry, KeyHash> GlyphMap;
+
+private:
+  size_t limit;
+  size_t bytes;
+  GlyphMap glyphMap;
+  // most recently used first
+  LRUList lruList;
+  unsigned hits;
+  unsigned misses;
+  unsigned evictions;
+};
+
+#endif // __Gtk_t1lib_T1GlyphCache_hh__
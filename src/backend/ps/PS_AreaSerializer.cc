@@ -0,0 +1,103 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "PS_AreaFactory.hh"
+#include "PS_AreaSerializer.hh"
+#include "PS_BackgroundArea.hh"
+#include "PS_TFMGlyphArea.hh"
+#if GMV_ENABLE_TFM
+#include "TFM.hh"
+#include "TFMFont.hh"
+#include "TFMFontManager.hh"
+#endif // GMV_ENABLE_TFM
+
+PS_AreaSerializer::PS_AreaSerializer(const SmartPtr<PS_AreaFactory>& factory)
+  : AreaSerializer(factory)
+{ }
+
+PS_AreaSerializer::~PS_AreaSerializer()
+{ }
+
+SmartPtr<PS_AreaSerializer>
+PS_AreaSerializer::create(const SmartPtr<PS_AreaFactory>& factory)
+{ return new PS_AreaSerializer(factory); }
+
+void
+PS_AreaSerializer::setFontManager(const SmartPtr<TFMFontManager>& fm)
+{ fontManager = fm; }
+
+bool
+PS_AreaSerializer::encode(Output& out, const AreaRef& area) const
+{
+#if GMV_ENABLE_TFM
+  if (SmartPtr<const PS_TFMGlyphArea> glyph = smart_cast<const PS_TFMGlyphArea>(area))
+    {
+      if (!fontManager) return false;
+      const SmartPtr<TFMFont> font = glyph->getFont();
+      out.putInt(T_TFM_GLYPH);
+      out.putString(font->getTFM()->getName());
+      out.putScaled(font->getSize());
+      out.putInt(static_cast<UChar8>(glyph->getIndex()));
+      return true;
+    }
+#endif // GMV_ENABLE_TFM
+
+  if (SmartPtr<const PS_BackgroundArea> background = smart_cast<const PS_BackgroundArea>(area))
+    {
+      out.putInt(T_BACKGROUND);
+      out.putRGBColor(background->getColor());
+      return encodeArea(out, background->getChild());
+    }
+  else
+    return AreaSerializer::encode(out, area);
+}
+
+AreaRef
+PS_AreaSerializer::decode(Input& in, int tag) const
+{
+  switch (tag)
+    {
+#if GMV_ENABLE_TFM
+    case T_TFM_GLYPH:
+      {
+	const String name = in.getString();
+	const scaled size = in.getScaled();
+	const Char8 index = in.getInt();
+	if (in.failed() || !fontManager) return 0;
+	if (SmartPtr<TFMFont> font = fontManager->getFont(name, size))
+	  return PS_TFMGlyphArea::create(font, index);
+	return 0;
+      }
+#endif // GMV_ENABLE_TFM
+    case T_BACKGROUND:
+      {
+	const RGBColor color = in.getRGBColor();
+	if (AreaRef area = decodeArea(in))
+	  return getFactory()->background(area, color);
+	return 0;
+      }
+    default:
+      return AreaSerializer::decode(in, tag);
+    }
+}
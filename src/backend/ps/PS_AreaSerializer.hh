@@ -20,32 +20,35 @@
 // this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
 // <http://www.gnu.org/licenses/>.
 
-#ifndef __SVG_EvalRenderingContext_hh__
-#define __SVG_EvalRenderingContext_hh__
+#ifndef __PS_AreaSerializer_hh__
+#define __PS_AreaSerializer_hh__
 
-#include "BoundingBox.hh"
-#include "StringHash.hh"
-#include "HashMap.hh"
-#include "MathView.hh"
-#include "SVG_RenderingContext.hh"
+#include "AreaSerializer.hh"
 
-class SVG_EvalRenderingContext : public SVG_RenderingContext
+class PS_AreaSerializer : public AreaSerializer
 {
+protected:
+  PS_AreaSerializer(const SmartPtr<class PS_AreaFactory>&);
+  virtual ~PS_AreaSerializer();
+
 public:
-  SVG_EvalRenderingContext(const SmartPtr<class AbstractLogger>&,
-			   const SmartPtr<MathView>&);
-  virtual ~SVG_EvalRenderingContext();
+  static SmartPtr<PS_AreaSerializer> create(const SmartPtr<class PS_AreaFactory>&);
+
+  // needed for decoding glyphs, without it glyphs are not serialized
+  void setFontManager(const SmartPtr<class TFMFontManager>&);
 
-  virtual void wrapperStart(const scaled&, const scaled&, const BoundingBox&,
-			    const SmartPtr<Element>&);
-  virtual void wrapperEnd(void);
+protected:
+  enum PS_Tag
+    {
+      T_BACKGROUND = T_BACKEND,
+      T_TFM_GLYPH
+    };
 
-  SmartPtr<class Location> getLocation(const String&) const;
+  virtual bool encode(Output&, const AreaRef&) const;
+  virtual AreaRef decode(Input&, int) const;
 
 private:
-  SmartPtr<MathView> view;
-  typedef HASH_MAP_NS::hash_map<String,SmartPtr<class Location>,StringHash,StringEq> IdMap;
-  IdMap idMap;
+  SmartPtr<class TFMFontManager> fontManager;
 };
 
-#endif // __SVG_EvalRenderingContext_hh__
+#endif // __PS_AreaSerializer_hh__
@@ -28,6 +28,7 @@
 #include "Configuration.hh"
 #include "PS_Backend.hh"
 #include "PS_AreaFactory.hh"
+#include "PS_AreaSerializer.hh"
 #include "PS_MathGraphicDevice.hh"
 #if GMV_ENABLE_BOXML
 #include "PS_BoxGraphicDevice.hh"
@@ -58,6 +59,12 @@ PS_Backend::PS_Backend(const SmartPtr<AbstractLogger>& l, const SmartPtr<Configu
   SmartPtr<TFMFontManager> fm = TFMFontManager::create(tfm);
 #endif // GMV_ENABLE_TFM
 
+  SmartPtr<PS_AreaSerializer> serializer = PS_AreaSerializer::create(factory);
+#if GMV_ENABLE_TFM
+  serializer->setFontManager(fm);
+#endif // GMV_ENABLE_TFM
+  setAreaSerializer(serializer);
+
   std::multimap<int, SmartPtr<Shaper> > shaperSet;
   if (conf->getBool(l, "ps-backend/null-shaper/enabled", false))
     shaperSet.insert(std::pair<int,SmartPtr<Shaper> >(conf->getInt(l, "ps-backend/null-shaper/priority", 0),
@@ -86,6 +93,11 @@ PS_Backend::PS_Backend(const SmartPtr<AbstractLogger>& l, const SmartPtr<Configu
 */
 #endif // GMV_ENABLE_TFM
 
+  // only the Cairo rendering context can draw OpenType glyphs, the
+  // shapers above are used instead
+  if (conf->getBool(l, "ps-backend/opentype-math-shaper/enabled", false))
+    l->out(LOG_WARNING, "the OpenType math shaper is not supported by the PostScript backend, using the other shapers");
+
 #if GMV_ENABLE_TFM
   SmartPtr<MathGraphicDevice> mgd;
   if (cmShaper)
@@ -54,10 +54,11 @@ PS_StreamRenderingContext::documentStart(const scaled& x, const scaled& y,
   appName << "MathML to PostScript - written by Luca Padovani & Nicola Rossi";
  
   header << "%!PS-Adobe-3.0 EPSF-3.0" << std::endl;
-  header << "%%BoundingBox: " << PS_RenderingContext::toPS(x) << " " 
-	 << PS_RenderingContext::toPS(y) << " " 
-         << toPS(bbox.width) << " " 
-         << toPS(bbox.verticalExtent()) << std::endl
+  const float zoom = getZoom();
+  header << "%%BoundingBox: " << PS_RenderingContext::toPS(x * zoom) << " " 
+	 << PS_RenderingContext::toPS(y * zoom) << " " 
+         << toPS(bbox.width * zoom) << " " 
+         << toPS(bbox.verticalExtent() * zoom) << std::endl
 	 << "%%Creator: " << appName.str() << std::endl
 	 << "%%CreationDate: " << asctime(localtime(&curTime))
          << "%%EndComments" << std::endl 
@@ -72,7 +73,14 @@ PS_StreamRenderingContext::documentEnd(void)
   output << header.str();
   fontDb->dumpFontTable(output);
   output << std::endl; 
+  // the zoom is applied by the interpreter, the coordinates of the
+  // areas are emitted as they were formatted
+  if (getZoom() != 1.0f)
+    output << "gsave" << std::endl
+	   << getZoom() << " " << getZoom() << " scale" << std::endl;
   output << body.str();
+  if (getZoom() != 1.0f)
+    output << "grestore" << std::endl;
   output << "showpage" << std::endl;
   output << "%%Trailer" << std::endl;
   output << "%%EOF" << std::endl;
@@ -44,10 +44,27 @@ T1_FontDataBase::T1_DataBase::T1_DataBase(String& name, int i, int initVal)
 T1_FontDataBase::T1_FontDataBase(const SmartPtr<AbstractLogger>& l,
 				 const SmartPtr<class Configuration>& conf,
 				 bool sub)
- : FontDataBase(), logger(l), subset(sub)
+ : FontDataBase(), logger(l), configuration(conf), subset(sub), initialized(false)
+{ }
+
+T1_FontDataBase::~T1_FontDataBase()
+{  
+  if (initialized)
+    {
+      int res = T1_CloseLib();
+      if (res != 0)
+	logger->out(LOG_INFO, 
+		    "t1lib could not uninitialize itself properly, please consult the log file");
+    }
+}
+
+void
+T1_FontDataBase::initT1Lib()
 {
+  if (initialized) return;
+
   int result;
-  std::vector<String> s = conf->getStringList("default/t1lib/t1-font-path");
+  std::vector<String> s = configuration->getStringList("default/t1lib/t1-font-path");
   for (std::vector<String>::iterator p = s.begin(); p != s.end(); p++)
   {
     result = T1_AddToFileSearchPath(T1_PFAB_PATH, T1_APPEND_PATH, const_cast<char*>(p->c_str()));
@@ -64,14 +81,7 @@ T1_FontDataBase::T1_FontDataBase(const SmartPtr<AbstractLogger>& l,
     logger->out(LOG_ERROR, "could not initialize t1lib");
     exit (-1);
   }
-}
-
-T1_FontDataBase::~T1_FontDataBase()
-{  
-  int res = T1_CloseLib();
-  if (res != 0)
-    logger->out(LOG_INFO, 
-	        "t1lib could not uninitialize itself properly, please consult the log file");
+  initialized = true;
 }
 
 SmartPtr<T1_FontDataBase>
@@ -83,6 +93,7 @@ T1_FontDataBase::create(const SmartPtr<AbstractLogger>& l,
 int 
 T1_FontDataBase::getFontId(const String& fontName, float fontSize)
 {
+  initT1Lib();
   int n = T1_GetNoFonts();
  
   String fileName = toLowerCase(fontName) + ".pfb";
@@ -49,8 +49,13 @@ public:
   virtual void usedChar(const String& content, const String& family);
 
 private:
+  // t1lib is set up when the first font is requested
+  void initT1Lib(void);
+
   SmartPtr<class AbstractLogger> logger;
+  SmartPtr<class Configuration> configuration;
   const bool subset;
+  bool initialized;
 
   struct T1_DataBase 
   {
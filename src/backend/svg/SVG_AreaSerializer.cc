@@ -0,0 +1,132 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "SVG_AreaFactory.hh"
+#include "SVG_AreaSerializer.hh"
+#include "SVG_BackgroundArea.hh"
+#include "SVG_TTF_TFMGlyphArea.hh"
+#include "SVG_WrapperArea.hh"
+#include "Element.hh"
+#if GMV_ENABLE_TFM
+#include "TFM.hh"
+#include "TFMFont.hh"
+#include "TFMFontManager.hh"
+#endif // GMV_ENABLE_TFM
+
+SVG_AreaSerializer::SVG_AreaSerializer(const SmartPtr<SVG_AreaFactory>& factory)
+  : AreaSerializer(factory)
+{ }
+
+SVG_AreaSerializer::~SVG_AreaSerializer()
+{ }
+
+SmartPtr<SVG_AreaSerializer>
+SVG_AreaSerializer::create(const SmartPtr<SVG_AreaFactory>& factory)
+{ return new SVG_AreaSerializer(factory); }
+
+void
+SVG_AreaSerializer::setFontManager(const SmartPtr<TFMFontManager>& fm)
+{ fontManager = fm; }
+
+bool
+SVG_AreaSerializer::encode(Output& out, const AreaRef& area) const
+{
+#if GMV_ENABLE_TFM
+  if (SmartPtr<const SVG_TFMGlyphArea> glyph = smart_cast<const SVG_TFMGlyphArea>(area))
+    {
+      if (!fontManager) return false;
+      const SmartPtr<TFMFont> font = glyph->getFont();
+      if (SmartPtr<const SVG_TTF_TFMGlyphArea> ttfGlyph = smart_cast<const SVG_TTF_TFMGlyphArea>(area))
+	{
+	  out.putInt(T_TTF_TFM_GLYPH);
+	  out.putInt(static_cast<UChar8>(ttfGlyph->getTTFIndex()));
+	}
+      else
+	out.putInt(T_TFM_GLYPH);
+      out.putString(font->getTFM()->getName());
+      out.putScaled(font->getSize());
+      out.putInt(static_cast<UChar8>(glyph->getIndex()));
+      return true;
+    }
+#endif // GMV_ENABLE_TFM
+
+  if (SmartPtr<const SVG_BackgroundArea> background = smart_cast<const SVG_BackgroundArea>(area))
+    {
+      out.putInt(T_BACKGROUND);
+      out.putRGBColor(background->getColor());
+      return encodeArea(out, background->getChild());
+    }
+  else if (SmartPtr<const SVG_WrapperArea> wrapper = smart_cast<const SVG_WrapperArea>(area))
+    {
+      out.putInt(T_WRAPPER);
+      out.putBoundingBox(wrapper->box());
+      return encodeArea(out, wrapper->getChild());
+    }
+  else
+    return AreaSerializer::encode(out, area);
+}
+
+AreaRef
+SVG_AreaSerializer::decode(Input& in, int tag) const
+{
+  switch (tag)
+    {
+#if GMV_ENABLE_TFM
+    case T_TFM_GLYPH:
+    case T_TTF_TFM_GLYPH:
+      {
+	const Char8 ttfIndex = (tag == T_TTF_TFM_GLYPH) ? in.getInt() : 0;
+	const String name = in.getString();
+	const scaled size = in.getScaled();
+	const Char8 index = in.getInt();
+	if (in.failed() || !fontManager) return 0;
+	if (SmartPtr<TFMFont> font = fontManager->getFont(name, size))
+	  {
+	    if (tag == T_TTF_TFM_GLYPH)
+	      return SVG_TTF_TFMGlyphArea::create(font, index, ttfIndex);
+	    else
+	      return SVG_TFMGlyphArea::create(font, index);
+	  }
+	return 0;
+      }
+#endif // GMV_ENABLE_TFM
+    case T_BACKGROUND:
+      {
+	const RGBColor color = in.getRGBColor();
+	if (AreaRef area = decodeArea(in))
+	  return getFactory()->background(area, color);
+	return 0;
+      }
+    case T_WRAPPER:
+      {
+	// the element is not known when the area comes from the cache
+	const BoundingBox box = in.getBoundingBox();
+	if (AreaRef area = decodeArea(in))
+	  return SVG_WrapperArea::create(area, box, 0);
+	return 0;
+      }
+    default:
+      return AreaSerializer::decode(in, tag);
+    }
+}
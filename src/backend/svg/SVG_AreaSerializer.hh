@@ -0,0 +1,56 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __SVG_AreaSerializer_hh__
+#define __SVG_AreaSerializer_hh__
+
+#include "AreaSerializer.hh"
+
+class SVG_AreaSerializer : public AreaSerializer
+{
+protected:
+  SVG_AreaSerializer(const SmartPtr<class SVG_AreaFactory>&);
+  virtual ~SVG_AreaSerializer();
+
+public:
+  static SmartPtr<SVG_AreaSerializer> create(const SmartPtr<class SVG_AreaFactory>&);
+
+  // needed for decoding glyphs, without it glyphs are not serialized
+  void setFontManager(const SmartPtr<class TFMFontManager>&);
+
+protected:
+  enum SVG_Tag
+    {
+      T_BACKGROUND = T_BACKEND,
+      T_TFM_GLYPH,
+      T_TTF_TFM_GLYPH,
+      T_WRAPPER
+    };
+
+  virtual bool encode(Output&, const AreaRef&) const;
+  virtual AreaRef decode(Input&, int) const;
+
+private:
+  SmartPtr<class TFMFontManager> fontManager;
+};
+
+#endif // __SVG_AreaSerializer_hh__
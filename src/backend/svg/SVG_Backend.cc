@@ -28,6 +28,7 @@
 #include "Configuration.hh"
 #include "SVG_Backend.hh"
 #include "SVG_AreaFactory.hh"
+#include "SVG_AreaSerializer.hh"
 #include "SVG_MathGraphicDevice.hh"
 #if GMV_ENABLE_BOXML
 #include "SVG_BoxGraphicDevice.hh"
@@ -59,6 +60,12 @@ SVG_Backend::SVG_Backend(const SmartPtr<AbstractLogger>& l, const SmartPtr<Confi
   SmartPtr<TFMFontManager> fm = TFMFontManager::create(tfm);
 #endif // GMV_ENABLE_TFM
 
+  SmartPtr<SVG_AreaSerializer> serializer = SVG_AreaSerializer::create(factory);
+#if GMV_ENABLE_TFM
+  serializer->setFontManager(fm);
+#endif // GMV_ENABLE_TFM
+  setAreaSerializer(serializer);
+
   std::multimap<int, SmartPtr<Shaper> > shaperSet;
   if (conf->getBool(l, "svg-backend/null-shaper/enabled", false))
     shaperSet.insert(std::pair<int,SmartPtr<Shaper> >(conf->getInt(l, "svg-backend/null-shaper/priority", 0),
@@ -86,6 +93,11 @@ SVG_Backend::SVG_Backend(const SmartPtr<AbstractLogger>& l, const SmartPtr<Confi
     }
 #endif // GMV_ENABLE_TFM
 
+  // only the Cairo rendering context can draw OpenType glyphs, the
+  // shapers above are used instead
+  if (conf->getBool(l, "svg-backend/opentype-math-shaper/enabled", false))
+    l->out(LOG_WARNING, "the OpenType math shaper is not supported by the SVG backend, using the other shapers");
+
 #if GMV_ENABLE_TFM
   SmartPtr<MathGraphicDevice> mgd;
   if (cmShaper)
@@ -84,16 +84,22 @@ SVG_StreamRenderingContext::beginDocument(const BoundingBox& bbox)
   output << "<?xml version=\"1.0\"?>" << std::endl;
   output << "<svg"
 	 << " version=\"1\""
-	 << " width=\"" << toSVGLength(bbox.horizontalExtent()) << "\""
-	 << " height=\"" << toSVGLength(bbox.verticalExtent()) << "\""
+	 << " width=\"" << toSVGLength(bbox.horizontalExtent() * getZoom()) << "\""
+	 << " height=\"" << toSVGLength(bbox.verticalExtent() * getZoom()) << "\""
 	 << " xmlns=\"http://www.w3.org/2000/svg\""
 	 << " xmlns:gmv=\"http://helm.cs.unibo.it/2005/GtkMathView\""
 	 << ">" << std::endl;
+  // the zoom is applied by the viewer, the coordinates of the
+  // areas are emitted as they were formatted
+  if (getZoom() != 1.0f)
+    output << "<g transform=\"scale(" << getZoom() << ")\">" << std::endl;
 }
 
 void
 SVG_StreamRenderingContext::endDocument()
 {
+  if (getZoom() != 1.0f)
+    output << "</g>" << std::endl;
   output << "</svg>" << std::endl;
 }
 
@@ -22,9 +22,12 @@
 
 #include <config.h>
 
+#include <algorithm>
+
 #include "AbstractLogger.hh"
 #include "Configuration.hh"
 #include "TemplateStringParsers.hh"
+#include "Utils.hh"
 
 std::vector<String> Configuration::configurationPaths;
 
@@ -165,6 +168,26 @@ Configuration::getRGBColor(const SmartPtr<AbstractLogger>& logger, const String&
     }
 }
 
+String
+Configuration::getDigest() const
+{
+  std::vector<String> entries;
+  entries.reserve(map.size());
+  for (Map::const_iterator p = map.begin(); p != map.end(); p++)
+    {
+      String entry = p->first;
+      for (SmartPtr<Entry> e = p->second; e; e = e->getNext())
+	entry += '\0' + e->getValue();
+      entries.push_back(entry);
+    }
+  std::sort(entries.begin(), entries.end());
+
+  String all;
+  for (std::vector<String>::const_iterator p = entries.begin(); p != entries.end(); p++)
+    all += *p + '\n';
+  return MathViewNS::digestString(all);
+}
+
 Configuration::Entry::Entry(const String& _value, const SmartPtr<Entry>& _next)
   : value(_value), next(_next)
 { }
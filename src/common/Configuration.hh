@@ -80,6 +80,8 @@ public:
   bool getBool(const SmartPtr<class AbstractLogger>&, const String&, bool) const;
   RGBColor getRGBColor(const SmartPtr<class AbstractLogger>&, const String&, const RGBColor&) const;
   Length getLength(const SmartPtr<class AbstractLogger>&, const String&, const Length&) const;
+  // digest of all keys and values, independent of insertion order
+  String getDigest(void) const;
 
 private:
   static std::vector<String> configurationPaths;
@@ -0,0 +1,262 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "AbstractLogger.hh"
+#include "ForkServer.hh"
+
+static volatile sig_atomic_t terminating = 0;
+
+static void
+onTerminate(int)
+{ terminating = 1; }
+
+// only interrupts sigsuspend, the workers are reaped by run
+static void
+onChild(int)
+{ }
+
+ForkServer::ForkServer(const SmartPtr<AbstractLogger>& l, const String& path,
+		       unsigned n, unsigned r)
+  : logger(l), socketPath(path), requestsPerWorker(r), listenFd(-1), worker(n > 0 ? n : 1, -1)
+{ }
+
+ForkServer::~ForkServer()
+{
+  if (listenFd >= 0) close(listenFd);
+}
+
+bool
+ForkServer::setupSocket()
+{
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socketPath.length() >= sizeof(addr.sun_path))
+    {
+      logger->out(LOG_ERROR, "socket path `%s' is too long", socketPath.c_str());
+      return false;
+    }
+  strcpy(addr.sun_path, socketPath.c_str());
+
+  // a socket left behind by a previous server is removed, anything
+  // else is not touched and makes bind fail
+  struct stat st;
+  if (stat(socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+    unlink(socketPath.c_str());
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0)
+    {
+      logger->out(LOG_ERROR, "could not create socket: %s", strerror(errno));
+      return false;
+    }
+
+  if (bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0
+      || listen(listenFd, SOMAXCONN) != 0)
+    {
+      logger->out(LOG_ERROR, "could not listen on `%s': %s", socketPath.c_str(), strerror(errno));
+      close(listenFd);
+      listenFd = -1;
+      return false;
+    }
+
+  return true;
+}
+
+bool
+ForkServer::readRequest(int fd, std::string& request)
+{
+  char buffer[16384];
+  for (;;)
+    {
+      const ssize_t n = read(fd, buffer, sizeof(buffer));
+      if (n == 0)
+	return true;
+      else if (n > 0)
+	{
+	  if (request.length() + n > MAX_REQUEST_SIZE) return false;
+	  request.append(buffer, n);
+	}
+      else if (errno != EINTR)
+	return false;
+    }
+}
+
+bool
+ForkServer::writeResponse(int fd, const std::string& response)
+{
+  const char* p = response.data();
+  size_t left = response.length();
+  while (left > 0)
+    {
+      const ssize_t n = write(fd, p, left);
+      if (n > 0)
+	{
+	  p += n;
+	  left -= n;
+	}
+      else if (n < 0 && errno != EINTR)
+	return false;
+    }
+  return true;
+}
+
+void
+ForkServer::serve(Handler handler, void* data)
+{
+  signal(SIGTERM, SIG_DFL);
+  signal(SIGINT, SIG_DFL);
+  signal(SIGCHLD, SIG_DFL);
+  sigprocmask(SIG_SETMASK, &savedMask, 0);
+  // a client that goes away must not kill the worker
+  signal(SIGPIPE, SIG_IGN);
+
+  unsigned served = 0;
+  while (requestsPerWorker == 0 || served < requestsPerWorker)
+    {
+      const int fd = accept(listenFd, 0, 0);
+      if (fd < 0)
+	{
+	  if (errno == EINTR || errno == ECONNABORTED) continue;
+	  logger->out(LOG_ERROR, "worker %d: accept failed: %s", getpid(), strerror(errno));
+	  _exit(1);
+	}
+
+      // a client that stalls must not keep the worker busy forever
+      struct timeval timeout;
+      timeout.tv_sec = IO_TIMEOUT;
+      timeout.tv_usec = 0;
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+      std::string request;
+      std::string response;
+      if (readRequest(fd, request) && handler(request, response, data))
+	writeResponse(fd, response);
+      else
+	logger->out(LOG_WARNING, "worker %d: could not serve request", getpid());
+      close(fd);
+      served++;
+    }
+
+  _exit(0);
+}
+
+pid_t
+ForkServer::spawn(Handler handler, void* data)
+{
+  const pid_t pid = fork();
+  if (pid == 0)
+    serve(handler, data);
+  else if (pid < 0)
+    logger->out(LOG_ERROR, "could not fork worker: %s", strerror(errno));
+  else
+    logger->out(LOG_INFO, "started worker %d", pid);
+  return pid;
+}
+
+bool
+ForkServer::run(Handler handler, void* data)
+{
+  if (!setupSocket()) return false;
+
+  // the signals are blocked except while waiting in sigsuspend, so
+  // that a signal arriving between the check of terminating and the
+  // wait is not lost
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGTERM);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &mask, &savedMask);
+
+  struct sigaction sa;
+  struct sigaction savedTerm;
+  struct sigaction savedInt;
+  struct sigaction savedChld;
+  memset(&sa, 0, sizeof(sa));
+  sigemptyset(&sa.sa_mask);
+  sa.sa_handler = onTerminate;
+  sigaction(SIGTERM, &sa, &savedTerm);
+  sigaction(SIGINT, &sa, &savedInt);
+  sa.sa_handler = onChild;
+  sigaction(SIGCHLD, &sa, &savedChld);
+
+  logger->out(LOG_INFO, "serving on `%s' with %d workers", socketPath.c_str(), static_cast<int>(worker.size()));
+  for (unsigned i = 0; i < worker.size(); i++)
+    worker[i] = spawn(handler, data);
+
+  while (!terminating)
+    {
+      int status;
+      const pid_t pid = waitpid(-1, &status, WNOHANG);
+      if (pid == 0)
+	{
+	  sigsuspend(&savedMask);
+	  continue;
+	}
+      else if (pid < 0)
+	// no worker left, and none could be forked
+	break;
+
+      for (unsigned i = 0; i < worker.size(); i++)
+	if (worker[i] == pid)
+	  {
+	    const bool failed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+	    logger->out(failed ? LOG_WARNING : LOG_INFO, "worker %d exited", pid);
+	    // do not spin if workers die as soon as they start
+	    if (failed && !terminating) sleep(1);
+	    worker[i] = terminating ? -1 : spawn(handler, data);
+	  }
+    }
+
+  for (unsigned i = 0; i < worker.size(); i++)
+    if (worker[i] > 0) kill(worker[i], SIGTERM);
+  while (waitpid(-1, 0, 0) > 0 || errno == EINTR)
+    ;
+
+  sigaction(SIGTERM, &savedTerm, 0);
+  sigaction(SIGINT, &savedInt, 0);
+  sigaction(SIGCHLD, &savedChld, 0);
+  sigprocmask(SIG_SETMASK, &savedMask, 0);
+
+  close(listenFd);
+  listenFd = -1;
+  unlink(socketPath.c_str());
+  logger->out(LOG_INFO, "server on `%s' terminated", socketPath.c_str());
+
+  return true;
+}
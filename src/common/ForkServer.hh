@@ -0,0 +1,83 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __ForkServer_hh__
+#define __ForkServer_hh__
+
+#include <sys/types.h>
+#include <signal.h>
+
+#include <string>
+#include <vector>
+
+#include "gmv_defines.h"
+#include "SmartPtr.hh"
+#include "String.hh"
+
+// ForkServer implements the "prepare then fork" mode of the command
+// line converters. The process that creates it is supposed to have
+// loaded the configuration, the dictionary and the backend and to
+// have warmed up the caches already; run() binds a UNIX socket and
+// forks a number of workers that share all this state copy-on-write.
+// Each worker accepts connections on the socket, reads a request up
+// to the end of file (the client shuts down its writing side), passes
+// it to the handler and writes back the response. Workers that exit
+// are replaced by fresh forks of the prepared process, optionally
+// after serving a given number of requests, so that the pages they
+// dirty do not accumulate
+class GMV_MathView_EXPORT ForkServer
+{
+public:
+  // returns false if the request could not be served, in which case
+  // the connection is closed with no response
+  typedef bool (*Handler)(const std::string& request, std::string& response, void* data);
+
+  ForkServer(const SmartPtr<class AbstractLogger>&, const String& socketPath,
+	     unsigned workers, unsigned requestsPerWorker = 0);
+  ~ForkServer();
+
+  // returns when the server receives SIGTERM or SIGINT, after the
+  // workers have been terminated and the socket removed, or
+  // immediately with false if the socket cannot be set up
+  bool run(Handler, void*);
+
+  static const size_t MAX_REQUEST_SIZE = 16 << 20;
+  // seconds a worker waits for a client to send or receive data
+  static const int IO_TIMEOUT = 30;
+
+protected:
+  bool setupSocket(void);
+  pid_t spawn(Handler, void*);
+  void serve(Handler, void*);
+  static bool readRequest(int, std::string&);
+  static bool writeResponse(int, const std::string&);
+
+private:
+  SmartPtr<class AbstractLogger> logger;
+  String socketPath;
+  unsigned requestsPerWorker;
+  int listenFd;
+  std::vector<pid_t> worker;
+  sigset_t savedMask;
+};
+
+#endif // __ForkServer_hh__
@@ -0,0 +1,100 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __MultiStageMap_hh__
+#define __MultiStageMap_hh__
+
+#include <cassert>
+#include <vector>
+
+#include "gmv_defines.h"
+
+// MultiStageMap maps an index of M + N + L bits to a value of type T
+// through a three-stage table. The top M bits select a middle block,
+// the following N bits select a leaf block within it and the low L
+// bits select the value within the leaf block. Blocks are allocated
+// only when a value different from T() is stored in them, the middle
+// block 0 and the leaf block 0 are shared by every unpopulated range
+// of indices. Blocks live in contiguous vectors and are referred to
+// by 16-bit offsets, so that a sparse map over the whole Unicode
+// range takes a few KB and a lookup is three dependent loads
+template <class T, int M, int N, int L>
+class GMV_MathView_EXPORT MultiStageMap
+{
+public:
+  MultiStageMap(void)
+    : top(1 << M, 0), mid(1 << N, 0), leaf(1 << L, T())
+  { }
+
+  static size_t size(void) { return size_t(1) << (M + N + L); }
+
+  const T& operator[](size_t index) const
+  {
+    assert(index < size());
+    const unsigned m = top[index >> (N + L)];
+    const unsigned l = mid[(m << N) | ((index >> L) & ((1 << N) - 1))];
+    return leaf[(l << L) | (index & ((1 << L) - 1))];
+  }
+
+  T set(size_t index, const T& v)
+  {
+    assert(index < size());
+    const unsigned i = index >> (N + L);
+    // storing T() in a shared block would not change it
+    if (top[i] == 0)
+      {
+	if (v == T()) return T();
+	assert((mid.size() >> N) < BLOCK_LIMIT);
+	top[i] = mid.size() >> N;
+	mid.resize(mid.size() + (1 << N), 0);
+      }
+    const unsigned j = (top[i] << N) | ((index >> L) & ((1 << N) - 1));
+    if (mid[j] == 0)
+      {
+	if (v == T()) return T();
+	assert((leaf.size() >> L) < BLOCK_LIMIT);
+	mid[j] = leaf.size() >> L;
+	leaf.resize(leaf.size() + (1 << L), T());
+      }
+    T& slot = leaf[(mid[j] << L) | (index & ((1 << L) - 1))];
+    const T old = slot;
+    slot = v;
+    return old;
+  }
+
+  size_t getMemoryUsage(void) const
+  {
+    return top.capacity() * sizeof(BlockIndex)
+      + mid.capacity() * sizeof(BlockIndex)
+      + leaf.capacity() * sizeof(T);
+  }
+
+private:
+  typedef unsigned short BlockIndex;
+  static const unsigned BLOCK_LIMIT = 1 << (8 * sizeof(BlockIndex));
+
+  std::vector<BlockIndex> top;
+  std::vector<BlockIndex> mid;
+  std::vector<T> leaf;
+};
+
+#endif // __MultiStageMap_hh__
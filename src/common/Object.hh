@@ -40,10 +40,16 @@ protected:
   virtual ~Object() { }
 
 public:
-  void ref(void) const { refCounter++; }
-  void unref(void) const { if (--refCounter == 0) delete this; }
+  void ref(void) const { if (refCounter != IMMORTAL) refCounter++; }
+  void unref(void) const { if (refCounter != IMMORTAL && --refCounter == 0) delete this; }
+  // an immortal object is never deleted and its reference counter is
+  // never written again, so that the pages of objects created before
+  // a fork stay shared with the child processes
+  void setImmortal(void) const { refCounter = IMMORTAL; }
+  bool immortal(void) const { return refCounter == IMMORTAL; }
 
 private:
+  static const unsigned IMMORTAL = ~0u;
   mutable unsigned refCounter;
 };
 
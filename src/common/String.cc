@@ -22,8 +22,8 @@
 
 #include <config.h>
 
-#include <glib.h>
 #include <cctype>
+#include <cstring>
 
 #include "String.hh"
 
@@ -91,6 +91,131 @@ toLowerCase(const String& s)
   return res;
 }
 
+// the bytes of a machine word that has none of these bits set are
+// all ASCII, so the text is scanned one word at a time until the
+// first byte that is not
+static const unsigned long NON_ASCII_MASK = (~0UL / 0xFF) * 0x80;
+
+static const Char32 REPLACEMENT_CHAR = 0xFFFD;
+
+// decodes the sequence starting at p, returns the number of bytes it
+// takes or 0 if it is malformed
+static inline unsigned
+decodeUTF8(const unsigned char* p, const unsigned char* end, Char32& ch)
+{
+  const unsigned c = p[0];
+  if (c < 0x80)
+    {
+      ch = c;
+      return 1;
+    }
+  else if (c < 0xC2)
+    return 0;
+  else if (c < 0xE0)
+    {
+      if (end - p < 2 || (p[1] & 0xC0) != 0x80) return 0;
+      ch = ((c & 0x1F) << 6) | (p[1] & 0x3F);
+      return 2;
+    }
+  else if (c < 0xF0)
+    {
+      if (end - p < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) return 0;
+      ch = ((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+      // overlong forms and surrogates
+      if (ch < 0x800 || (ch >= 0xD800 && ch <= 0xDFFF)) return 0;
+      return 3;
+    }
+  else if (c < 0xF5)
+    {
+      if (end - p < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) return 0;
+      ch = ((c & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+      if (ch < 0x10000 || ch > 0x10FFFF) return 0;
+      return 4;
+    }
+  else
+    return 0;
+}
+
+static inline bool
+isASCIIWord(const unsigned char* p)
+{
+  unsigned long w;
+  memcpy(&w, p, sizeof(w));
+  return (w & NON_ASCII_MASK) == 0;
+}
+
+UCS4String
+UCS4StringOfUTF8String(const Char8* s, size_t n)
+{
+  // there are never more characters than bytes
+  UCS4String res(n, 0);
+  if (n == 0) return res;
+
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+  const unsigned char* end = p + n;
+  Char32* out = &res[0];
+  while (p < end)
+    {
+      while (end - p >= static_cast<long>(sizeof(unsigned long)) && isASCIIWord(p))
+	for (unsigned i = 0; i < sizeof(unsigned long); i++)
+	  *out++ = *p++;
+      if (p == end) break;
+      if (const unsigned l = decodeUTF8(p, end, *out))
+	p += l;
+      else
+	{
+	  *out = REPLACEMENT_CHAR;
+	  p++;
+	}
+      out++;
+    }
+
+  res.resize(out - &res[0]);
+  return res;
+}
+
+UTF8String
+UTF8StringOfUCS4String(const Char32* s, size_t n)
+{
+  UTF8String res;
+  res.reserve(n);
+  for (const Char32* end = s + n; s != end; s++)
+    {
+      Char32 ch = *s;
+      if (ch < 0x80)
+	res.push_back(ch);
+      else
+	{
+	  if (ch > 0x10FFFF || (ch >= 0xD800 && ch <= 0xDFFF)) ch = REPLACEMENT_CHAR;
+
+	  Char8 buffer[4];
+	  unsigned l;
+	  if (ch < 0x800)
+	    {
+	      buffer[0] = 0xC0 | (ch >> 6);
+	      l = 2;
+	    }
+	  else if (ch < 0x10000)
+	    {
+	      buffer[0] = 0xE0 | (ch >> 12);
+	      buffer[1] = 0x80 | ((ch >> 6) & 0x3F);
+	      l = 3;
+	    }
+	  else
+	    {
+	      buffer[0] = 0xF0 | (ch >> 18);
+	      buffer[1] = 0x80 | ((ch >> 12) & 0x3F);
+	      buffer[2] = 0x80 | ((ch >> 6) & 0x3F);
+	      l = 4;
+	    }
+	  buffer[l - 1] = 0x80 | (ch & 0x3F);
+	  res.append(buffer, l);
+	}
+    }
+  return res;
+}
+
+#if 0
 template <typename DEST_CHAR, typename SOURCE_CHAR, typename DEST_STRING, typename SOURCE_STRING, 
 	  DEST_CHAR* (*f)(const SOURCE_CHAR*, glong, glong*, glong*, GError**)>
 DEST_STRING
@@ -105,15 +230,6 @@ DESTofSOURCE(const SOURCE_STRING& s)
   return res;
 }
 
-UTF8String
-UTF8StringOfUCS4String(const UCS4String& s)
-{ return DESTofSOURCE<gchar, gunichar, UTF8String, UCS4String, &g_ucs4_to_utf8>(s); }
-
-UCS4String
-UCS4StringOfUTF8String(const UTF8String& s)
-{ return DESTofSOURCE<gunichar, gchar, UCS4String, UTF8String, &g_utf8_to_ucs4>(s); }
-
-#if 0
 UTF16String
 UTF16StringOfUCS4String(const UCS4String& s)
 { return DESTofSOURCE<gunichar2, gunichar, UTF16String, UCS4String, &g_ucs4_to_utf16>(s); }
@@ -41,8 +41,15 @@ GMV_MathView_EXPORT String collapseSpaces(const String&);
 GMV_MathView_EXPORT String deleteSpaces(const String&);
 GMV_MathView_EXPORT String toLowerCase(const String&);
 
-GMV_MathView_EXPORT UTF8String UTF8StringOfUCS4String(const UCS4String&);
-GMV_MathView_EXPORT UCS4String UCS4StringOfUTF8String(const UTF8String&);
+// malformed UTF-8 sequences and invalid code points are replaced
+// with U+FFFD
+GMV_MathView_EXPORT UTF8String UTF8StringOfUCS4String(const Char32*, size_t);
+GMV_MathView_EXPORT UCS4String UCS4StringOfUTF8String(const Char8*, size_t);
+
+inline GMV_MathView_EXPORT UTF8String UTF8StringOfUCS4String(const UCS4String& s)
+{ return UTF8StringOfUCS4String(s.data(), s.length()); }
+inline GMV_MathView_EXPORT UCS4String UCS4StringOfUTF8String(const UTF8String& s)
+{ return UCS4StringOfUTF8String(s.data(), s.length()); }
 #if 0
 GMV_MathView_EXPORT UTF16String UTF16StringOfUCS4String(const UCS4String&);
 GMV_MathView_EXPORT UCS4String UCS4StringOfUTF16String(const UTF16String&);
@@ -32,5 +32,15 @@ bool
 fileExists(const char* fileName)
 { return g_file_test(fileName, G_FILE_TEST_EXISTS); }
 
+String
+digestString(const String& s)
+{
+  gchar* digest = g_compute_checksum_for_data(G_CHECKSUM_SHA256,
+					      reinterpret_cast<const guchar*>(s.data()), s.length());
+  const String res(digest);
+  g_free(digest);
+  return res;
+}
+
 }
 
@@ -24,10 +24,13 @@
 #define __Utils_hh__
 
 #include "gmv_defines.h"
+#include "String.hh"
 
 namespace MathViewNS {
 
 GMV_MathView_EXPORT bool fileExists(const char*);
+// SHA-256 digest of the string as 64 hex digits
+GMV_MathView_EXPORT String digestString(const String&);
 
 }
 
@@ -27,10 +27,10 @@
 #include "MathVariant.hh"
 #include "MathVariantMap.hh"
 
-#define MAP_NAME(n) map_variant_##n
-#define DECLARE_MAP(n) Char32 MAP_NAME(n)(Char32);
+#include "MathVariantTable.hh"
 
-typedef Char32 (*mapType)(Char32);
+#define MAP_NAME(n) map_variant_##n
+#define DECLARE_MAP(n) extern const MathVariantTable MAP_NAME(n);
 
 DECLARE_MAP(bold)
 DECLARE_MAP(italic)
@@ -46,40 +46,49 @@ DECLARE_MAP(sans_serif_italic)
 DECLARE_MAP(sans_serif_bold_italic)
 DECLARE_MAP(monospace)
 
-static Char32 map_variant_normal(Char32 ch)
-{ return ch; }
+static const UChar8 index_normal[] = { 0 };
+static const Char32 delta_normal[MathVariantTable::BLOCK_SIZE] = { 0 };
+static const MathVariantTable map_variant_normal = { 0, index_normal, delta_normal };
 
-static mapType map[] =
+static const MathVariantTable* const map[] =
 {
-  MAP_NAME(normal),
-  MAP_NAME(bold),
-  MAP_NAME(italic),
-  MAP_NAME(bold_italic),
-  MAP_NAME(double_struck),
-  MAP_NAME(bold_fraktur),
-  MAP_NAME(script),
-  MAP_NAME(bold_script),
-  MAP_NAME(fraktur),
-  MAP_NAME(sans_serif),
-  MAP_NAME(bold_sans_serif),
-  MAP_NAME(sans_serif_italic),
-  MAP_NAME(sans_serif_bold_italic),
-  MAP_NAME(monospace)
+  &MAP_NAME(normal),
+  &MAP_NAME(bold),
+  &MAP_NAME(italic),
+  &MAP_NAME(bold_italic),
+  &MAP_NAME(double_struck),
+  &MAP_NAME(bold_fraktur),
+  &MAP_NAME(script),
+  &MAP_NAME(bold_script),
+  &MAP_NAME(fraktur),
+  &MAP_NAME(sans_serif),
+  &MAP_NAME(bold_sans_serif),
+  &MAP_NAME(sans_serif_italic),
+  &MAP_NAME(sans_serif_bold_italic),
+  &MAP_NAME(monospace)
 };
 
 Char32
 mapMathVariant(MathVariant variant, Char32 ch)
 {
   assert(variant >= NORMAL_VARIANT && variant <= MONOSPACE_VARIANT);
-  return map[variant - NORMAL_VARIANT](ch);
+  return map[variant - NORMAL_VARIANT]->map(ch);
 }
 
 void
-mapMathVariant(MathVariant variant, UCS4String& str)
+mapMathVariant(MathVariant variant, Char32* str, size_t length)
 {
   assert(variant >= NORMAL_VARIANT && variant <= MONOSPACE_VARIANT);
-  mapType m = map[variant - NORMAL_VARIANT];
+  if (variant == NORMAL_VARIANT) return;
+
+  const MathVariantTable& m = *map[variant - NORMAL_VARIANT];
+  for (size_t i = 0; i < length; i++)
+    str[i] = m.map(str[i]);
+}
 
-  for (UCS4String::iterator p = str.begin(); p != str.end(); p++)
-    *p = m(*p);
+void
+mapMathVariant(MathVariant variant, UCS4String& str)
+{
+  if (variant != NORMAL_VARIANT && !str.empty())
+    mapMathVariant(variant, &str[0], str.length());
 }
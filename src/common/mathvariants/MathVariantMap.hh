@@ -27,6 +27,7 @@
 #include "MathVariant.hh"
 
 GMV_MathView_EXPORT Char32 mapMathVariant(MathVariant, Char32);
+GMV_MathView_EXPORT void mapMathVariant(MathVariant, Char32*, size_t);
 GMV_MathView_EXPORT void mapMathVariant(MathVariant, UCS4String&);
 
 #endif // __MathVariantMap_hh__
@@ -0,0 +1,50 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __MathVariantTable_hh__
+#define __MathVariantTable_hh__
+
+#include "Char.hh"
+
+// MathVariantTable is the two-level lookup table generated by
+// extract.xsl for each variant. The code of a character selects a
+// block through index, and the block holds the offset to be added
+// to the character in order to get the mapped one (0 for characters
+// that have no mapping). Characters beyond the last mapped block are
+// clamped onto index[limit], which always refers to the empty block
+struct MathVariantTable
+{
+  enum { BLOCK_SHIFT = 6, BLOCK_SIZE = 1 << BLOCK_SHIFT };
+
+  unsigned limit;
+  const UChar8* index;
+  const Char32* delta;
+
+  Char32 map(Char32 ch) const
+  {
+    const unsigned i = static_cast<unsigned>(ch) >> BLOCK_SHIFT;
+    const unsigned b = index[(i < limit) ? i : limit];
+    return ch + delta[(b << BLOCK_SHIFT) | (ch & (BLOCK_SIZE - 1))];
+  }
+};
+
+#endif // __MathVariantTable_hh__
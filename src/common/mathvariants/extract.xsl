@@ -4,12 +4,8 @@
   xmlns:xh="http://www.w3.org/1999/xhtml"
 >
 
-<xsl:param name="temp" select="true()"/>
-
 <xsl:output method="text" />
 
-<xsl:param name="variant" />
-
 <xsl:template match="/">
 #include &lt;Char.hh&gt;
 
@@ -30,28 +26,93 @@ static TableEntry table[] =
   </xsl:apply-templates>  { 0, 0 }
 };
 
-<xsl:if test="$temp">
 #include &lt;cstdio&gt;
 
+// must agree with MathVariantTable.hh
+#define BLOCK_SHIFT 6
+#define BLOCK_SIZE (1 &lt;&lt; BLOCK_SHIFT)
+#define MAX_BLOCKS 256
+
+static Char32 block[MAX_BLOCKS][BLOCK_SIZE];
+static unsigned blockIndex[(0x10000 &gt;&gt; BLOCK_SHIFT) + 1];
+
 int
-main()
+main(int argc, char* argv[])
 {
-  unsigned i = 0;
-  
-  while (table[i].normal != 0)
-  {
-    unsigned i0 = i;
-    while (table[i].normal == table[i + 1].normal - 1) i++;
-    if (i0 == i)
-      printf("  if (ch == 0x%04X) return 0x%04X;\n", table[i].normal, table[i].variant);
-    else
-      printf("  if (ch &gt;= 0x%04X and ch &lt;= 0x%04X) return table[ch - 0x%04X].variant;\n", table[i0].normal, table[i].normal, table[i0].normal - i0);
-    i++;
-  }
+  if (argc != 2)
+    {
+      fprintf(stderr, "usage: %s name\n", argv[0]);
+      return 1;
+    }
+
+  const char* name = argv[1];
+
+  unsigned maxNormal = 0;
+  for (unsigned i = 0; table[i].normal != 0; i++)
+    if (table[i].normal &gt; maxNormal) maxNormal = table[i].normal;
+
+  // the second-level table stores, for every character, the offset
+  // that must be added to it in order to get the mapped character.
+  // Block 0 is all zeroes and is shared by all the blocks with no
+  // mapped character, including the sentinel at index[limit]
+  const unsigned limit = (maxNormal &gt;&gt; BLOCK_SHIFT) + 1;
+  unsigned nBlocks = 1;
+  for (unsigned b = 0; b &lt; limit; b++)
+    {
+      Char32 tmp[BLOCK_SIZE];
+      bool empty = true;
+      for (unsigned j = 0; j &lt; BLOCK_SIZE; j++)
+	tmp[j] = 0;
+      for (unsigned i = 0; table[i].normal != 0; i++)
+	if ((table[i].normal &gt;&gt; BLOCK_SHIFT) == b)
+	  {
+	    tmp[table[i].normal &amp; (BLOCK_SIZE - 1)] = table[i].variant - table[i].normal;
+	    empty = false;
+	  }
+
+      unsigned k = 0;
+      if (!empty)
+	{
+	  for (k = 1; k &lt; nBlocks; k++)
+	    {
+	      unsigned j = 0;
+	      while (j &lt; BLOCK_SIZE &amp;&amp; block[k][j] == tmp[j]) j++;
+	      if (j == BLOCK_SIZE) break;
+	    }
+	  if (k == nBlocks)
+	    {
+	      if (nBlocks == MAX_BLOCKS)
+		{
+		  fprintf(stderr, "%s: too many blocks\n", argv[0]);
+		  return 1;
+		}
+	      for (unsigned j = 0; j &lt; BLOCK_SIZE; j++)
+		block[k][j] = tmp[j];
+	      nBlocks++;
+	    }
+	}
+      blockIndex[b] = k;
+    }
+  blockIndex[limit] = 0;
+
+  printf("#include \"MathVariantTable.hh\"\n\n");
+
+  printf("static const UChar8 index_%s[] =\n{", name);
+  for (unsigned b = 0; b &lt;= limit; b++)
+    printf("%s%u,", (b % 16 == 0) ? "\n  " : " ", blockIndex[b]);
+  printf("\n};\n\n");
+
+  printf("static const Char32 delta_%s[] =\n{", name);
+  for (unsigned k = 0; k &lt; nBlocks; k++)
+    for (unsigned j = 0; j &lt; BLOCK_SIZE; j++)
+      printf("%s0x%05X,", (j % 8 == 0) ? "\n  " : " ", block[k][j]);
+  printf("\n};\n\n");
+
+  printf("extern const MathVariantTable map_variant_%s = { %u, index_%s, delta_%s };\n",
+	 name, limit, name, name);
 
   return 0;
 }
-</xsl:if>
 
 </xsl:template>
 
@@ -48,6 +48,7 @@ BoxMLActionElement::format(FormattingContext& ctxt)
   if (dirtyLayout())
     {
       ctxt.push(this);
+      setWidthDependent();
 
       if (SmartPtr<Value> value = GET_ATTRIBUTE_VALUE(BoxML, Action, selection))
 	selection = ToInteger(value) - 1;
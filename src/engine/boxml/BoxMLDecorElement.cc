@@ -92,11 +92,12 @@ BoxMLDecorElement::format(FormattingContext& ctxt)
   if (dirtyLayout())
     {
       ctxt.push(this);
+      setWidthDependent();
 
       SmartPtr<ValueSequence> type = ToSequence(GET_ATTRIBUTE_VALUE(BoxML, Decor, type));
       SmartPtr<Value> color = GET_ATTRIBUTE_VALUE(BoxML, Decor, color);
       const scaled thickness = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, Decor, thickness)),
-							  ctxt.BGD()->defaultLineThickness(ctxt));
+							  ctxt.BGD()->metrics(ctxt).lineThickness);
       RGBColor col;
       if (color && IsTokenId(color) && ToTokenId(color) == T_TRANSPARENT)
 	col = RGBColor(0, 0, 0, 0);
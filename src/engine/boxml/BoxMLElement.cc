@@ -38,3 +38,33 @@ BoxMLElement::setMaxArea(const AreaRef& area)
 AreaRef
 BoxMLElement::getMaxArea() const
 { return maxArea ? maxArea : getArea(); }
+
+bool
+BoxMLElement::getCachedLayout(const scaled& width)
+{
+  for (std::vector<CachedLayout>::const_iterator p = layoutCache.begin();
+       p != layoutCache.end();
+       p++)
+    if (p->width == width)
+      {
+	setArea(p->area);
+	setMaxArea(p->maxArea);
+	layoutWidth = width;
+	return true;
+      }
+  return false;
+}
+
+void
+BoxMLElement::setCachedLayout(const scaled& width)
+{
+  // the oldest layout is dropped when the cache is full
+  if (layoutCache.size() >= MAX_CACHED_LAYOUTS)
+    layoutCache.erase(layoutCache.begin());
+  CachedLayout layout;
+  layout.width = width;
+  layout.area = getArea();
+  layout.maxArea = maxArea;
+  layoutCache.push_back(layout);
+  layoutWidth = width;
+}
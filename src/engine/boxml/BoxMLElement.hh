@@ -23,6 +23,8 @@
 #ifndef __BoxMLElement_hh__
 #define __BoxMLElement_hh__
 
+#include <vector>
+
 #include "gmv_defines.h"
 #include "Element.hh"
 
@@ -36,8 +38,32 @@ public:
   void setMaxArea(const AreaRef&);
   AreaRef getMaxArea(void) const;
 
+protected:
+  // layouts of the element for the available widths it has been
+  // formatted with, valid until the element becomes dirty for a
+  // reason other than the width.  Only the area of the element is
+  // cached, the width dependent descendants are left dirty on a hit
+  bool getCachedLayout(const scaled&);
+  void setCachedLayout(const scaled&);
+  void resetCachedLayouts(void) { layoutCache.clear(); }
+  // true if the element is clean and its area has been formatted, or
+  // restored from the cache, for the given available width
+  bool upToDate(const scaled& width) const
+  { return !dirtyLayout() && getArea() && width == layoutWidth; }
+
 private:
+  struct CachedLayout
+  {
+    scaled width;
+    AreaRef area;
+    AreaRef maxArea;
+  };
+
+  enum { MAX_CACHED_LAYOUTS = 4 };
+
   AreaRef maxArea;
+  scaled layoutWidth;
+  std::vector<CachedLayout> layoutCache;
 };
 
 #endif // __BoxMLElement_hh__
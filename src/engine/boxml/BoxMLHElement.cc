@@ -75,6 +75,7 @@ BoxMLHElement::format(FormattingContext& ctxt)
   if (dirtyLayout())
     {
       ctxt.push(this);
+      setWidthDependent();
 
       const scaled spacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, H, spacing)), scaled::zero());
       scaled availableWidth = ctxt.getAvailableWidth();
@@ -22,6 +22,8 @@
 
 #include <config.h>
 
+#include <algorithm>
+
 #include "BoxMLAttributeSignatures.hh"
 #include "BoxMLHOVElement.hh"
 #include "BoxMLHElement.hh"
@@ -45,81 +47,70 @@ BoxMLHOVElement::create(const SmartPtr<BoxMLNamespaceContext>& context)
 AreaRef
 BoxMLHOVElement::format(FormattingContext& ctxt)
 {
-  static int counter = 0;
-  if (dirtyLayout())
+  // a clean element is formatted again only for a new available
+  // width, its children return their own cached layouts
+  if (upToDate(ctxt.getAvailableWidth()))
+    return getArea();
+
+  if (dirtyLayout() && !dirtyWidth())
+    resetCachedLayouts();
+  else if (getCachedLayout(ctxt.getAvailableWidth()))
     {
-      printf("IN %d\n", counter++);
-      ctxt.push(this);
-
-      const scaled spacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HOV, spacing)), 0);
-      const scaled indent = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HOV, indent)), 0);
-      const scaled minLineSpacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, V, minlinespacing)), 0);
-
-      const scaled availableWidth = ctxt.getAvailableWidth();
+      // the width dependent descendants keep their areas for another
+      // width and stay dirty, they are formatted again as soon as
+      // this element is
+      resetDirtyLayout();
+      return getArea();
+    }
 
-      std::vector<AreaRef> cMax;
-      cMax.reserve(content.getSize());
-      std::vector<AreaRef> hc;
-      hc.reserve(content.getSize());
+  ctxt.push(this);
+  setWidthDependent();
+
+  const scaled spacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HOV, spacing)), 0);
+  const scaled indent = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HOV, indent)), 0);
+  const scaled minLineSpacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, V, minlinespacing)), 0);
+
+  const scaled availableWidth = ctxt.getAvailableWidth();
+  const scaled lineWidth = std::min(availableWidth, availableWidth - indent);
+
+  // every child is formatted once, the line breaker only needs
+  // the widths of the resulting areas to choose the breaks
+  std::vector<AreaRef> cMax;
+  cMax.reserve(content.getSize());
+  std::vector<AreaRef> c;
+  c.reserve(content.getSize());
+
+  ctxt.setAvailableWidth(lineWidth);
+  for (std::vector<SmartPtr<BoxMLElement> >::const_iterator p = content.begin();
+       p != content.end();
+       p++)
+    if (*p)
+      {
+	const AreaRef area = (*p)->format(ctxt);
+	const AreaRef maxArea = (*p)->getMaxArea();
+	cMax.push_back(maxArea);
+	c.push_back((maxArea->box().width <= lineWidth) ? maxArea : area);
+      }
+  ctxt.setAvailableWidth(availableWidth);
+
+  AreaRef res = BoxMLHElement::formatHorizontalArray(ctxt, cMax, spacing);
+  res = ctxt.BGD()->wrapper(ctxt, res);
+  setMaxArea(res);
+
+  if (res->box().width <= availableWidth)
+    setArea(res);
+  else
+    {
       std::vector<AreaRef> vc;
-      vc.reserve(content.getSize());
-
-      std::vector<SmartPtr<BoxMLElement> >::const_iterator p = content.begin();
-      while (p != content.end())
-	{
-	  const scaled availableWidthPerLine = vc.empty() ? availableWidth : availableWidth - indent;
-	  scaled remainingWidthForThisLine = availableWidthPerLine;
-
-	  hc.clear();
-
-	  ctxt.setAvailableWidth(availableWidthPerLine);
-
-	  AreaRef area;
-	  AreaRef maxArea;
-	  scaled maxAreaWidth;
-	  do
-	    {
-	      area = (*p)->format(ctxt);
-	      maxArea = (*p)->getMaxArea();
-	      maxAreaWidth = maxArea->box().width;
-	      cMax.push_back(maxArea);
-	      if (maxAreaWidth > remainingWidthForThisLine)
-		break;
-	      hc.push_back(maxArea);
-	      remainingWidthForThisLine -= maxAreaWidth + spacing;
-	      p++;
-	    }
-	  while (p != content.end());
-
-	  if (!hc.empty())
-	    vc.push_back(BoxMLHElement::formatHorizontalArray(ctxt, hc, spacing));
-	  else if (p != content.end())
-	    {
-	      if (maxAreaWidth <= availableWidthPerLine)
-		vc.push_back(maxArea);
-	      else
-		vc.push_back(area);
-	      p++;
-	    }
-	}
-
-      AreaRef res = BoxMLHElement::formatHorizontalArray(ctxt, cMax, spacing);
+      ctxt.BGD()->paragraph(ctxt, c, spacing, availableWidth, availableWidth - indent, vc);
+      res = BoxMLVElement::formatVerticalArray(ctxt, vc, minLineSpacing, 1, -1, indent);
       res = ctxt.BGD()->wrapper(ctxt, res);
-      setMaxArea(res);
-
-      if (res->box().width <= availableWidth)
-	setArea(res);
-      else
-	{
-	  res = BoxMLVElement::formatVerticalArray(ctxt, vc, minLineSpacing, 1, -1, indent);
-	  res = ctxt.BGD()->wrapper(ctxt, res);
-	  setArea(res);
-	}
-      printf("OUT %d\n", --counter);
-
-      ctxt.pop();
-      resetDirtyLayout();
+      setArea(res);
     }
+  setCachedLayout(availableWidth);
+
+  ctxt.pop();
+  resetDirtyLayout();
 
   return getArea();
 }
@@ -42,59 +42,70 @@ SmartPtr<BoxMLHVElement>
 BoxMLHVElement::create(const SmartPtr<BoxMLNamespaceContext>& context)
 { return new BoxMLHVElement(context); }
 
-AreaRef
-BoxMLHVElement::getMaxArea() const
-{ return maxArea; }
-
 AreaRef
 BoxMLHVElement::format(FormattingContext& ctxt)
 {
-  if (dirtyLayout())
+  // a clean element is formatted again only for a new available
+  // width, its children return their own cached layouts
+  if (upToDate(ctxt.getAvailableWidth()))
+    return getArea();
+
+  if (dirtyLayout() && !dirtyWidth())
+    resetCachedLayouts();
+  else if (getCachedLayout(ctxt.getAvailableWidth()))
     {
-      ctxt.push(this);
-
-      const scaled spacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HV, spacing)), 0);
-      const scaled indent = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HV, indent)), 0);
-      const scaled minLineSpacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, V, minlinespacing)), 0);
-
-      const scaled availableWidth = ctxt.getAvailableWidth();
-      std::vector<AreaRef> c;
-      c.reserve(content.getSize());
-      std::vector<AreaRef> cMax;
-      cMax.reserve(content.getSize());
-      std::vector<scaled> sc;
-      sc.reserve(content.getSize());
-
-      for (std::vector< SmartPtr<BoxMLElement> >::const_iterator p = content.begin();
-	   p != content.end();
-	   p++)
-	if (*p)
-	  {
-	    const scaled thisIndent = (p == content.begin()) ? 0 : indent;
-	    ctxt.setAvailableWidth(availableWidth - thisIndent);
-	    c.push_back((*p)->format(ctxt));
-	    cMax.push_back((*p)->getMaxArea());
-
-	    if (p + 1 != content.end())
-	      sc.push_back(spacing);
-	  }
-
-      AreaRef res;
-      res = BoxMLHElement::formatHorizontalArray(ctxt, cMax, spacing);
-      res = ctxt.BGD()->wrapper(ctxt, res);
-      setMaxArea(res);
-      
-      if (res->box().width > availableWidth)
-	{
-	  res = BoxMLVElement::formatVerticalArray(ctxt, c, minLineSpacing, 1, -1, indent);
-	  res = ctxt.BGD()->wrapper(ctxt, res);
-	}
+      // the width dependent descendants keep their areas for another
+      // width and stay dirty, they are formatted again as soon as
+      // this element is
+      resetDirtyLayout();
+      return getArea();
+    }
 
-      setArea(res);
+  ctxt.push(this);
+  setWidthDependent();
 
-      ctxt.pop();
-      resetDirtyLayout();
+  const scaled spacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HV, spacing)), 0);
+  const scaled indent = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HV, indent)), 0);
+  const scaled minLineSpacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, V, minlinespacing)), 0);
+
+  const scaled availableWidth = ctxt.getAvailableWidth();
+  std::vector<AreaRef> c;
+  c.reserve(content.getSize());
+  std::vector<AreaRef> cMax;
+  cMax.reserve(content.getSize());
+  std::vector<scaled> sc;
+  sc.reserve(content.getSize());
+
+  for (std::vector< SmartPtr<BoxMLElement> >::const_iterator p = content.begin();
+       p != content.end();
+       p++)
+    if (*p)
+      {
+	const scaled thisIndent = (p == content.begin()) ? 0 : indent;
+	ctxt.setAvailableWidth(availableWidth - thisIndent);
+	c.push_back((*p)->format(ctxt));
+	cMax.push_back((*p)->getMaxArea());
+
+	if (p + 1 != content.end())
+	  sc.push_back(spacing);
+      }
+
+  AreaRef res;
+  res = BoxMLHElement::formatHorizontalArray(ctxt, cMax, spacing);
+  res = ctxt.BGD()->wrapper(ctxt, res);
+  setMaxArea(res);
+  
+  if (res->box().width > availableWidth)
+    {
+      res = BoxMLVElement::formatVerticalArray(ctxt, c, minLineSpacing, 1, -1, indent);
+      res = ctxt.BGD()->wrapper(ctxt, res);
     }
 
+  setArea(res);
+  setCachedLayout(availableWidth);
+
+  ctxt.pop();
+  resetDirtyLayout();
+
   return getArea();
 }
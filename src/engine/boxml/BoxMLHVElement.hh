@@ -35,10 +35,6 @@ public:
   static SmartPtr<BoxMLHVElement> create(const SmartPtr<class BoxMLNamespaceContext>&);
 
   virtual AreaRef format(class FormattingContext&);
-  virtual AreaRef getMaxArea(void) const;
-
-private:
-  AreaRef maxArea;
 };
 
 #endif // __BoxMLHVElement_hh__
@@ -22,9 +22,6 @@
 
 #include <config.h>
 
-#include "Rope.hh"
-#include <algorithm>
-
 #include "BoxMLParagraphElement.hh"
 #include "BoxMLVElement.hh"
 #include "BoxMLAttributeSignatures.hh"
@@ -32,9 +29,7 @@
 #include "BoxGraphicDevice.hh"
 #include "ValueConversion.hh"
 #include "AreaFactory.hh"
-#include "BoxMLTextElement.hh"
 #include "BoxMLNamespaceContext.hh"
-#include "BoxedParagraph.hh"
 
 BoxMLParagraphElement::BoxMLParagraphElement(const SmartPtr<BoxMLNamespaceContext>& c)
   : BoxMLLinearContainerElement(c)
@@ -50,43 +45,35 @@ BoxMLParagraphElement::create(const SmartPtr<BoxMLNamespaceContext>& context)
 AreaRef
 BoxMLParagraphElement::format(FormattingContext& ctxt)
 {
-  assert(false);
-  std::cerr << "sto per formattare il par " << dirtyLayout() << std::endl;
-
   if (dirtyLayout())
     {
       ctxt.push(this);
+      setWidthDependent();
 
-      const scaled availableWidth = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, Text, width)), 0);
       const scaled minLineSpacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, V, minlinespacing)), 0);
+      const scaled spacing = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, HOV, spacing)), 0);
 
-      scaled width;
+      scaled width = ctxt.getAvailableWidth();
       if (SmartPtr<Value> value = GET_ATTRIBUTE_VALUE(BoxML, Text, width))
-	if (IsTokenId(value))
-	  width = scaled::min();
-	else
-	  width = ctxt.BGD()->evaluate(ctxt, ToLength(value), scaled::max());
-      else
-	width = scaled::min();
+	if (!IsTokenId(value))
+	  width = ctxt.BGD()->evaluate(ctxt, ToLength(value), width);
 
-      BoxedParagraph paragraph;
+      std::vector<AreaRef> c;
+      c.reserve(content.getSize());
       for (std::vector< SmartPtr<BoxMLElement> >::const_iterator p = content.begin();
 	   p != content.end();
 	   p++)
 	if (*p)
-	  if (SmartPtr<BoxMLTextElement> text = smart_cast<BoxMLTextElement>(*p))
-	    paragraph.append(ctxt, text->getContent());
-	  else
-	    paragraph.append(ctxt, (*p)->format(ctxt));
+	  c.push_back((*p)->format(ctxt));
 
-      AreaRef res = ctxt.BGD()->paragraph(ctxt, paragraph, width);
+      std::vector<AreaRef> lines;
+      ctxt.BGD()->paragraph(ctxt, c, spacing, width, width, lines);
+      AreaRef res = BoxMLVElement::formatVerticalArray(ctxt, lines, minLineSpacing, 1, -1, scaled::zero());
       setArea(ctxt.BGD()->wrapper(ctxt, res));
 
       ctxt.pop();
       resetDirtyLayout();
     }
 
-  std::cerr << "fine formattazione par " << dirtyLayout() << std::endl;
-
   return getArea();
 }
@@ -140,6 +140,7 @@ BoxMLVElement::format(FormattingContext& ctxt)
   if (dirtyLayout())
     {
       ctxt.push(this);
+      setWidthDependent();
 
       const scaled indent = ctxt.BGD()->evaluate(ctxt, ToLength(GET_ATTRIBUTE_VALUE(BoxML, V, indent)), 0);
       int enter = ToInteger(GET_ATTRIBUTE_VALUE(BoxML, V, enter));
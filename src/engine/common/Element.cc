@@ -155,7 +155,7 @@ Element::setDirtyAttributeD()
 void
 Element::setDirtyLayout()
 {
-  if (!dirtyLayout())
+  if (!dirtyLayout() || dirtyWidth())
     {
       setFlag(FDirtyLayout);
       setFlagUp(FDirtyLayout);
@@ -165,13 +165,23 @@ Element::setDirtyLayout()
 void
 Element::setDirtyLayoutD()
 {
-  if (!dirtyLayout())
+  if (!dirtyLayout() || dirtyWidth())
     {
       setFlagDown(FDirtyLayout);
       setDirtyLayout();
     }
 }
 
+void
+Element::setWidthDependent()
+{
+  if (!widthDependent())
+    {
+      setFlag(FWidthDependent);
+      setFlagUp(FWidthDependent);
+    }
+}
+
 void
 Element::setFlag(Flags f)
 {
@@ -179,12 +189,23 @@ Element::setFlag(Flags f)
   //if (f == FDirtyAttribute) std::cerr << "Element::setFlag (FDirtyAttribute) " << this << std::endl;
   //if (f == FDirtyAttributeD) std::cerr << "Element::setFlag (FDirtyAttributeD) " << this << std::endl;
   flags.set(f);
+  // any other reason to layout overrides the change of width
+  if (f == FDirtyLayout) flags.reset(FDirtyWidth);
+}
+
+void
+Element::resetFlag(Flags f)
+{
+  flags.reset(f);
+  if (f == FDirtyLayout) flags.reset(FDirtyWidth);
 }
 
 void
 Element::setFlagUp(Flags f)
 {
-  for (SmartPtr<Element> p = getParent(); p && !p->getFlag(f); p = p->getParent())
+  for (SmartPtr<Element> p = getParent();
+       p && (!p->getFlag(f) || (f == FDirtyLayout && p->dirtyWidth()));
+       p = p->getParent())
     p->setFlag(f);
 }
 
@@ -198,7 +219,18 @@ Element::resetFlagUp(Flags f)
 void
 Element::setFlagDown(Flags f)
 {
-  setFlag(f);
+  if (f == FDirtyWidth)
+    {
+      // the ancestors of a width dependent element are width
+      // dependent as well, so dirtyLayout is consistently set
+      if (widthDependent() && !dirtyLayout())
+	{
+	  setFlag(FDirtyLayout);
+	  setFlag(FDirtyWidth);
+	}
+    }
+  else
+    setFlag(f);
 }
 
 void
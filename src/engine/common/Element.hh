@@ -72,6 +72,14 @@ public:
   virtual void setDirtyLayoutD(void);
   void resetDirtyLayout(void) { resetFlag(FDirtyLayout); }
   bool dirtyLayout(void) const { return getFlag(FDirtyLayout); }
+  // an element whose layout depends on the available width marks
+  // itself while formatting, when the width changes only the marked
+  // elements need to layout again
+  void setWidthDependent(void);
+  bool widthDependent(void) const { return getFlag(FWidthDependent); }
+  void setDirtyWidthD(void) { setFlagDown(FDirtyWidth); }
+  // true if the layout is dirty only because the available width changed
+  bool dirtyWidth(void) const { return getFlag(FDirtyWidth); }
 
   enum Flags {
     FDirtyStructure,  // need to resynchronize with DOM
@@ -79,12 +87,14 @@ public:
     FDirtyAttributeP, // an attribute was modified in a descendant
     FDirtyAttributeD, // an attribute was modified and must set dirtyAttribute on all descendants
     FDirtyLayout,     // need to layout
+    FWidthDependent,  // the layout depends on the available width, in the element or in a descendant
+    FDirtyWidth,      // need to layout only because the available width changed
 
     FUnusedFlag       // Just to know how many flags we use without having to count them
   };
 
   void setFlag(Flags f);// { flags.set(f); }
-  void resetFlag(Flags f) { flags.reset(f); }
+  void resetFlag(Flags f);
   void setFlagUp(Flags);
   void resetFlagUp(Flags);
   virtual void setFlagDown(Flags);
@@ -35,6 +35,10 @@
 #include "BoxMLNamespaceContext.hh"
 #endif // GMV_ENABLE_BOXML
 #include "AreaId.hh"
+#include "AreaCache.hh"
+#include "AreaDamage.hh"
+#include "AreaPositionIndex.hh"
+#include "GlyphStringArea.hh"
 #include "AbstractLogger.hh"
 #include "FormattingContext.hh"
 #include "MathGraphicDevice.hh"
@@ -44,7 +48,7 @@
 #endif // ENABLE_BINRELOC
 
 View::View(const SmartPtr<AbstractLogger>& l)
-  : logger(l), defaultFontSize(DEFAULT_FONT_SIZE), freezeCounter(0)
+  : logger(l), defaultFontSize(DEFAULT_FONT_SIZE), freezeCounter(0), cacheMissed(false)
 { }
 
 View::~View()
@@ -174,16 +178,71 @@ void
 View::resetRootElement()
 {
   rootElement = 0;
+  cachedRootArea = 0;
+  cacheMissed = false;
+  positionIndex = 0;
+  renderedArea = 0;
 }
 
 AreaRef
 View::getRootArea() const
 { return formatElement(getRootElement()); }
 
+AreaRef
+View::getRenderArea() const
+{
+  if (!areaCache || documentDigest.empty())
+    return getRootArea();
+
+  if (cachedRootArea)
+    return cachedRootArea;
+  else if (cacheMissed)
+    return getRootArea();
+
+  Clock perf;
+  perf.Start();
+  cachedRootArea = areaCache->lookup(documentDigest, getDefaultFontSize(), getAvailableWidth());
+  perf.Stop();
+  if (cachedRootArea)
+    {
+      getLogger()->out(LOG_INFO, "area cache hit: %dms", perf());
+      return cachedRootArea;
+    }
+
+  // on a miss the formatted tree is used directly, so that it stays
+  // up to date with later changes to the document, until the digest,
+  // the font size or the available width change
+  cacheMissed = true;
+  AreaRef rootArea = getRootArea();
+  if (rootArea && !areaCache->store(documentDigest, getDefaultFontSize(), getAvailableWidth(), rootArea))
+    getLogger()->out(LOG_INFO, "area tree could not be stored in the cache");
+  return rootArea;
+}
+
+void
+View::setAreaCache(const SmartPtr<AreaCache>& cache)
+{
+  areaCache = cache;
+  cachedRootArea = 0;
+  cacheMissed = false;
+}
+
+SmartPtr<AreaCache>
+View::getAreaCache() const
+{ return areaCache; }
+
+void
+View::setDocumentDigest(const String& digest)
+{
+  documentDigest = digest;
+  cachedRootArea = 0;
+  cacheMissed = false;
+}
+
 BoundingBox
 View::getBoundingBox() const
 {
-  if (AreaRef rootArea = getRootArea())
+  if (AreaRef rootArea = getRenderArea())
     return rootArea->box();
   else
     return BoundingBox();
@@ -217,13 +276,32 @@ View::getElementExtents(const SmartPtr<Element>& refElem, const SmartPtr<Element
 {
   assert(refElem);
   assert(elem);
-  if (getRootArea())
+  if (AreaRef rootArea = getRootArea())
     if (AreaRef elemArea = elem->getArea())
       {
 	if (elemOrigin)
 	  {
 	    if (AreaRef refArea = refElem->getArea())
 	      {
+		// the index gives origins relative to the root area, which
+		// can be subtracted when elem is a descendant of refElem
+		// the results are copied out only on success, the fallback
+		// must find the caller's values untouched
+		const SmartPtr<AreaPositionIndex> index = getPositionIndex(rootArea);
+		Point origin;
+		BoundingBox box;
+		Point refOrigin;
+		if (index->getExtents(elemArea, &origin, &box)
+		    && index->getExtents(refArea, &refOrigin))
+		  for (SmartPtr<Element> p = elem; p; p = p->getParent())
+		    if (p == refElem)
+		      {
+			elemOrigin->x = origin.x - refOrigin.x;
+			elemOrigin->y = origin.y - refOrigin.y;
+			if (elemBox) *elemBox = box;
+			return true;
+		      }
+
 		AreaId elemId(refArea);
 		if (refArea->searchByArea(elemId, elemArea))
 		  elemId.getOrigin(*elemOrigin);
@@ -309,6 +387,25 @@ View::getCharExtents(const SmartPtr<Element>& refElem, const SmartPtr<Element>&
   if (getElementOrigin(refElem, elem, elemOrig))
     if (AreaRef elemArea = elem->getArea())
       {
+	// the characters of a token are usually in one glyph string,
+	// which the position index has recorded
+	SmartPtr<const GlyphStringArea> string;
+	Point stringOrig;
+	if (getPositionIndex(getRootArea())->getGlyphString(elemArea, string, &stringOrig))
+	  {
+	    Point charOffset;
+	    if (string->positionOfIndex(index, &charOffset, charBox))
+	      {
+		if (charOrig)
+		  {
+		    charOrig->x = elemOrig.x + stringOrig.x + charOffset.x;
+		    charOrig->y = elemOrig.y + stringOrig.y + charOffset.y;
+		  }
+		return true;
+	      }
+	    return false;
+	  }
+
 	AreaId deepId(elemArea);
 	if (elemArea->searchByIndex(deepId, index))
 	  {
@@ -367,22 +464,60 @@ void
 View::render(RenderingContext& ctxt, const scaled& x, const scaled& y) const
 {
   //std::cerr << "View::render " << &ctxt << std::endl;
-  if (AreaRef rootArea = getRootArea())
+  if (AreaRef rootArea = getRenderArea())
     {
       Clock perf;
       perf.Start();
 
       // Basically (x, y) are the coordinates of the origin
       rootArea->render(ctxt, x, y);
+      renderedArea = rootArea;
 
       perf.Stop();
       getLogger()->out(LOG_INFO, "rendering time: %dms", perf());
     }
 }
 
+bool
+View::getDamage(std::vector<Rectangle>& rects) const
+{
+  if (!renderedArea) return false;
+
+  if (AreaRef rootArea = getRenderArea())
+    {
+      Clock perf;
+      perf.Start();
+      AreaDamage::compare(renderedArea, rootArea, rects);
+      perf.Stop();
+      getLogger()->out(LOG_INFO, "damaged %d rectangles: %dms", rects.size(), perf());
+      return true;
+    }
+  else
+    return false;
+}
+
+SmartPtr<AreaPositionIndex>
+View::getPositionIndex(const AreaRef& rootArea) const
+{
+  assert(rootArea);
+  // any change in the layout produces a new root area
+  if (!positionIndex || positionIndex->getRoot() != rootArea)
+    {
+      Clock perf;
+      perf.Start();
+      positionIndex = AreaPositionIndex::create(rootArea);
+      perf.Stop();
+      getLogger()->out(LOG_INFO, "indexed %d areas: %dms", positionIndex->getSize(), perf());
+    }
+  return positionIndex;
+}
+
 void
 View::setDirtyLayout() const
 {
+  cachedRootArea = 0;
+  cacheMissed = false;
+  positionIndex = 0;
   if (SmartPtr<Element> elem = getRootElement())
     {
       //elem->setDirtyAttributeD();
@@ -407,6 +542,12 @@ View::setAvailableWidth(const scaled& width)
   if (width != availableWidth)
     {
       availableWidth = width;
-      setDirtyLayout();
+      cachedRootArea = 0;
+      cacheMissed = false;
+      positionIndex = 0;
+      // the areas of elements that do not depend on the available
+      // width are still valid and are not formatted again
+      if (SmartPtr<Element> elem = getRootElement())
+	elem->setDirtyWidthD();
     }
 }
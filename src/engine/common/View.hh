@@ -23,6 +23,8 @@
 #ifndef __View_hh__
 #define __View_hh__
 
+#include <vector>
+
 #include "Object.hh"
 #include "String.hh"
 #include "SmartPtr.hh"
@@ -84,6 +86,10 @@ public:
   { return getCharExtents(elem, index, 0, &b); }
 
   void render(class RenderingContext&, const scaled&, const scaled&) const;
+  // collects the rectangles (relative to the origin of the root area)
+  // that look different from the last rendering. Returns false if
+  // nothing has been rendered yet and the whole view must be repainted
+  bool getDamage(std::vector<struct Rectangle>&) const;
 
   unsigned getDefaultFontSize(void) const { return defaultFontSize; }
   void setDefaultFontSize(unsigned);
@@ -91,9 +97,20 @@ public:
   scaled getAvailableWidth(void) const { return availableWidth; }
   void setAvailableWidth(const scaled&);
 
+  // when both the cache and the document digest are set, render and
+  // getBoundingBox use the cached area tree if there is one, without
+  // building nor formatting the document.  The digest must change
+  // whenever the document does
+  void setAreaCache(const SmartPtr<class AreaCache>&);
+  SmartPtr<class AreaCache> getAreaCache(void) const;
+  void setDocumentDigest(const String&);
+  String getDocumentDigest(void) const { return documentDigest; }
+
 protected:
   SmartPtr<const class Area> getRootArea(void) const;
+  SmartPtr<const class Area> getRenderArea(void) const;
   SmartPtr<const class Area> formatElement(const SmartPtr<class Element>&) const;
+  SmartPtr<class AreaPositionIndex> getPositionIndex(const SmartPtr<const class Area>&) const;
 
 private:
   mutable SmartPtr<class Element> rootElement;
@@ -107,6 +124,12 @@ private:
   unsigned defaultFontSize;
   unsigned freezeCounter;
   scaled availableWidth;
+  SmartPtr<class AreaCache> areaCache;
+  String documentDigest;
+  mutable SmartPtr<const class Area> cachedRootArea;
+  mutable bool cacheMissed;
+  mutable SmartPtr<class AreaPositionIndex> positionIndex;
+  mutable SmartPtr<const class Area> renderedArea;
 };
 
 #endif // __View_hh__
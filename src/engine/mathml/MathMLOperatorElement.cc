@@ -159,7 +159,7 @@ MathMLOperatorElement::format(FormattingContext& ctxt)
 
 	  const BoundingBox minBox = minArea->box();
 
-	  const scaled axis = ctxt.MGD()->axis(ctxt);
+	  const scaled axis = ctxt.getMetrics().axis;
 	  const scaled height = ctxt.getStretchToHeight() - axis;
 	  const scaled depth = ctxt.getStretchToDepth() + axis;
 
@@ -36,6 +36,11 @@
 #include "MathMLOperatorElement.hh"
 #include "FormattingContext.hh"
 #include "MathGraphicDevice.hh"
+#if defined(ENABLE_BREAKS)
+#include "LineBreaker.hh"
+#include "MathMLmathElement.hh"
+#include "MathMLStyleElement.hh"
+#endif
 
 MathMLRowElement::MathMLRowElement(const SmartPtr<class MathMLNamespaceContext>& context)
   : MathMLLinearContainerElement(context)
@@ -47,11 +52,7 @@ MathMLRowElement::~MathMLRowElement()
 SmartPtr<MathMLRowElement>
 MathMLRowElement::create(const SmartPtr<class MathMLNamespaceContext>& context)
 {
-#if defined(ENABLE_BREAKS)
   return new MathMLRowElement(context);
-#else
-  return new MathMLRowElement(context);
-#endif
 }
 
 AreaRef
@@ -61,56 +62,31 @@ MathMLRowElement::format(FormattingContext& ctxt)
     {
       ctxt.push(this);
 
-      bool stretchy = false;
-      std::vector< SmartPtr<MathMLOperatorElement> > erow;
-      erow.reserve(getSize());
-      std::vector<AreaRef> row;
-      row.reserve(getSize());
-      for (std::vector< SmartPtr<MathMLElement> >::const_iterator elem = content.begin();
-	   elem != content.end();
-	   elem++)
-	if (*elem)
-	  {
-	    SmartPtr<MathMLOperatorElement> coreOp = (*elem)->getCoreOperatorTop();
-	    /* if we have an operator we must force reformatting cause we want to
-	     * get the minimum size operator
-	     */
-	    if (coreOp) (*elem)->setDirtyLayout();
-	    if (AreaRef elemArea = (*elem)->format(ctxt))
-	      {
-		row.push_back(elemArea);
-		// WARNING: we can check for IsStretchy only *after* format because it is
-		// at that time that the flags in the operator get set (see MathMLOperatorElement)
-		if (coreOp && !coreOp->IsStretchy()) coreOp = 0;
-		stretchy = stretchy || coreOp;
-		erow.push_back(coreOp);
-	      }
-	  }
-
-      AreaRef res;
-      if (row.size() == 1) res = row[0];
-      else res = ctxt.MGD()->getFactory()->horizontalArray(row);
-      BoundingBox rowBox = res->box();
+#if defined(ENABLE_BREAKS)
+      // when only the available width has changed the children still
+      // have the same areas, and the row is only broken again
+      if (!dirtyWidth() || !rowArea || !sameContent())
+	{
+	  rowArea = formatContent(ctxt, rowContent);
+	  computePenalties(rowPenalty);
+	}
 
-      if (stretchy)
+      AreaRef res = rowArea;
+      if (isBreakable())
 	{
-	  ctxt.setStretchToHeight(rowBox.height);
-	  ctxt.setStretchToDepth(rowBox.depth);
-	  for (std::vector< SmartPtr<MathMLOperatorElement> >::const_iterator op = erow.begin();
-	       op != erow.end();
-	       op++)
-	    if (*op)
-	      {
-		const int i = op - erow.begin();
-		ctxt.setStretchOperator(*op);
-		(*op)->setDirtyLayout();
-		row[i] = getChild(i)->format(ctxt);
-	      }
-	  ctxt.setStretchOperator(0);
-
-	  if (row.size() == 1) res = row[0];
-	  else res = ctxt.MGD()->getFactory()->horizontalArray(row);
+	  setWidthDependent();
+	  // newline and indentingnewline break the row even if it fits
+	  if (rowContent.size() > 1
+	      && ctxt.getAvailableWidth() > scaled::zero()
+	      && (res->box().width > ctxt.getAvailableWidth()
+		  || std::find(rowPenalty.begin(), rowPenalty.end(),
+			       -LineBreaker::INFINITE_PENALTY) != rowPenalty.end()))
+	    res = breakRow(ctxt, rowContent, rowPenalty);
 	}
+#else
+      std::vector<AreaRef> row;
+      AreaRef res = formatContent(ctxt, row);
+#endif // ENABLE_BREAKS
 
       res = formatEmbellishment(this, ctxt, res);
       setArea(ctxt.MGD()->wrapper(ctxt, res));
@@ -122,6 +98,63 @@ MathMLRowElement::format(FormattingContext& ctxt)
   return getArea();
 }
 
+AreaRef
+MathMLRowElement::formatContent(FormattingContext& ctxt, std::vector<AreaRef>& row)
+{
+  bool stretchy = false;
+  std::vector< SmartPtr<MathMLOperatorElement> > erow;
+  erow.reserve(getSize());
+  row.clear();
+  row.reserve(getSize());
+  for (std::vector< SmartPtr<MathMLElement> >::const_iterator elem = content.begin();
+       elem != content.end();
+       elem++)
+    if (*elem)
+      {
+	SmartPtr<MathMLOperatorElement> coreOp = (*elem)->getCoreOperatorTop();
+	/* if we have an operator we must force reformatting cause we want to
+	 * get the minimum size operator
+	 */
+	if (coreOp) (*elem)->setDirtyLayout();
+	if (AreaRef elemArea = (*elem)->format(ctxt))
+	  {
+	    row.push_back(elemArea);
+	    // WARNING: we can check for IsStretchy only *after* format because it is
+	    // at that time that the flags in the operator get set (see MathMLOperatorElement)
+	    if (coreOp && !coreOp->IsStretchy()) coreOp = 0;
+	    stretchy = stretchy || coreOp;
+	    erow.push_back(coreOp);
+	  }
+      }
+
+  AreaRef res;
+  if (row.size() == 1) res = row[0];
+  else res = ctxt.MGD()->getFactory()->horizontalArray(row);
+  BoundingBox rowBox = res->box();
+
+  if (stretchy)
+    {
+      ctxt.setStretchToHeight(rowBox.height);
+      ctxt.setStretchToDepth(rowBox.depth);
+      for (std::vector< SmartPtr<MathMLOperatorElement> >::const_iterator op = erow.begin();
+	   op != erow.end();
+	   op++)
+	if (*op)
+	  {
+	    const int i = op - erow.begin();
+	    ctxt.setStretchOperator(*op);
+	    (*op)->setDirtyLayout();
+	    row[i] = getChild(i)->format(ctxt);
+	  }
+      ctxt.setStretchOperator(0);
+
+      if (row.size() == 1) res = row[0];
+      else res = ctxt.MGD()->getFactory()->horizontalArray(row);
+    }
+
+  return res;
+}
+
 bool
 MathMLRowElement::IsSpaceLike() const
 {
@@ -170,3 +203,163 @@ MathMLRowElement::getCoreOperator()
 
   return candidate ? candidate->getCoreOperator() : 0;
 }
+
+#if defined(ENABLE_BREAKS)
+// break penalties, the lower the more desirable the break
+#define INFIX_OPERATOR_PENALTY 50
+#define SEPARATOR_PENALTY 100
+#define GOODBREAK_PENALTY -200
+#define BADBREAK_PENALTY 500
+
+bool
+MathMLRowElement::isBreakable() const
+{
+  // only rows laid out at the top level of the formula are broken,
+  // a row inside a fraction or a script is broken by its ancestor
+  for (SmartPtr<Element> elem = getParent(); elem; elem = elem->getParent())
+    if (is_a<MathMLmathElement>(elem))
+      return true;
+    else if (!is_a<MathMLStyleElement>(elem))
+      return false;
+  return false;
+}
+
+bool
+MathMLRowElement::sameContent() const
+{
+  // the children must be clean and have the areas the row was made of
+  std::vector<AreaRef>::const_iterator area = rowContent.begin();
+  for (std::vector< SmartPtr<MathMLElement> >::const_iterator elem = content.begin();
+       elem != content.end();
+       elem++)
+    if (*elem)
+      {
+	if ((*elem)->dirtyLayout()) return false;
+	if (AreaRef elemArea = (*elem)->getArea())
+	  if (area == rowContent.end() || *area++ != elemArea)
+	    return false;
+      }
+  return area == rowContent.end();
+}
+
+void
+MathMLRowElement::computePenalties(std::vector<int>& penalty) const
+{
+  // penalty[i] is the cost of breaking the line before the i-th area
+  penalty.clear();
+  penalty.reserve(getSize());
+  SmartPtr<MathMLElement> prev = 0;
+  for (std::vector< SmartPtr<MathMLElement> >::const_iterator elem = content.begin();
+       elem != content.end();
+       elem++)
+    if (*elem && (*elem)->getArea())
+      {
+	penalty.push_back(breakPenalty(prev, *elem));
+	prev = *elem;
+      }
+}
+
+int
+MathMLRowElement::breakPenalty(const SmartPtr<MathMLElement>& prev, const SmartPtr<MathMLElement>& elem) const
+{
+  if (!prev)
+    return LineBreaker::INFINITE_PENALTY;
+
+  if (SmartPtr<MathMLSpaceElement> space = smart_cast<MathMLSpaceElement>(prev))
+    switch (space->GetBreakability())
+      {
+      case T_NEWLINE:
+      case T_INDENTINGNEWLINE:
+	return -LineBreaker::INFINITE_PENALTY;
+      case T_GOODBREAK:
+	return GOODBREAK_PENALTY;
+      case T_BADBREAK:
+	return BADBREAK_PENALTY;
+      case T_NOBREAK:
+	return LineBreaker::INFINITE_PENALTY;
+      default:
+	break;
+      }
+
+  // lines are broken before infix operators, which begin the next
+  // line, and after separators
+  if (SmartPtr<MathMLOperatorElement> op = elem->getCoreOperatorTop())
+    if (!op->IsFence() && !op->IsSeparator() && GetOperatorForm(elem) == T_INFIX)
+      return INFIX_OPERATOR_PENALTY;
+
+  if (SmartPtr<MathMLOperatorElement> op = prev->getCoreOperatorTop())
+    if (op->IsSeparator())
+      return SEPARATOR_PENALTY;
+
+  return LineBreaker::INFINITE_PENALTY;
+}
+
+AreaRef
+MathMLRowElement::breakRow(const FormattingContext& ctxt, const std::vector<AreaRef>& row,
+			   const std::vector<int>& penalty) const
+{
+  assert(row.size() == penalty.size());
+
+  const scaled availableWidth = ctxt.getAvailableWidth();
+  // continuation lines are indented by one em
+  const scaled indent = std::min(ctxt.getSize(), availableWidth / 2);
+
+  LineBreaker breaker;
+  breaker.setLineStretch(availableWidth / 3);
+  // rowIndex[k] is the index of the area following the k-th item,
+  // where a line broken at the k-th item ends and the next one begins
+  std::vector<unsigned> rowIndex;
+  rowIndex.reserve(2 * row.size() + 1);
+  for (unsigned i = 0; i < row.size(); i++)
+    {
+      if (penalty[i] < LineBreaker::INFINITE_PENALTY)
+	{
+	  breaker.appendPenalty(scaled::zero(), penalty[i]);
+	  rowIndex.push_back(i);
+	}
+      breaker.appendBox(row[i]->box().width);
+      rowIndex.push_back(i + 1);
+    }
+  rowIndex.push_back(row.size());
+
+  std::vector<unsigned> breaks;
+  breaker.breakLines(availableWidth, availableWidth - indent, breaks);
+  if (breaks.size() <= 1)
+    return ctxt.MGD()->getFactory()->horizontalArray(row);
+
+  const SmartPtr<AreaFactory> factory = ctxt.MGD()->getFactory();
+  const AreaRef indentArea = factory->horizontalSpace(indent);
+  const AreaRef lineSpacing = factory->verticalSpace(ctxt.getMetrics().ex / 2, scaled::zero());
+
+  std::vector<AreaRef> lines;
+  lines.reserve(2 * breaks.size());
+  unsigned first = 0;
+  for (std::vector<unsigned>::const_iterator b = breaks.begin(); b != breaks.end(); b++)
+    {
+      const unsigned last = rowIndex[*b];
+      // a forced break at the beginning of the row, or two in a row,
+      // would leave a line with nothing visible in it
+      bool empty = true;
+      for (unsigned i = first; empty && i < last; i++)
+	empty = row[i]->box().width == scaled::zero() && row[i]->box().verticalExtent() == scaled::zero();
+      if (!empty)
+	{
+	  std::vector<AreaRef> line;
+	  line.reserve(last - first + 1);
+	  if (!lines.empty()) line.push_back(indentArea);
+	  line.insert(line.end(), row.begin() + first, row.begin() + last);
+	  if (!lines.empty()) lines.push_back(lineSpacing);
+	  lines.push_back(factory->horizontalArray(line));
+	}
+      first = last;
+    }
+
+  if (lines.size() <= 1)
+    return factory->horizontalArray(row);
+
+  // vertical arrays are given bottom-up, the baseline of the whole
+  // row is the baseline of its first line
+  std::reverse(lines.begin(), lines.end());
+  return factory->verticalArray(lines, lines.size() - 1);
+}
+#endif // ENABLE_BREAKS
@@ -43,6 +43,24 @@ public:
 
   TokenId GetOperatorForm(const SmartPtr<MathMLElement>&) const;
   virtual SmartPtr<class MathMLOperatorElement> getCoreOperator(void);
+
+protected:
+  AreaRef formatContent(class FormattingContext&, std::vector<AreaRef>&);
+
+#if defined(ENABLE_BREAKS)
+  bool isBreakable(void) const;
+  bool sameContent(void) const;
+  void computePenalties(std::vector<int>&) const;
+  int breakPenalty(const SmartPtr<MathMLElement>&, const SmartPtr<MathMLElement>&) const;
+  AreaRef breakRow(const class FormattingContext&, const std::vector<AreaRef>&, const std::vector<int>&) const;
+
+private:
+  // the areas of the children and the row they make before it is
+  // broken, kept for breaking it again at another width
+  std::vector<AreaRef> rowContent;
+  std::vector<int> rowPenalty;
+  AreaRef rowArea;
+#endif // ENABLE_BREAKS
 };
 
 #endif // __MathMLRowElement_hh__
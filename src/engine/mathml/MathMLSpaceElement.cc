@@ -76,6 +76,10 @@ MathMLSpaceElement::format(FormattingContext& ctxt)
 #endif
 	lineBreak = false;
 
+      // the area of the space is kept, the hint is used by the row
+      // containing it to choose where to break
+      breakability = ToTokenId(GET_ATTRIBUTE_VALUE(MathML, Space, linebreak));
+
       if (lineBreak)
 	setArea(0);
       else
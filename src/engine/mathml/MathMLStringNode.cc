@@ -36,7 +36,7 @@ isCombining(Char32 ch)
 }
 
 MathMLStringNode::MathMLStringNode(const String& c)
-  : content(c)
+  : content(c), ucs4Content(UCS4StringOfString(c))
 { }
 
 MathMLStringNode::~MathMLStringNode()
@@ -44,17 +44,15 @@ MathMLStringNode::~MathMLStringNode()
 
 AreaRef
 MathMLStringNode::format(FormattingContext& ctxt)
-{ return ctxt.MGD()->string(ctxt, content); }
+{ return ctxt.MGD()->string(ctxt, content, ucs4Content); }
 
 unsigned
 MathMLStringNode::GetLogicalContentLength() const
 {
-  UCS4String s = UCS4StringOfString(content);
-
   unsigned length = 0;
-  for (UCS4String::const_iterator i = s.begin(); i != s.end(); i++)
+  for (UCS4String::const_iterator i = ucs4Content.begin(); i != ucs4Content.end(); i++)
     {
-      if (!isCombining(*i) || i == s.begin())
+      if (!isCombining(*i) || i == ucs4Content.begin())
 	length++;
     }
 
@@ -39,10 +39,15 @@ public:
   virtual AreaRef  format(class FormattingContext&);
 
   virtual unsigned GetLogicalContentLength(void) const;
+  virtual unsigned GetContentLength(void) const { return ucs4Content.length(); }
   virtual String   GetRawContent(void) const;
+  const UCS4String& GetRawUCS4Content(void) const { return ucs4Content; }
 
 private:
+  // the content is decoded once, formatting and the length
+  // computations share it
   String content;
+  UCS4String ucs4Content;
 };
 
 #endif // MathMLStringNode_hh
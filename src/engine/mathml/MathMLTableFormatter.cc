@@ -75,7 +75,7 @@ MathMLTableFormatter::init(const FormattingContext& ctxt,
 			   const SmartPtr<Value>& minLabelSpacingV,
 			   const SmartPtr<Value>& alignV)
 {
-  axis = ctxt.MGD()->axis(ctxt);
+  axis = ctxt.getMetrics().axis;
 
   nRows = nR;
   nColumns = nC;
@@ -201,7 +201,7 @@ MathMLTableFormatter::formatLines(const FormattingContext& ctxt,
   const TokenId frame = ToTokenId(frameV);
   const unsigned nGridRows = rows.size();
   const unsigned nGridColumns = columns.size();
-  const scaled defaultLineThickness = ctxt.MGD()->defaultLineThickness(ctxt);
+  const scaled defaultLineThickness = ctxt.getMetrics().lineThickness;
   const RGBColor color = ctxt.getColor();
 
   std::vector<BoxedLayoutArea::XYArea> content;
@@ -38,6 +38,8 @@ public:
 
   virtual String   GetRawContent(void) const { return String(); }
   virtual unsigned GetLogicalContentLength(void) const { return 0; }
+  // the number of Unicode characters in the raw content
+  virtual unsigned GetContentLength(void) const { return UCS4StringOfString(GetRawContent()).length(); }
 };
 
 #endif // __MathMLTextNode_hh__
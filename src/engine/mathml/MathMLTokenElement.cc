@@ -208,5 +208,10 @@ MathMLTokenElement::GetLogicalContentLength() const
 unsigned
 MathMLTokenElement::getContentLength() const
 { 
-  return UCS4StringOfString(GetRawContent()).length();
+  unsigned len = 0;
+  for (std::vector< SmartPtr<MathMLTextNode> >::const_iterator i = content.begin();
+       i != content.end();
+       i++)
+    len += (*i)->GetContentLength();
+  return len;
 }
@@ -1254,8 +1254,7 @@ protected:
     SmartPtr<Attribute> attr;
   
     if (signature.fromElement)
-      if (Model::hasAttribute(el, signature.name))
-	attr = Attribute::create(signature, Model::getAttribute(el, signature.name));
+      attr = Model::createAttribute(el, signature);
 
     if (!attr && signature.fromContext)
       attr = refinementContext.get(signature);
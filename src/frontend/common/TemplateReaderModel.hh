@@ -25,6 +25,7 @@
 
 #include "SmartPtr.hh"
 #include "String.hh"
+#include "Attribute.hh"
 
 #include "TemplateReaderNodeIterator.hh"
 #include "TemplateReaderElementIterator.hh"
@@ -66,6 +67,13 @@ struct TemplateReaderModel
   }
   static String getAttribute(const SmartPtr<Reader>& reader, const String& name) { return reader->getAttribute(name); }
   static bool hasAttribute(const SmartPtr<Reader>& reader, const String& name) { return reader->hasAttribute(name); }
+  static SmartPtr<Attribute> createAttribute(const SmartPtr<Reader>& reader, const AttributeSignature& signature)
+  {
+    if (reader->hasAttribute(signature.name))
+      return Attribute::create(signature, reader->getAttribute(signature.name));
+    else
+      return 0;
+  }
 
   struct Hash
   {
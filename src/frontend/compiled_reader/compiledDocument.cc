@@ -0,0 +1,141 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Attribute.hh"
+#include "compiledDocument.hh"
+
+compiledDocument::compiledDocument(const char* i, size_t s)
+  : image(i), size(s),
+    header(reinterpret_cast<const compiledHeader*>(i)),
+    strings(reinterpret_cast<const compiledString*>(i + header->stringOffset)),
+    nodes(reinterpret_cast<const compiledNode*>(i + header->nodeOffset)),
+    attributes(reinterpret_cast<const compiledAttribute*>(i + header->attributeOffset))
+{ }
+
+compiledDocument::~compiledDocument()
+{
+  munmap(const_cast<char*>(image), size);
+}
+
+SmartPtr<compiledDocument>
+compiledDocument::create(const String& path)
+{
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return 0;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(compiledHeader))
+    {
+      close(fd);
+      return 0;
+    }
+
+  void* image = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED) return 0;
+
+  const compiledHeader* header = static_cast<const compiledHeader*>(image);
+  if (header->magic != GMV_COMPILED_MAGIC
+      || header->version != GMV_COMPILED_VERSION
+      || header->size != (size_t) st.st_size)
+    {
+      munmap(image, st.st_size);
+      return 0;
+    }
+
+  SmartPtr<compiledDocument> doc = new compiledDocument(static_cast<const char*>(image), st.st_size);
+  // the destructor takes care of unmapping the image
+  return doc->valid() ? doc : 0;
+}
+
+bool
+compiledDocument::valid() const
+{
+  // offsets are checked once here so that accessors can index
+  // the image without any further check
+  if (header->stringOffset > size
+      || header->stringCount == 0
+      || header->stringCount > (size - header->stringOffset) / sizeof(compiledString)
+      || header->nodeOffset > size
+      || header->nodeCount == 0
+      || header->nodeCount > (size - header->nodeOffset) / sizeof(compiledNode)
+      || header->attributeOffset > size
+      || header->attributeCount > (size - header->attributeOffset) / sizeof(compiledAttribute))
+    return false;
+
+  for (unsigned i = 0; i < header->stringCount; i++)
+    if (strings[i].offset >= size
+	|| strings[i].length >= size - strings[i].offset
+	|| image[strings[i].offset + strings[i].length] != 0)
+      return false;
+
+  for (unsigned i = 0; i < header->nodeCount; i++)
+    {
+      const compiledNode& node = nodes[i];
+      if (node.namespaceURI >= header->stringCount
+	  || node.name >= header->stringCount
+	  || node.value >= header->stringCount
+	  || node.parent > i || (i > 0 && node.parent == i)
+	  || node.end <= i || node.end > nodes[node.parent].end
+	  || node.firstAttribute > header->attributeCount
+	  || node.attributeCount > header->attributeCount - node.firstAttribute)
+	return false;
+    }
+
+  if (nodes[0].end != header->nodeCount) return false;
+
+  for (unsigned i = 0; i < header->attributeCount; i++)
+    if (attributes[i].namespaceURI >= header->stringCount
+	|| attributes[i].name >= header->stringCount
+	|| attributes[i].value >= header->stringCount)
+      return false;
+
+  return true;
+}
+
+bool
+compiledDocument::equalString(unsigned i, const String& s) const
+{
+  return getStringLength(i) == s.length() && memcmp(getString(i), s.data(), s.length()) == 0;
+}
+
+SmartPtr<Attribute>
+compiledDocument::getAttributeObject(const AttributeSignature& signature, unsigned value) const
+{
+  SmartPtr<Attribute>& attr = attributeCache[CachedAttributeKey(&signature, value)];
+  if (!attr)
+    {
+      attr = Attribute::create(signature, getStringValue(value));
+      // force parsing now, the value is shared from now on
+      attr->getValue();
+    }
+  return attr;
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __compiledDocument_hh__
+#define __compiledDocument_hh__
+
+#include <cstddef>
+
+#include "Object.hh"
+#include "SmartPtr.hh"
+#include "String.hh"
+#include "HashMap.hh"
+#include "compiledFormat.hh"
+
+class compiledDocument : public Object
+{
+protected:
+  compiledDocument(const char*, size_t);
+  virtual ~compiledDocument();
+
+public:
+  static SmartPtr<compiledDocument> create(const String&);
+
+  unsigned getNodeCount(void) const { return header->nodeCount; }
+  const compiledNode& getNode(unsigned i) const { return nodes[i]; }
+  const compiledAttribute& getAttribute(unsigned i) const { return attributes[i]; }
+
+  const char* getString(unsigned i) const { return image + strings[i].offset; }
+  unsigned getStringLength(unsigned i) const { return strings[i].length; }
+  String getStringValue(unsigned i) const { return String(getString(i), getStringLength(i)); }
+  bool equalString(unsigned, const String&) const;
+
+  // attributes having the same signature and the same (interned) value
+  // share the same Attribute object, hence every distinct value is
+  // parsed at most once for the whole lifetime of the document
+  SmartPtr<class Attribute> getAttributeObject(const class AttributeSignature&, unsigned) const;
+
+protected:
+  bool valid(void) const;
+
+private:
+  const char* image;
+  size_t size;
+  const compiledHeader* header;
+  const compiledString* strings;
+  const compiledNode* nodes;
+  const compiledAttribute* attributes;
+
+  struct CachedAttributeKey
+  {
+    CachedAttributeKey(const class AttributeSignature* s, unsigned v) : signature(s), value(v) { }
+
+    bool operator==(const CachedAttributeKey& key) const
+    { return signature == key.signature && value == key.value; }
+
+    const class AttributeSignature* signature;
+    unsigned value;
+  };
+
+  struct CachedAttributeHash
+  {
+    size_t operator()(const CachedAttributeKey& key) const
+    { return reinterpret_cast<size_t>(key.signature) ^ (key.value * 2654435761u); }
+  };
+
+  typedef HASH_MAP_NS::hash_map<CachedAttributeKey,SmartPtr<class Attribute>,CachedAttributeHash> AttributeCache;
+  mutable AttributeCache attributeCache;
+};
+
+#endif // __compiledDocument_hh__
@@ -0,0 +1,174 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cassert>
+#include <fstream>
+
+#include "compiledXmlReader.hh"
+#include "compiledDocumentWriter.hh"
+
+compiledDocumentWriter::compiledDocumentWriter()
+{
+  // string 0 is the empty string
+  intern("");
+}
+
+compiledDocumentWriter::~compiledDocumentWriter()
+{ }
+
+unsigned
+compiledDocumentWriter::intern(const String& s)
+{
+  const StringMap::const_iterator p = stringMap.find(s);
+  if (p != stringMap.end())
+    return p->second;
+
+  const unsigned id = strings.size();
+  strings.push_back(s);
+  stringMap[s] = id;
+  return id;
+}
+
+void
+compiledDocumentWriter::startElement(const String& namespaceURI, const String& name)
+{
+  // there can be only one root element
+  assert(!openElements.empty() || nodes.empty());
+
+  compiledNode node;
+  node.type = compiledXmlReader::ELEMENT_NODE;
+  node.namespaceURI = intern(namespaceURI);
+  node.name = intern(name);
+  node.value = 0;
+  node.parent = openElements.empty() ? 0 : openElements.back();
+  node.end = 0;
+  node.firstAttribute = attributes.size();
+  node.attributeCount = 0;
+
+  openElements.push_back(nodes.size());
+  nodes.push_back(node);
+}
+
+void
+compiledDocumentWriter::attribute(const String& namespaceURI, const String& name, const String& value)
+{
+  assert(!openElements.empty());
+  assert(openElements.back() + 1 == nodes.size());
+
+  compiledAttribute attr;
+  attr.namespaceURI = intern(namespaceURI);
+  attr.name = intern(name);
+  attr.value = intern(value);
+  attributes.push_back(attr);
+  nodes.back().attributeCount++;
+}
+
+void
+compiledDocumentWriter::text(const String& value)
+{
+  assert(!openElements.empty());
+
+  // blank text nodes are never significant for the builder
+  bool blank = true;
+  for (String::const_iterator p = value.begin(); blank && p != value.end(); p++)
+    blank = isXmlSpace(*p);
+  if (blank) return;
+
+  // adjacent text nodes (for example around entity references)
+  // are merged into one
+  if (openElements.back() + 1 < nodes.size()
+      && nodes.back().type == compiledXmlReader::TEXT_NODE
+      && nodes.back().parent == openElements.back())
+    {
+      nodes.back().value = intern(strings[nodes.back().value] + value);
+      return;
+    }
+
+  compiledNode node;
+  node.type = compiledXmlReader::TEXT_NODE;
+  node.namespaceURI = 0;
+  node.name = 0;
+  node.value = intern(value);
+  node.parent = openElements.back();
+  node.end = nodes.size() + 1;
+  node.firstAttribute = attributes.size();
+  node.attributeCount = 0;
+  nodes.push_back(node);
+}
+
+void
+compiledDocumentWriter::endElement()
+{
+  assert(!openElements.empty());
+  nodes[openElements.back()].end = nodes.size();
+  openElements.pop_back();
+}
+
+bool
+compiledDocumentWriter::save(const String& path) const
+{
+  assert(openElements.empty());
+  if (nodes.empty()) return false;
+
+  compiledHeader header;
+  header.magic = GMV_COMPILED_MAGIC;
+  header.version = GMV_COMPILED_VERSION;
+  header.stringCount = strings.size();
+  header.stringOffset = sizeof(compiledHeader);
+
+  std::vector<compiledString> index;
+  index.reserve(strings.size());
+  unsigned offset = header.stringOffset + strings.size() * sizeof(compiledString);
+  for (std::vector<String>::const_iterator p = strings.begin(); p != strings.end(); p++)
+    {
+      compiledString s;
+      s.offset = offset;
+      s.length = p->length();
+      index.push_back(s);
+      offset += p->length() + 1;
+    }
+
+  // keep nodes and attributes word-aligned
+  const unsigned padding = (sizeof(unsigned) - offset % sizeof(unsigned)) % sizeof(unsigned);
+  header.nodeCount = nodes.size();
+  header.nodeOffset = offset + padding;
+  header.attributeCount = attributes.size();
+  header.attributeOffset = header.nodeOffset + nodes.size() * sizeof(compiledNode);
+  header.size = header.attributeOffset + attributes.size() * sizeof(compiledAttribute);
+
+  std::ofstream os(path.c_str(), std::ios::out | std::ios::binary);
+  if (!os) return false;
+
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char*>(&index[0]), index.size() * sizeof(compiledString));
+  for (std::vector<String>::const_iterator p = strings.begin(); p != strings.end(); p++)
+    os.write(p->c_str(), p->length() + 1);
+  for (unsigned i = 0; i < padding; i++)
+    os.put(0);
+  os.write(reinterpret_cast<const char*>(&nodes[0]), nodes.size() * sizeof(compiledNode));
+  if (!attributes.empty())
+    os.write(reinterpret_cast<const char*>(&attributes[0]), attributes.size() * sizeof(compiledAttribute));
+
+  return os.good();
+}
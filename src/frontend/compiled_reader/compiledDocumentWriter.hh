@@ -0,0 +1,64 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __compiledDocumentWriter_hh__
+#define __compiledDocumentWriter_hh__
+
+#include <vector>
+
+#include "String.hh"
+#include "StringHash.hh"
+#include "HashMap.hh"
+#include "compiledFormat.hh"
+
+// compiledDocumentWriter accumulates a document given as a sequence
+// of SAX-like events and saves it in the format read by compiledDocument
+class compiledDocumentWriter
+{
+public:
+  compiledDocumentWriter(void);
+  ~compiledDocumentWriter();
+
+  void startElement(const String&, const String&);
+  // attributes must be given right after startElement
+  void attribute(const String&, const String&, const String&);
+  void text(const String&);
+  void endElement(void);
+
+  bool save(const String&) const;
+
+  unsigned getNodeCount(void) const { return nodes.size(); }
+  unsigned getStringCount(void) const { return strings.size(); }
+
+protected:
+  unsigned intern(const String&);
+
+private:
+  std::vector<compiledNode> nodes;
+  std::vector<compiledAttribute> attributes;
+  std::vector<String> strings;
+  std::vector<unsigned> openElements;
+  typedef HASH_MAP_NS::hash_map<String,unsigned,StringHash,StringEq> StringMap;
+  StringMap stringMap;
+};
+
+#endif // __compiledDocumentWriter_hh__
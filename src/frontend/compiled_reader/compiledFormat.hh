@@ -0,0 +1,83 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __compiledFormat_hh__
+#define __compiledFormat_hh__
+
+// Layout of a compiled MathML/BoxML document. A compiled document
+// is a flat image that is mapped in memory as it is, all offsets
+// are in bytes from the beginning of the image and all words are
+// in the byte order of the machine that wrote the document.
+//
+//   compiledHeader
+//   compiledString[stringCount]       (string index)
+//   char[]                            (NUL-terminated UTF-8 strings)
+//   compiledNode[nodeCount]           (nodes in document order)
+//   compiledAttribute[attributeCount] (attributes grouped by node)
+//
+// Strings are interned, so that equal names, namespace URIs and
+// attribute values share the same string index. String 0 is
+// always the empty string. Only element nodes and non-blank text
+// nodes are stored.
+
+#define GMV_COMPILED_MAGIC   0x434d5647 // "GVMC"
+#define GMV_COMPILED_VERSION 1
+
+struct compiledHeader
+{
+  unsigned magic;
+  unsigned version;
+  unsigned size;
+  unsigned stringCount;
+  unsigned stringOffset;
+  unsigned nodeCount;
+  unsigned nodeOffset;
+  unsigned attributeCount;
+  unsigned attributeOffset;
+};
+
+struct compiledString
+{
+  unsigned offset;
+  unsigned length;
+};
+
+struct compiledNode
+{
+  unsigned type;           // ELEMENT_NODE or TEXT_NODE, as in the DOM
+  unsigned namespaceURI;   // string index
+  unsigned name;           // string index
+  unsigned value;          // string index, text nodes only
+  unsigned parent;         // node index, equal to the node itself for the root
+  unsigned end;            // index of the first node following the subtree
+  unsigned firstAttribute; // attribute index
+  unsigned attributeCount;
+};
+
+struct compiledAttribute
+{
+  unsigned namespaceURI; // string index
+  unsigned name;         // string index
+  unsigned value;        // string index
+};
+
+#endif // __compiledFormat_hh__
@@ -0,0 +1,101 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __compiledRefinementContext_hh__
+#define __compiledRefinementContext_hh__
+
+#include <list>
+
+#include "Attribute.hh"
+#include "AttributeSet.hh"
+#include "compiledXmlReader.hh"
+
+// Same as TemplateReaderRefinementContext, except that there is no
+// need to copy the raw attributes of the elements in the context:
+// the compiled document is immutable, so it is enough to remember
+// the index of each node, and attribute objects come from the
+// document cache
+class compiledRefinementContext
+{
+public:
+  compiledRefinementContext(void) { }
+
+  SmartPtr<Attribute>
+  get(const class AttributeSignature& sig) const
+  {
+    for (std::list<Context>::const_iterator p = context.begin(); p != context.end(); p++)
+      {
+	const Context& c = *p;
+	
+	if (SmartPtr<Attribute> attr = c.attributes->get(ATTRIBUTE_ID_OF_SIGNATURE(sig)))
+	  return attr;
+	else if (SmartPtr<Attribute> attr = c.get(sig))
+	  {
+	    c.attributes->set(attr);
+	    return attr;
+	  }
+      }
+    
+    return 0;
+  }
+  
+  void
+  push(const SmartPtr<compiledXmlReader>& reader)
+  {
+    assert(reader);
+    context.push_front(Context(reader->getDocument(), reader->getNodeIndex()));
+  }
+
+  void pop(void)
+  {
+    assert(!context.empty());
+    context.pop_front();
+  }
+
+private:
+  struct Context
+  {
+    Context(const SmartPtr<compiledDocument>& d, unsigned n)
+      : doc(d), node(n), attributes(AttributeSet::create())
+    { }
+
+    SmartPtr<Attribute> get(const AttributeSignature& sig) const
+    {
+      const compiledNode& n = doc->getNode(node);
+      for (unsigned i = 0; i < n.attributeCount; i++)
+	{
+	  const compiledAttribute& attr = doc->getAttribute(n.firstAttribute + i);
+	  if (attr.namespaceURI == 0 && doc->equalString(attr.name, sig.name))
+	    return doc->getAttributeObject(sig, attr.value);
+	}
+      return 0;
+    }
+
+    SmartPtr<compiledDocument> doc;
+    unsigned node;
+    SmartPtr<AttributeSet> attributes;
+  };
+
+  std::list<Context> context;
+};
+
+#endif // __compiledRefinementContext_hh__
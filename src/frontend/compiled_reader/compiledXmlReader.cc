@@ -0,0 +1,120 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include <cassert>
+
+#include "Attribute.hh"
+#include "compiledXmlReader.hh"
+
+compiledXmlReader::compiledXmlReader(const SmartPtr<compiledDocument>& d)
+  : doc(d), current(0), limit(d->getNodeCount())
+{
+  assert(doc);
+}
+
+compiledXmlReader::~compiledXmlReader()
+{ }
+
+int
+compiledXmlReader::findAttribute(const String& name) const
+{
+  const compiledNode& n = node();
+  for (unsigned i = 0; i < n.attributeCount; i++)
+    {
+      const compiledAttribute& attr = doc->getAttribute(n.firstAttribute + i);
+      if (attr.namespaceURI == 0 && doc->equalString(attr.name, name))
+	return i;
+    }
+  return -1;
+}
+
+void
+compiledXmlReader::getAttribute(int index, String& namespaceURI, String& name, String& value) const
+{
+  assert(index >= 0 && index < getAttributeCount());
+  const compiledAttribute& attr = doc->getAttribute(node().firstAttribute + index);
+  namespaceURI = doc->getStringValue(attr.namespaceURI);
+  name = doc->getStringValue(attr.name);
+  value = doc->getStringValue(attr.value);
+}
+
+String
+compiledXmlReader::getAttribute(const String& name) const
+{
+  const int index = findAttribute(name);
+  if (index >= 0)
+    return doc->getStringValue(doc->getAttribute(node().firstAttribute + index).value);
+  else
+    return String();
+}
+
+bool
+compiledXmlReader::hasAttribute(const String& name) const
+{
+  return findAttribute(name) >= 0;
+}
+
+SmartPtr<Attribute>
+compiledXmlReader::createAttribute(const AttributeSignature& signature) const
+{
+  const int index = findAttribute(signature.name);
+  if (index >= 0)
+    return doc->getAttributeObject(signature, doc->getAttribute(node().firstAttribute + index).value);
+  else
+    return 0;
+}
+
+void
+compiledXmlReader::reset()
+{
+  current = 0;
+  limit = doc->getNodeCount();
+  parents.clear();
+}
+
+void
+compiledXmlReader::moveToFirstChild()
+{
+  assert(more());
+  assert(getNodeType() == ELEMENT_NODE);
+  parents.push_back(current);
+  limit = doc->getNode(current).end;
+  current++;
+}
+
+void
+compiledXmlReader::moveToNextSibling()
+{
+  assert(more());
+  current = doc->getNode(current).end;
+}
+
+void
+compiledXmlReader::moveToParentNode()
+{
+  assert(!parents.empty());
+  current = parents.back();
+  parents.pop_back();
+  limit = parents.empty() ? doc->getNodeCount() : doc->getNode(parents.back()).end;
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __compiledXmlReader_hh__
+#define __compiledXmlReader_hh__
+
+#include <cassert>
+#include <vector>
+
+#include "Object.hh"
+#include "SmartPtr.hh"
+#include "String.hh"
+#include "compiledDocument.hh"
+
+class compiledXmlReader : public Object
+{
+protected:
+  compiledXmlReader(const SmartPtr<compiledDocument>&);
+  virtual ~compiledXmlReader();
+
+public:
+  enum {
+    TEXT_NODE = 3,
+    ELEMENT_NODE = 1
+  };
+
+  static SmartPtr<compiledXmlReader> create(const SmartPtr<compiledDocument>& doc)
+  { return new compiledXmlReader(doc); }
+
+  static SmartPtr<compiledXmlReader> create(const String& path, bool = false)
+  {
+    if (SmartPtr<compiledDocument> doc = compiledDocument::create(path))
+      return create(doc);
+    else
+      return 0;
+  }
+
+  SmartPtr<compiledDocument> getDocument(void) const { return doc; }
+
+  bool more(void) const { return current < limit; }
+
+  int getNodeType(void) const { return node().type; }
+  String getNodeName(void) const { return doc->getStringValue(node().name); }
+  String getNodeValue(void) const { return doc->getStringValue(node().value); }
+  String getNodeNamespaceURI(void) const { return doc->getStringValue(node().namespaceURI); }
+  // node ids start from 1 so that 0 can be used as the null id
+  unsigned getNodeId(void) const { return more() ? current + 1 : 0; }
+  unsigned getNodeIndex(void) const { return current; }
+
+  int getAttributeCount(void) const { return node().attributeCount; }
+  void getAttribute(int, String&, String&, String&) const;
+  String getAttribute(const String&) const;
+  bool hasAttribute(const String&) const;
+  SmartPtr<class Attribute> createAttribute(const class AttributeSignature&) const;
+
+  void reset(void);
+  void moveToFirstChild(void);
+  void moveToNextSibling(void);
+  void moveToParentNode(void);
+
+protected:
+  const compiledNode& node(void) const { assert(more()); return doc->getNode(current); }
+  // index of the non-namespaced attribute with the given name in the
+  // current node, or -1 if there is no such attribute
+  int findAttribute(const String&) const;
+
+private:
+  SmartPtr<compiledDocument> doc;
+  unsigned current;
+  unsigned limit;
+  std::vector<unsigned> parents;
+};
+
+#endif // __compiledXmlReader_hh__
@@ -22,51 +22,25 @@
 
 #include <config.h>
 
-#include "Model.hh"
-#include "Location.hh"
-#include "SVG_EvalRenderingContext.hh"
-
-SVG_EvalRenderingContext::SVG_EvalRenderingContext(const SmartPtr<AbstractLogger>& logger,
-						   const SmartPtr<MathView>& _view)
-  : SVG_RenderingContext(logger), view(_view)
-{ }
-
-SVG_EvalRenderingContext::~SVG_EvalRenderingContext()
-{ }
-
-#include <iostream>
-
-void
-SVG_EvalRenderingContext::wrapperStart(const scaled& x, const scaled& y, const BoundingBox& box,
-				       const SmartPtr<Element>& elem)
-{
-  assert(elem);
-  if (xmlElement* el = view->modelElementOfElement(elem))
-    {
-      if (xmlChar* id = xmlGetProp((xmlNode*) el, Model::toModelString("id")))
-	{
-	  const String name = Model::fromModelString(id);
-	  idMap[name] = Location::create(name, x, y, box);
-	  xmlFree(id);
-
-
-
-	}
-    }
-}
-
-void
-SVG_EvalRenderingContext::wrapperEnd()
+#include "Attribute.hh"
+#include "TemplateBuilder.hh"
+#include "compiled_reader_Model.hh"
+#include "compiled_reader_Builder.hh"
+#include "compiledRefinementContext.hh"
+
+typedef TemplateBuilder<compiled_reader_Model,
+			compiled_reader_Builder,
+			compiledRefinementContext> BUILDER;
+
+SmartPtr<compiled_reader_Builder>
+compiled_reader_Builder::create()
+{ return BUILDER::create(); }
+
+unsigned
+compiled_reader_Builder::findSelfOrAncestorModelElement(const SmartPtr<Element>& elem) const
 {
+  for (SmartPtr<Element> p(elem); p; p = p->getParent())
+    if (unsigned id = linker.assoc(p))
+      return id;
+  return 0;
 }
-
-SmartPtr<Location>
-SVG_EvalRenderingContext::getLocation(const String& name) const
-{
-  const IdMap::const_iterator p = idMap.find(name);
-  if (p != idMap.end())
-    return p->second;
-  else
-    return 0;
-}
-
@@ -0,0 +1,66 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef __compiled_reader_Builder_hh__
+#define __compiled_reader_Builder_hh__
+
+#include "compiledXmlReader.hh"
+#include "TemplateReaderBuilder.hh"
+#include "TemplateLinker.hh"
+#include "compiled_reader_Model.hh"
+#include "String.hh"
+#include "Element.hh"
+
+class compiled_reader_Builder : public TemplateReaderBuilder<compiledXmlReader>
+{
+protected:
+  compiled_reader_Builder(void) { }
+  virtual ~compiled_reader_Builder() { }
+
+public:
+  static SmartPtr<compiled_reader_Builder> create(void);
+
+  SmartPtr<Element> findElement(unsigned id) const { return linker.assoc(id); }
+  unsigned findSelfOrAncestorModelElement(const SmartPtr<Element>&) const;
+  SmartPtr<Element> findSelfOrAncestorElement(unsigned id) const { return findElement(id); }
+
+protected:
+  SmartPtr<Element>
+  linkerAssoc(const SmartPtr<compiledXmlReader>& reader) const
+  {
+    if (unsigned id = reader->getNodeId())
+      return linker.assoc(id);
+    else
+      return 0;
+  }
+
+  void
+  linkerAdd(const SmartPtr<compiledXmlReader>& reader, Element* elem) const
+  { if (unsigned id = reader->getNodeId()) linker.add(id, elem); }
+
+  void linkerRemove(Element* elem) const { linker.remove(elem); }
+
+private:
+  mutable TemplateLinker<compiled_reader_Model, unsigned> linker;
+};
+
+#endif // __compiled_reader_Builder_hh__
@@ -26,6 +26,7 @@
 
 #include "Clock.hh"
 #include "AbstractLogger.hh"
+#include "Attribute.hh"
 #include "gmetadom_Model.hh"
 #include "MathMLEntitiesTable.hh"
 
@@ -154,3 +155,12 @@ gmetadom_Model::getNodeName(const DOM::Node& node)
   else return node.get_nodeName();
 }
 
+SmartPtr<Attribute>
+gmetadom_Model::createAttribute(const DOM::Element& el, const AttributeSignature& signature)
+{
+  assert(el);
+  if (el.hasAttribute(signature.name))
+    return Attribute::create(signature, el.getAttribute(signature.name));
+  else
+    return 0;
+}
@@ -28,6 +28,7 @@
 #include <GdomeSmartDOM.hh>
 
 #include "String.hh"
+#include "SmartPtr.hh"
 #include "TemplateNodeIterator.hh"
 #include "TemplateElementIterator.hh"
 
@@ -73,6 +74,9 @@ struct GMV_FrontEnd_EXPORT gmetadom_Model
   { if (DOM::GdomeString ns = n.get_namespaceURI()) return ns; else return String(); }
   // MUST be implemented if the default RefinementContext is used
   static bool hasAttribute(const DOM::Element& el, const String& name) { return el.hasAttribute(name); }
+  // MUST be available for TemplateBuilder to work, returns
+  // a null pointer if the attribute is not set
+  static SmartPtr<class Attribute> createAttribute(const DOM::Element&, const class AttributeSignature&);
 
   // methods for navigating the model
   // must be available if the default iterators are used
@@ -23,6 +23,7 @@
 #include <config.h>
 
 #include <cassert>
+#include <algorithm>
 
 #include "libxml2_Builder.hh"
 #include "libxml2_Model.hh"
@@ -86,3 +87,39 @@ libxml2_Builder::notifyAttributeChanged(xmlElement* target, const xmlChar*)
   else
     return false;
 }
+
+unsigned
+libxml2_Builder::notifyChanges(const std::vector<xmlElement*>& structure,
+			       const std::vector<xmlElement*>& attribute)
+{
+  unsigned n = 0;
+
+  // elements are marked from the root downwards, so that the flags of
+  // an element already dirty because of an ancestor are not propagated
+  // again and every shared ancestor is visited once
+  std::vector< std::pair<unsigned, Element*> > dirty;
+  dirty.reserve(structure.size());
+  for (std::vector<xmlElement*>::const_iterator p = structure.begin(); p != structure.end(); p++)
+    if (SmartPtr<Element> elem = findSelfOrAncestorElement(*p))
+      {
+	dirty.push_back(std::make_pair(elem->getDepth(), static_cast<Element*>(elem)));
+	n++;
+      }
+  std::sort(dirty.begin(), dirty.end());
+  dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+  for (std::vector< std::pair<unsigned, Element*> >::const_iterator p = dirty.begin(); p != dirty.end(); p++)
+    {
+      p->second->setDirtyStructure();
+      p->second->setDirtyAttributeD();
+    }
+
+  for (std::vector<xmlElement*>::const_iterator p = attribute.begin(); p != attribute.end(); p++)
+    if (SmartPtr<Element> elem = findSelfOrAncestorElement(*p))
+      {
+	// setDirtyAttribute stops at the first marked ancestor
+	elem->setDirtyAttribute();
+	n++;
+      }
+
+  return n;
+}
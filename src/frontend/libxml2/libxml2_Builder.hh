@@ -23,6 +23,8 @@
 #ifndef __libxml2_Builder_hh__
 #define __libxml2_Builder_hh__
 
+#include <vector>
+
 #include "libxml2_Model.hh"
 #include "TemplateLinker.hh"
 #include "Builder.hh"
@@ -47,6 +49,7 @@ public:
 
   bool notifyStructureChanged(xmlElement*);
   bool notifyAttributeChanged(xmlElement*, const xmlChar*);
+  unsigned notifyChanges(const std::vector<xmlElement*>&, const std::vector<xmlElement*>&);
 
 protected:
   // methods for accessing the linker
@@ -24,6 +24,7 @@
 
 #include "Clock.hh"
 #include "AbstractLogger.hh"
+#include "Attribute.hh"
 #include "libxml2_Model.hh"
 
 #include <iostream>
@@ -124,3 +125,13 @@ libxml2_Model::hasAttribute(const Element& el, const String& name)
   assert(el);
   return xmlHasProp((xmlNode*) el, toModelString(name));
 }
+
+SmartPtr<Attribute>
+libxml2_Model::createAttribute(const Element& el, const AttributeSignature& signature)
+{
+  assert(el);
+  if (hasAttribute(el, signature.name))
+    return Attribute::create(signature, getAttribute(el, signature.name));
+  else
+    return 0;
+}
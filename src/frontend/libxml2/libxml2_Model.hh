@@ -27,6 +27,7 @@
 #include <cassert>
 
 #include "String.hh"
+#include "SmartPtr.hh"
 
 #include "TemplateNodeIterator.hh"
 #include "TemplateElementIterator.hh"
@@ -72,6 +73,9 @@ struct GMV_FrontEnd_EXPORT libxml2_Model
   static String getAttribute(const Element&, const String&);
   // MUST be implemented if the default RefinementContext is used
   static bool hasAttribute(const Element&, const String&);
+  // MUST be available for TemplateBuilder to work, returns
+  // a null pointer if the attribute is not set
+  static SmartPtr<class Attribute> createAttribute(const Element&, const class AttributeSignature&);
 
   // methods for navigating the model
   // must be available if the default iterators are used
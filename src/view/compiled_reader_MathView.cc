@@ -0,0 +1,120 @@
+// Copyright (C) 2000-2007, Luca Padovani <padovani@sti.uniurb.it>.
+//
+// This file is part of GtkMathView, a flexible, high-quality rendering
+// engine for MathML documents.
+// 
+// GtkMathView is free software; you can redistribute it and/or modify it
+// either under the terms of the GNU Lesser General Public License version
+// 3 as published by the Free Software Foundation (the "LGPL") or, at your
+// option, under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation (the "GPL").  If you do not
+// alter this notice, a recipient may use your version of this file under
+// either the GPL or the LGPL.
+//
+// GtkMathView is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the LGPL or
+// the GPL for more details.
+// 
+// You should have received a copy of the LGPL and of the GPL along with
+// this program in the files COPYING-LGPL-3 and COPYING-GPL-2; if not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <config.h>
+
+#include "Clock.hh"
+#include "AbstractLogger.hh"
+#include "compiled_reader_MathView.hh"
+#include "compiled_reader_Builder.hh"
+#include "libxml2_reader_Setup.hh"
+
+compiled_reader_MathView::compiled_reader_MathView(const SmartPtr<AbstractLogger>& logger)
+  : View(logger)
+{
+  setBuilder(compiled_reader_Builder::create());
+}
+
+compiled_reader_MathView::~compiled_reader_MathView()
+{ }
+
+SmartPtr<compiled_reader_MathView>
+compiled_reader_MathView::create(const SmartPtr<AbstractLogger>& logger)
+{ return new compiled_reader_MathView(logger); }
+
+void
+compiled_reader_MathView::unload()
+{
+  resetRootElement();
+  if (SmartPtr<compiled_reader_Builder> builder = smart_cast<compiled_reader_Builder>(getBuilder()))
+    builder->setReader(0);
+}
+
+bool
+compiled_reader_MathView::loadURI(const char* name)
+{
+  assert(name);
+  Clock perf;
+  perf.Start();
+  const SmartPtr<compiledDocument> doc = compiledDocument::create(name);
+  perf.Stop();
+  getLogger()->out(LOG_INFO, "mapping time: %dms", perf());
+
+  if (doc)
+    return loadDocument(doc);
+
+  getLogger()->out(LOG_ERROR, "could not load compiled document `%s'", name);
+  unload();
+  return false;
+}
+
+bool
+compiled_reader_MathView::loadDocument(const SmartPtr<compiledDocument>& doc)
+{
+  assert(doc);
+  if (SmartPtr<compiled_reader_Builder> builder = smart_cast<compiled_reader_Builder>(getBuilder()))
+    {
+      resetRootElement();
+      builder->setReader(compiledXmlReader::create(doc));
+      return true;
+    }
+
+  unload();
+  return false;
+}
+
+SmartPtr<compiledDocument>
+compiled_reader_MathView::getDocument() const
+{
+  if (SmartPtr<compiled_reader_Builder> builder = smart_cast<compiled_reader_Builder>(getBuilder()))
+    if (SmartPtr<compiledXmlReader> reader = builder->getReader())
+      return reader->getDocument();
+  return 0;
+}
+
+SmartPtr<Element>
+compiled_reader_MathView::elementOfModelElement(unsigned id) const
+{
+  if (SmartPtr<compiled_reader_Builder> builder = smart_cast<compiled_reader_Builder>(getBuilder()))
+    return builder->findElement(id);
+  else
+    return 0;
+}
+
+unsigned
+compiled_reader_MathView::modelElementOfElement(const SmartPtr<Element>& elem) const
+{
+  if (SmartPtr<compiled_reader_Builder> builder = smart_cast<compiled_reader_Builder>(getBuilder()))
+    return builder->findSelfOrAncestorModelElement(elem);
+  else
+    return 0;
+}
+
+bool
+compiled_reader_MathView::loadConfiguration(const SmartPtr<AbstractLogger>& logger,
+					    const SmartPtr<Configuration>& configuration, const String& path)
+{ return libxml2_reader_Setup::loadConfiguration(*logger, *configuration, path); }
+
+bool
+compiled_reader_MathView::loadOperatorDictionary(const SmartPtr<AbstractLogger>& logger,
+						 const SmartPtr<MathMLOperatorDictionary>& dictionary, const String& path)
+{ return libxml2_reader_Setup::loadOperatorDictionary(*logger, *dictionary, path); }
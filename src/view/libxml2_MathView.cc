@@ -170,6 +170,24 @@ libxml2_MathView::notifyAttributeChanged(xmlElement* el, const xmlChar* name) co
     return false;
 }
 
+unsigned
+libxml2_MathView::notifyChanges(const std::vector<Change>& changes) const
+{
+  if (SmartPtr<libxml2_Builder> builder = smart_cast<libxml2_Builder>(getBuilder()))
+    {
+      std::vector<xmlElement*> structure;
+      std::vector<xmlElement*> attribute;
+      for (std::vector<Change>::const_iterator p = changes.begin(); p != changes.end(); p++)
+	if (p->kind == STRUCTURE_CHANGE)
+	  structure.push_back(p->elem);
+	else
+	  attribute.push_back(p->elem);
+      return builder->notifyChanges(structure, attribute);
+    }
+  else
+    return 0;
+}
+
 bool
 libxml2_MathView::loadConfiguration(const SmartPtr<AbstractLogger>& logger, 
 				    const SmartPtr<Configuration>& configuration, const String& path)
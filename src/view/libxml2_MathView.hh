@@ -23,6 +23,8 @@
 #ifndef __libxml2_MathView_hh__
 #define __libxml2_MathView_hh__
 
+#include <vector>
+
 #include <libxml/tree.h>
 
 #include "View.hh"
@@ -44,6 +46,19 @@ public:
 
   bool notifyStructureChanged(xmlElement*) const;
   bool notifyAttributeChanged(xmlElement*, const xmlChar*) const;
+
+  enum ChangeKind { STRUCTURE_CHANGE, ATTRIBUTE_CHANGE };
+  struct Change
+  {
+    Change(xmlElement* el, ChangeKind k) : elem(el), kind(k) { }
+    xmlElement* elem;
+    ChangeKind kind;
+  };
+  // marks all the changed elements in one pass. The document is
+  // rebuilt and formatted once, when it is needed next. Returns the
+  // number of changes that affect the document
+  unsigned notifyChanges(const std::vector<Change>&) const;
+
   xmlElement* modelElementOfElement(const SmartPtr<class Element>&) const;
   SmartPtr<class Element> elementOfModelElement(xmlElement*) const;
 
@@ -29,6 +29,9 @@
 #define gtk_math_view_update                   GTKMATHVIEW_METHOD_NAME(update)
 #define gtk_math_view_freeze                   GTKMATHVIEW_METHOD_NAME(freeze)
 #define gtk_math_view_thaw                     GTKMATHVIEW_METHOD_NAME(thaw)
+#define gtk_math_view_flush                    GTKMATHVIEW_METHOD_NAME(flush)
+#define gtk_math_view_set_async_format         GTKMATHVIEW_METHOD_NAME(set_async_format)
+#define gtk_math_view_get_async_format         GTKMATHVIEW_METHOD_NAME(get_async_format)
 #define gtk_math_view_load_reader              GTKMATHVIEW_METHOD_NAME(load_reader)
 #define gtk_math_view_load_uri                 GTKMATHVIEW_METHOD_NAME(load_uri)
 #define gtk_math_view_load_buffer              GTKMATHVIEW_METHOD_NAME(load_buffer)
@@ -37,6 +40,7 @@
 #define gtk_math_view_unload                   GTKMATHVIEW_METHOD_NAME(unload)
 #define gtk_math_view_structure_changed        GTKMATHVIEW_METHOD_NAME(structure_changed)
 #define gtk_math_view_attribute_changed        GTKMATHVIEW_METHOD_NAME(attribute_changed)
+#define gtk_math_view_changes                  GTKMATHVIEW_METHOD_NAME(changes)
 #define gtk_math_view_select                   GTKMATHVIEW_METHOD_NAME(select)
 #define gtk_math_view_unselect                 GTKMATHVIEW_METHOD_NAME(unselect)
 #define gtk_math_view_is_selected              GTKMATHVIEW_METHOD_NAME(is_selected)
@@ -56,6 +60,7 @@
 #define gtk_math_view_get_adjustments          GTKMATHVIEW_METHOD_NAME(get_adjustments)
 #define gtk_math_view_get_buffer               GTKMATHVIEW_METHOD_NAME(get_buffer)
 #define gtk_math_view_set_font_size            GTKMATHVIEW_METHOD_NAME(set_font_size)
+#define gtk_math_view_zoom_font_size           GTKMATHVIEW_METHOD_NAME(zoom_font_size)
 #define gtk_math_view_get_font_size            GTKMATHVIEW_METHOD_NAME(get_font_size)
 #define gtk_math_view_set_log_verbosity        GTKMATHVIEW_METHOD_NAME(set_log_verbosity)
 #define gtk_math_view_get_log_verbosity        GTKMATHVIEW_METHOD_NAME(get_log_verbosity)
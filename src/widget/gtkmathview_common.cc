@@ -114,6 +114,7 @@ struct _GtkMathViewClass
   gint defaultFontSize;
   bool defaultT1OpaqueMode;
   bool defaultT1AntiAliasedMode;
+  gint defaultT1GlyphCacheSize;
   MathMLOperatorDictionary* dictionary;
   Gtk_Backend* backend;
 };
@@ -138,6 +139,19 @@ struct _GtkMathView
   gint 	         old_top_y;
 
   guint          freeze_counter;
+  guint          idle_id;
+  gboolean       damage_only;
+  gint           render_x;
+  gint           render_y;
+
+  gboolean       async_format;
+  GThread*       format_thread;
+  guint          format_generation;
+
+  guint          zoom_id;
+  guint          zoom_font_size;
+  guint          zoom_base_size;
+  GdkPixbuf*     zoom_pixbuf;
 
   SelectState    select_state;
   gboolean       button_pressed;
@@ -233,6 +247,70 @@ findAction(GtkMathView* math_view, GtkMathViewModelId node)
 }
 #endif
 
+/* asynchronous formatting */
+
+// The engine (element trees, graphic devices, shapers and their caches)
+// is shared by all the views and is not thread-safe.  A worker building
+// a document in background holds this lock for the whole time.  The
+// main thread either waits until no worker is left (see
+// gtk_math_view_sync) or tries to acquire the lock when painting and
+// handling events, in which case the work is skipped if the engine is
+// busy.  Workers are started by the main thread only
+G_LOCK_DEFINE_STATIC(engine);
+static GMutex* workers_mutex = NULL;
+static GCond* workers_cond = NULL;
+static guint workers = 0;
+
+struct GtkMathViewFormatJob
+{
+  GtkMathView* math_view;
+  guint generation;
+};
+
+static gboolean gtk_math_view_format_done(gpointer);
+static gboolean gtk_math_view_get_element_at_aux(GtkMathView*, gint, gint, GtkMathViewModelId*,
+						 GtkMathViewPoint*, GtkMathViewBoundingBox*);
+
+static gpointer
+gtk_math_view_format_thread(gpointer data)
+{
+  GtkMathViewFormatJob* job = static_cast<GtkMathViewFormatJob*>(data);
+  G_LOCK(engine);
+  // only the element tree is built here.  Formatting shapes text
+  // through Pango, Xft and t1lib, which must not run concurrently
+  // with the GDK calls of the main thread, so it is left to the
+  // main thread once the notification is handled
+  job->math_view->view->getRootElement();
+  G_UNLOCK(engine);
+  g_mutex_lock(workers_mutex);
+  workers--;
+  g_cond_broadcast(workers_cond);
+  g_mutex_unlock(workers_mutex);
+  g_idle_add(gtk_math_view_format_done, job);
+  return NULL;
+}
+
+static void
+gtk_math_view_sync(GtkMathView* math_view)
+{
+  g_return_if_fail(math_view != NULL);
+  if (math_view->format_thread != NULL)
+    {
+      g_thread_join(math_view->format_thread);
+      math_view->format_thread = NULL;
+    }
+  // wait for the workers of the other views, if any.  Since no
+  // worker is started but by the main thread, the engine can be
+  // accessed safely until the next call to gtk_math_view_format
+  g_mutex_lock(workers_mutex);
+  while (workers > 0) g_cond_wait(workers_cond, workers_mutex);
+  g_mutex_unlock(workers_mutex);
+}
+
+static gboolean
+gtk_math_view_formatting(GtkMathView* math_view)
+{ return math_view->format_thread != NULL; }
+
 /* auxiliary C functions */
 
 static void
@@ -306,16 +384,135 @@ gtk_math_view_update(GtkMathView* math_view, gint x0, gint y0, gint width, gint
   g_signal_emit(GTK_OBJECT(math_view), decorate_over_signal, 0, widget->window);
 }
 
+static gboolean gtk_math_view_idle_paint(gpointer);
+
 static void
-gtk_math_view_paint(GtkMathView* math_view)
+gtk_math_view_paint_placeholder(GtkMathView* math_view)
+{
+  GtkWidget* widget = GTK_WIDGET(math_view);
+  const gint width = widget->allocation.width;
+  const gint height = widget->allocation.height;
+
+  if (math_view->pixmap == NULL)
+    {
+      math_view->pixmap = gdk_pixmap_new(widget->window, width, height, -1);
+      math_view->renderingContext->setDrawable(math_view->pixmap);
+    }
+
+  gdk_draw_rectangle(math_view->pixmap, widget->style->white_gc, TRUE, 0, 0, width, height);
+  gdk_draw_pixmap(widget->window,
+		  widget->style->fg_gc[GTK_WIDGET_STATE(widget)],
+		  math_view->pixmap,
+		  0, 0, 0, 0, width, height);
+}
+
+static void gtk_math_view_render(GtkMathView*, gboolean);
+
+static void
+gtk_math_view_zoom_reset(GtkMathView* math_view)
 {
   g_return_if_fail(math_view != NULL);
 
+  if (math_view->zoom_id != 0)
+    {
+      g_source_remove(math_view->zoom_id);
+      math_view->zoom_id = 0;
+    }
+
+  if (math_view->zoom_pixbuf != NULL)
+    {
+      g_object_unref(math_view->zoom_pixbuf);
+      math_view->zoom_pixbuf = NULL;
+    }
+}
+
+static void
+gtk_math_view_paint_damage(GtkMathView* math_view, gboolean damage_only)
+{
+  g_return_if_fail(math_view != NULL);
+
+  // a synchronous paint supersedes a pending one
+  if (math_view->idle_id != 0)
+    {
+      g_source_remove(math_view->idle_id);
+      math_view->idle_id = 0;
+    }
+  math_view->damage_only = FALSE;
+
   GtkMathViewClass* math_view_class = GTK_MATH_VIEW_CLASS(G_OBJECT_GET_CLASS(G_OBJECT(math_view)));
   g_return_if_fail(math_view_class != NULL);
 
   if (!GTK_WIDGET_MAPPED(GTK_WIDGET(math_view)) || math_view->freeze_counter > 0) return;
 
+  if (gtk_math_view_formatting(math_view))
+    gtk_math_view_paint_placeholder(math_view);
+  else if (G_TRYLOCK(engine))
+    {
+      gtk_math_view_render(math_view, damage_only);
+      G_UNLOCK(engine);
+    }
+  else
+    {
+      // another view is formatting in background, try again later
+      math_view->damage_only = damage_only;
+      math_view->idle_id = g_timeout_add_full(GTK_PRIORITY_REDRAW, 100, gtk_math_view_idle_paint, math_view, NULL);
+    }
+}
+
+static void
+gtk_math_view_paint(GtkMathView* math_view)
+{
+  gtk_math_view_paint_damage(math_view, FALSE);
+}
+
+static void
+gtk_math_view_render_damage(GtkMathView* math_view, gint x, gint y, const std::vector<Rectangle>& damage)
+{
+  if (damage.empty()) return;
+
+  GtkWidget* widget = GTK_WIDGET(math_view);
+  Gtk_RenderingContext* rc = math_view->renderingContext;
+
+  // glyphs may ink slightly outside their bounding box
+  const gint pad = 2;
+  GdkRegion* region = gdk_region_new();
+  Rectangle bounds = damage.front();
+  for (std::vector<Rectangle>::const_iterator p = damage.begin(); p != damage.end(); p++)
+    {
+      GdkRectangle rect;
+      rect.x = Gtk_RenderingContext::toGtkX(p->x) - x - pad;
+      rect.y = Gtk_RenderingContext::toGtkY(p->y + p->height) - y - pad;
+      rect.width = Gtk_RenderingContext::toGtkPixels(p->width) + 2 * pad;
+      rect.height = Gtk_RenderingContext::toGtkPixels(p->height) + 2 * pad;
+      gdk_region_union_with_rect(region, &rect);
+      bounds.merge(*p);
+    }
+
+  GdkRectangle clip;
+  gdk_region_get_clipbox(region, &clip);
+  gdk_gc_set_clip_region(widget->style->white_gc, region);
+  gdk_draw_rectangle(math_view->pixmap, widget->style->white_gc, TRUE, clip.x, clip.y, clip.width, clip.height);
+  gdk_gc_set_clip_region(widget->style->white_gc, NULL);
+
+  // the areas far from the damaged region are not even visited
+  const scaled x0 = Gtk_RenderingContext::fromGtkX(-x);
+  const scaled y0 = Gtk_RenderingContext::fromGtkY(-y);
+  const scaled margin = Gtk_RenderingContext::fromGtkPixels(16);
+  rc->setClipRegion(region);
+  rc->setClipRectangle(Rectangle(x0 + bounds.x - margin, y0 + bounds.y - margin,
+				 bounds.width + margin * 2, bounds.height + margin * 2));
+  g_signal_emit(GTK_OBJECT(math_view), decorate_under_signal, 0, math_view->pixmap);
+  math_view->view->render(*rc, x0, y0);
+  rc->resetClipRectangle();
+  rc->setClipRegion(0);
+
+  gtk_math_view_update(math_view, clip.x, clip.y, clip.width, clip.height);
+  gdk_region_destroy(region);
+}
+
+static void
+gtk_math_view_render(GtkMathView* math_view, gboolean damage_only)
+{
   GtkWidget* widget = GTK_WIDGET(math_view);
   
   setup_adjustments(math_view);
@@ -330,6 +527,7 @@ gtk_math_view_paint(GtkMathView* math_view)
     {
       math_view->pixmap = gdk_pixmap_new(widget->window, width, height, -1);
       rc->setDrawable(math_view->pixmap);
+      damage_only = FALSE;
     }
 
   rc->setStyle(Gtk_RenderingContext::SELECTED_STYLE);
@@ -347,13 +545,25 @@ gtk_math_view_paint(GtkMathView* math_view)
   rc->setForegroundColor(widget->style->fg[GTK_STATE_NORMAL]);
   rc->setBackgroundColor(widget->style->bg[GTK_STATE_NORMAL]);
 
-  gdk_draw_rectangle(math_view->pixmap, widget->style->white_gc, TRUE, 0, 0, width, height);
-
   // WARNING: setAvailableWidth must be invoked BEFORE any coordinate conversion
   math_view->view->setAvailableWidth(Gtk_RenderingContext::fromGtkX(width));
   gint x = 0;
   gint y = 0;
   to_view_coords(math_view, &x, &y);
+
+  // after a change of the document only the areas that look different
+  // are repainted, provided the document has not moved as a whole
+  std::vector<Rectangle> damage;
+  if (damage_only && x == math_view->render_x && y == math_view->render_y
+      && math_view->view->getDamage(damage))
+    {
+      gtk_math_view_render_damage(math_view, x, y, damage);
+      return;
+    }
+  math_view->render_x = x;
+  math_view->render_y = y;
+
+  gdk_draw_rectangle(math_view->pixmap, widget->style->white_gc, TRUE, 0, 0, width, height);
   g_signal_emit(GTK_OBJECT(math_view), decorate_under_signal, 0, math_view->pixmap);
   math_view->view->render(*rc,
 			  Gtk_RenderingContext::fromGtkX(-x),
@@ -362,6 +572,102 @@ gtk_math_view_paint(GtkMathView* math_view)
   gtk_math_view_update(math_view, 0, 0, width, height);
 }
 
+static gboolean
+gtk_math_view_idle_paint(gpointer data)
+{
+  GtkMathView* math_view = GTK_MATH_VIEW(data);
+  g_return_val_if_fail(math_view != NULL, FALSE);
+  math_view->idle_id = 0;
+  gtk_math_view_paint_damage(math_view, math_view->damage_only);
+  return FALSE;
+}
+
+static void
+gtk_math_view_queue_paint(GtkMathView* math_view)
+{
+  g_return_if_fail(math_view != NULL);
+  // notifications only mark the view dirty, the relayout and paint
+  // happen once when the main loop becomes idle
+  math_view->damage_only = FALSE;
+  if (math_view->idle_id == 0)
+    math_view->idle_id = g_idle_add_full(GTK_PRIORITY_REDRAW, gtk_math_view_idle_paint, math_view, NULL);
+}
+
+static void
+gtk_math_view_queue_damage(GtkMathView* math_view)
+{
+  g_return_if_fail(math_view != NULL);
+  // changes of the document repaint only the areas that changed,
+  // unless a full paint is pending already
+  if (math_view->idle_id == 0)
+    {
+      // a scaled preview of a zoom is not a rendering of the areas
+      math_view->damage_only = math_view->zoom_id == 0;
+      math_view->idle_id = g_idle_add_full(GTK_PRIORITY_REDRAW, gtk_math_view_idle_paint, math_view, NULL);
+    }
+}
+
+static void
+gtk_math_view_format(GtkMathView* math_view)
+{
+  g_return_if_fail(math_view != NULL);
+  g_return_if_fail(math_view->format_thread == NULL);
+
+  if (math_view->async_format)
+    {
+      // WARNING: the available width must be set BEFORE formatting or
+      // the first paint would format the document again
+      math_view->view->setAvailableWidth(Gtk_RenderingContext::fromGtkX(GTK_WIDGET(math_view)->allocation.width));
+      // the view may have started another worker by the time the
+      // notification is handled, so the job tells which one it was
+      GtkMathViewFormatJob* job = g_new(GtkMathViewFormatJob, 1);
+      job->math_view = math_view;
+      job->generation = ++math_view->format_generation;
+      // the reference is released when the worker is done
+      g_object_ref(math_view);
+      g_mutex_lock(workers_mutex);
+      workers++;
+      g_mutex_unlock(workers_mutex);
+      math_view->format_thread = g_thread_create(gtk_math_view_format_thread, job, TRUE, NULL);
+      if (math_view->format_thread == NULL)
+	{
+	  g_mutex_lock(workers_mutex);
+	  workers--;
+	  g_mutex_unlock(workers_mutex);
+	  g_object_unref(math_view);
+	  g_free(job);
+	}
+    }
+
+  gtk_math_view_paint(math_view);
+}
+
+static gboolean
+gtk_math_view_format_done(gpointer data)
+{
+  GtkMathViewFormatJob* job = static_cast<GtkMathViewFormatJob*>(data);
+  GtkMathView* math_view = job->math_view;
+  // the worker may have been joined already, and a newer worker
+  // must not be joined while it is still running
+  if (math_view->format_thread != NULL && math_view->format_generation == job->generation)
+    {
+      gtk_math_view_sync(math_view);
+      gtk_widget_queue_resize(GTK_WIDGET(math_view));
+      gtk_math_view_paint(math_view);
+    }
+  g_object_unref(math_view);
+  g_free(job);
+  return FALSE;
+}
+
+static gboolean
+gtk_math_view_retry_resize(gpointer data)
+{
+  gtk_widget_queue_resize(GTK_WIDGET(data));
+  g_object_unref(data);
+  return FALSE;
+}
+
 static void
 hadjustment_value_changed(GtkAdjustment* adj, GtkMathView* math_view)
 {
@@ -426,6 +732,14 @@ gtk_math_view_base_class_init(GtkMathViewClass* math_view_class)
 {
   g_return_if_fail(math_view_class != NULL);
 
+  // needed by the asynchronous formatting mode
+  if (!g_thread_supported()) g_thread_init(NULL);
+  if (workers_mutex == NULL)
+    {
+      workers_mutex = g_mutex_new();
+      workers_cond = g_cond_new();
+    }
+
   SmartPtr<AbstractLogger> logger = Logger::create();
   logger->ref();
   math_view_class->logger = logger;
@@ -436,6 +750,8 @@ gtk_math_view_base_class_init(GtkMathViewClass* math_view_class)
   math_view_class->defaultFontSize = configuration->getInt(logger, "default/font-size", DEFAULT_FONT_SIZE);
   math_view_class->defaultT1OpaqueMode = configuration->getBool(logger, "default/t1lib/opaque-mode", false);
   math_view_class->defaultT1AntiAliasedMode = configuration->getBool(logger, "default/t1lib/anti-aliasing", false);
+  // in kilobytes
+  math_view_class->defaultT1GlyphCacheSize = configuration->getInt(logger, "default/t1lib/glyph-cache-size", 2048);
 
   SmartPtr<MathMLOperatorDictionary> dictionary = initOperatorDictionary<MathView>(logger, configuration);
   dictionary->ref();
@@ -649,6 +965,17 @@ gtk_math_view_init(GtkMathView* math_view)
   math_view->view            = 0;
   math_view->renderingContext = 0;
   math_view->freeze_counter  = 0;
+  math_view->idle_id         = 0;
+  math_view->damage_only     = FALSE;
+  math_view->render_x        = 0;
+  math_view->render_y        = 0;
+  math_view->async_format    = FALSE;
+  math_view->format_thread   = NULL;
+  math_view->format_generation = 0;
+  math_view->zoom_id         = 0;
+  math_view->zoom_font_size  = 0;
+  math_view->zoom_base_size  = 0;
+  math_view->zoom_pixbuf     = NULL;
   math_view->select_state    = SELECT_STATE_NO;
   math_view->button_pressed  = FALSE;
   math_view->current_elem    = NULL;
@@ -675,6 +1002,7 @@ gtk_math_view_init(GtkMathView* math_view)
   math_view->renderingContext->setColorMap(gtk_widget_get_colormap(GTK_WIDGET(math_view)));
   math_view->renderingContext->setT1OpaqueMode(math_view_class->defaultT1OpaqueMode);
   math_view->renderingContext->setT1AntiAliasedMode(math_view_class->defaultT1AntiAliasedMode);
+  math_view->renderingContext->setT1GlyphCacheLimit(std::max(0, math_view_class->defaultT1GlyphCacheSize) * 1024);
 }
 
 extern "C" GtkWidget*
@@ -697,6 +1025,15 @@ gtk_math_view_destroy(GtkObject* object)
   math_view = GTK_MATH_VIEW(object);
   g_assert(math_view != NULL);
 
+  if (math_view->idle_id != 0)
+    {
+      g_source_remove(math_view->idle_id);
+      math_view->idle_id = 0;
+    }
+
+  gtk_math_view_zoom_reset(math_view);
+  gtk_math_view_sync(math_view);
+
   if (math_view->view)
     {
       math_view->view->resetRootElement();
@@ -755,6 +1092,31 @@ GTKMATHVIEW_METHOD_NAME(thaw)(GtkMathView* math_view)
     return FALSE;
 }
 
+extern "C" void
+GTKMATHVIEW_METHOD_NAME(flush)(GtkMathView* math_view)
+{
+  g_return_if_fail(math_view != NULL);
+  if (gtk_math_view_formatting(math_view) || math_view->idle_id != 0)
+    {
+      gtk_math_view_sync(math_view);
+      gtk_math_view_paint(math_view);
+    }
+}
+
+extern "C" void
+GTKMATHVIEW_METHOD_NAME(set_async_format)(GtkMathView* math_view, gboolean async)
+{
+  g_return_if_fail(math_view != NULL);
+  math_view->async_format = async;
+}
+
+extern "C" gboolean
+GTKMATHVIEW_METHOD_NAME(get_async_format)(GtkMathView* math_view)
+{
+  g_return_val_if_fail(math_view != NULL, FALSE);
+  return math_view->async_format;
+}
+
 extern "C" void
 GTKMATHVIEW_METHOD_NAME(update)(GtkMathView* math_view, GdkRectangle* rect)
 {
@@ -812,11 +1174,22 @@ gtk_math_view_size_request(GtkWidget* widget, GtkRequisition* requisition)
   g_return_if_fail(math_view != NULL);
   g_return_if_fail(math_view->view != 0);
 
+  if (gtk_math_view_formatting(math_view)) return;
+
+  if (!G_TRYLOCK(engine))
+    {
+      // another view is formatting in background, keep the previous
+      // requisition and try again later
+      g_timeout_add(100, gtk_math_view_retry_resize, g_object_ref(math_view));
+      return;
+    }
+
   if (BoundingBox box = math_view->view->getBoundingBox())
     {
       requisition->width = Gtk_RenderingContext::toGtkPixels(box.horizontalExtent());
       requisition->height = Gtk_RenderingContext::toGtkPixels(box.verticalExtent());
     }
+  G_UNLOCK(engine);
 }
 
 static void
@@ -896,6 +1269,8 @@ gtk_math_view_button_release_event(GtkWidget* widget, GdkEventButton* event)
   GtkMathView* math_view = GTK_MATH_VIEW(widget);
   g_return_val_if_fail(math_view->view, FALSE);
 
+  if (gtk_math_view_formatting(math_view)) return FALSE;
+
   if (event->button == 1)
     {
 #if GTKMATHVIEW_USES_GMETADOM
@@ -903,7 +1278,14 @@ gtk_math_view_button_release_event(GtkWidget* widget, GdkEventButton* event)
 #endif
       GtkMathViewModelId elem = NULL;
 
-      GTKMATHVIEW_METHOD_NAME(get_element_at)(math_view, (gint) event->x, (gint) event->y, &elem, NULL, NULL);
+      // if another view is formatting in background the element is
+      // unknown, the selection is ended anyway but there is no click
+      const gboolean located = G_TRYLOCK(engine);
+      if (located)
+	{
+	  gtk_math_view_get_element_at_aux(math_view, (gint) event->x, (gint) event->y, &elem, NULL, NULL);
+	  G_UNLOCK(engine);
+	}
 
       GtkMathViewModelEvent me;
       me.id = elem;
@@ -911,7 +1293,8 @@ gtk_math_view_button_release_event(GtkWidget* widget, GdkEventButton* event)
       me.y = (gint) event->y;
       me.state = event->state;
 
-      if (math_view->button_pressed == TRUE &&
+      if (located &&
+	  math_view->button_pressed == TRUE &&
 	  math_view->select_state == SELECT_STATE_NO &&
 	  fabs(math_view->button_press_x - event->x) <= CLICK_SPACE_RANGE &&
 	  fabs(math_view->button_press_y - event->y) <= CLICK_SPACE_RANGE &&
@@ -950,6 +1333,8 @@ gtk_math_view_motion_notify_event(GtkWidget* widget, GdkEventMotion* event)
   GtkMathView* math_view = GTK_MATH_VIEW(widget);
   g_return_val_if_fail(math_view->view, FALSE);
 
+  if (gtk_math_view_formatting(math_view)) return FALSE;
+
   GdkModifierType mods;
   gint x = (gint) event->x;
   gint y = (gint) event->y;
@@ -963,7 +1348,10 @@ gtk_math_view_motion_notify_event(GtkWidget* widget, GdkEventMotion* event)
 #endif
   GtkMathViewModelId elem = NULL;
 
-  GTKMATHVIEW_METHOD_NAME(get_element_at)(math_view, x, y, &elem, NULL, NULL);
+  // another view is formatting in background, wait for the next event
+  if (!G_TRYLOCK(engine)) return FALSE;
+  gtk_math_view_get_element_at_aux(math_view, x, y, &elem, NULL, NULL);
+  G_UNLOCK(engine);
 
   GtkMathViewModelEvent me;
   me.id = elem;
@@ -1139,9 +1527,10 @@ GTKMATHVIEW_METHOD_NAME(load_uri)(GtkMathView* math_view, const gchar* name)
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(name != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadURI(name);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1151,9 +1540,10 @@ GTKMATHVIEW_METHOD_NAME(load_buffer)(GtkMathView* math_view, const gchar* buffer
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(buffer != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadBuffer(buffer);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1163,9 +1553,10 @@ GTKMATHVIEW_METHOD_NAME(load_document)(GtkMathView* math_view, GdomeDocument* do
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(doc != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadDocument(DOM::Document(doc));
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1175,9 +1566,10 @@ GTKMATHVIEW_METHOD_NAME(load_root)(GtkMathView* math_view, GtkMathViewModelId el
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadRootElement(DOM::Element(elem));
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1198,9 +1590,10 @@ GTKMATHVIEW_METHOD_NAME(load_uri)(GtkMathView* math_view, const gchar* name)
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(name != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadURI(name);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1211,9 +1604,10 @@ GTKMATHVIEW_METHOD_NAME(load_buffer)(GtkMathView* math_view, const gchar* buffer
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(buffer != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadBuffer(buffer);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1224,9 +1618,10 @@ GTKMATHVIEW_METHOD_NAME(load_document)(GtkMathView* math_view, xmlDoc* doc)
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(doc != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadDocument(doc);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1236,9 +1631,10 @@ GTKMATHVIEW_METHOD_NAME(load_root)(GtkMathView* math_view, GtkMathViewModelId el
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadRootElement(elem);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1261,9 +1657,10 @@ GTKMATHVIEW_METHOD_NAME(load_reader)(GtkMathView* math_view,
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(reader != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadReader(reader, user_data);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1276,9 +1673,10 @@ GTKMATHVIEW_METHOD_NAME(load_reader)(GtkMathView* math_view, xmlTextReaderPtr re
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(reader != NULL, FALSE);
 
+  gtk_math_view_sync(math_view);
   gtk_math_view_release_document_resources(math_view);
   const bool res = math_view->view->loadReader(reader);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_format(math_view);
   return res;
 }
 
@@ -1289,6 +1687,7 @@ GTKMATHVIEW_METHOD_NAME(unload)(GtkMathView* math_view)
 {
   g_return_if_fail(math_view != NULL);
   g_return_if_fail(math_view->view != NULL);
+  gtk_math_view_sync(math_view);
   math_view->view->unload();
   gtk_math_view_release_document_resources(math_view);
   gtk_math_view_paint(math_view);
@@ -1396,8 +1795,73 @@ GTKMATHVIEW_METHOD_NAME(set_font_size)(GtkMathView* math_view, guint size)
   g_return_if_fail(math_view != NULL);
   g_return_if_fail(math_view->view != NULL);
   g_return_if_fail(size > 0);
+  gtk_math_view_zoom_reset(math_view);
+  gtk_math_view_sync(math_view);
   math_view->view->setDefaultFontSize(size);
-  gtk_math_view_paint(math_view);
+  gtk_math_view_queue_paint(math_view);
+}
+
+static gboolean
+gtk_math_view_zoom_settled(gpointer data)
+{
+  GtkMathView* math_view = GTK_MATH_VIEW(data);
+  g_return_val_if_fail(math_view != NULL, FALSE);
+  math_view->zoom_id = 0;
+  GTKMATHVIEW_METHOD_NAME(set_font_size)(math_view, math_view->zoom_font_size);
+  return FALSE;
+}
+
+extern "C" void
+GTKMATHVIEW_METHOD_NAME(zoom_font_size)(GtkMathView* math_view, guint size)
+{
+  g_return_if_fail(math_view != NULL);
+  g_return_if_fail(math_view->view != NULL);
+  g_return_if_fail(size > 0);
+
+  GtkWidget* widget = GTK_WIDGET(math_view);
+  if (!GTK_WIDGET_MAPPED(widget) || math_view->pixmap == NULL || math_view->freeze_counter > 0)
+    {
+      GTKMATHVIEW_METHOD_NAME(set_font_size)(math_view, size);
+      return;
+    }
+
+  const gint width = widget->allocation.width;
+  const gint height = widget->allocation.height;
+
+  if (math_view->zoom_id != 0)
+    g_source_remove(math_view->zoom_id);
+  else
+    {
+      // take a snapshot of the last rendering, every intermediate step
+      // of the zoom is obtained by scaling this image
+      gtk_math_view_sync(math_view);
+      gtk_math_view_zoom_reset(math_view);
+      math_view->zoom_base_size = math_view->view->getDefaultFontSize();
+      math_view->zoom_pixbuf = gdk_pixbuf_get_from_drawable(NULL, math_view->pixmap, NULL,
+							    0, 0, 0, 0, width, height);
+    }
+  math_view->zoom_font_size = size;
+
+  if (math_view->zoom_pixbuf != NULL)
+    {
+      const gdouble factor = static_cast<gdouble>(size) / math_view->zoom_base_size;
+      const gint zoomWidth = MAX(1, static_cast<gint>(width * factor));
+      const gint zoomHeight = MAX(1, static_cast<gint>(height * factor));
+      GdkPixbuf* scaled = gdk_pixbuf_scale_simple(math_view->zoom_pixbuf, zoomWidth, zoomHeight,
+						  GDK_INTERP_BILINEAR);
+      if (scaled != NULL)
+	{
+	  gdk_draw_rectangle(math_view->pixmap, widget->style->white_gc, TRUE, 0, 0, width, height);
+	  gdk_draw_pixbuf(math_view->pixmap, widget->style->fg_gc[GTK_WIDGET_STATE(widget)], scaled,
+			  0, 0, 0, 0, MIN(width, zoomWidth), MIN(height, zoomHeight),
+			  GDK_RGB_DITHER_NONE, 0, 0);
+	  g_object_unref(scaled);
+	  gtk_math_view_update(math_view, 0, 0, width, height);
+	}
+    }
+
+  // the document is formatted again only when the size stops changing
+  math_view->zoom_id = g_timeout_add(250, gtk_math_view_zoom_settled, math_view);
 }
 
 extern "C" guint
@@ -1405,6 +1869,7 @@ GTKMATHVIEW_METHOD_NAME(get_font_size)(GtkMathView* math_view)
 {
   g_return_val_if_fail(math_view != NULL, 0);
   g_return_val_if_fail(math_view->view != NULL, 0);
+  if (math_view->zoom_id != 0) return math_view->zoom_font_size;
   return math_view->view->getDefaultFontSize();
 }
 
@@ -1413,9 +1878,10 @@ GTKMATHVIEW_METHOD_NAME(structure_changed)(GtkMathView* math_view, GtkMathViewMo
 {
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
+  gtk_math_view_sync(math_view);
   if (math_view->view->notifyStructureChanged(elem))
     {
-      gtk_math_view_paint(math_view);
+      gtk_math_view_queue_damage(math_view);
       return TRUE;
     }
   else
@@ -1427,26 +1893,49 @@ GTKMATHVIEW_METHOD_NAME(attribute_changed)(GtkMathView* math_view, GtkMathViewMo
 {
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
+  gtk_math_view_sync(math_view);
   if (math_view->view->notifyAttributeChanged(elem, name))
     {
-      gtk_math_view_paint(math_view);
+      gtk_math_view_queue_damage(math_view);
       return TRUE;
     }
   else
     return FALSE;
 }
 
+#if GTKMATHVIEW_USES_LIBXML2
+extern "C" guint
+GTKMATHVIEW_METHOD_NAME(changes)(GtkMathView* math_view, const GtkMathViewModelChange* changes, guint n_changes)
+{
+  g_return_val_if_fail(math_view != NULL, 0);
+  g_return_val_if_fail(math_view->view != NULL, 0);
+  g_return_val_if_fail(changes != NULL || n_changes == 0, 0);
+  gtk_math_view_sync(math_view);
+
+  std::vector<MathView::Change> batch;
+  batch.reserve(n_changes);
+  for (guint i = 0; i < n_changes; i++)
+    batch.push_back(MathView::Change(changes[i].id,
+				     changes[i].structure ? MathView::STRUCTURE_CHANGE : MathView::ATTRIBUTE_CHANGE));
+
+  const guint n = math_view->view->notifyChanges(batch);
+  if (n > 0) gtk_math_view_queue_damage(math_view);
+  return n;
+}
+#endif // GTKMATHVIEW_USES_LIBXML2
+
 extern "C" gboolean
 GTKMATHVIEW_METHOD_NAME(select)(GtkMathView* math_view, GtkMathViewModelId elem)
 {
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(elem != NULL, FALSE);
+  gtk_math_view_sync(math_view);
 
   if (SmartPtr<const Gtk_WrapperArea> area = findGtkWrapperArea(math_view, elem))
     {
       area->setSelected(1);
-      gtk_math_view_paint(math_view);
+      gtk_math_view_queue_paint(math_view);
       return TRUE;
     }
   else
@@ -1459,11 +1948,12 @@ GTKMATHVIEW_METHOD_NAME(unselect)(GtkMathView* math_view, GtkMathViewModelId ele
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(elem != NULL, FALSE);
+  gtk_math_view_sync(math_view);
 
   if (SmartPtr<const Gtk_WrapperArea> area = findGtkWrapperArea(math_view, elem))
     {
       area->setSelected(0);
-      gtk_math_view_paint(math_view);
+      gtk_math_view_queue_paint(math_view);
       return TRUE;
     }
   else
@@ -1476,6 +1966,7 @@ GTKMATHVIEW_METHOD_NAME(is_selected)(GtkMathView* math_view, GtkMathViewModelId
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(elem != NULL, FALSE);
+  gtk_math_view_sync(math_view);
 
   if (SmartPtr<const Gtk_WrapperArea> area = findGtkWrapperArea(math_view, elem))
     return area->getSelected();
@@ -1497,6 +1988,7 @@ GTKMATHVIEW_METHOD_NAME(get_bounding_box)(GtkMathView* math_view, GtkMathViewBou
 {
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
+  gtk_math_view_sync(math_view);
   if (BoundingBox box = math_view->view->getBoundingBox())
     {
       if (result_box)
@@ -1519,7 +2011,19 @@ GTKMATHVIEW_METHOD_NAME(get_element_at)(GtkMathView* math_view, gint x, gint y,
 {
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
+  gtk_math_view_sync(math_view);
+  G_LOCK(engine);
+  const gboolean res = gtk_math_view_get_element_at_aux(math_view, x, y, result, result_orig, result_box);
+  G_UNLOCK(engine);
+  return res;
+}
 
+// the caller must hold the engine lock
+static gboolean
+gtk_math_view_get_element_at_aux(GtkMathView* math_view, gint x, gint y,
+				 GtkMathViewModelId* result, GtkMathViewPoint* result_orig,
+				 GtkMathViewBoundingBox* result_box)
+{
   Point elemOrig;
   BoundingBox elemBox;
   to_view_coords(math_view, &x, &y);
@@ -1558,6 +2062,7 @@ GTKMATHVIEW_METHOD_NAME(get_element_extents_ref)(GtkMathView* math_view, GtkMath
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(el != NULL, FALSE);
+  gtk_math_view_sync(math_view);
 
   SmartPtr<Element> refElem;
   if (refEl)
@@ -1608,6 +2113,7 @@ GTKMATHVIEW_METHOD_NAME(get_char_at)(GtkMathView* math_view, gint x, gint y,
 {
   g_return_val_if_fail(math_view != NULL, FALSE);
   g_return_val_if_fail(math_view->view != NULL, FALSE);
+  gtk_math_view_sync(math_view);
 
   CharIndex charIndex;
   Point charOrig;
@@ -1652,6 +2158,7 @@ GTKMATHVIEW_METHOD_NAME(get_char_extents_ref)(GtkMathView* math_view, GtkMathVie
   g_return_val_if_fail(math_view->view != NULL, FALSE);
   g_return_val_if_fail(el != NULL, FALSE);
   g_return_val_if_fail(index >= 0, FALSE);
+  gtk_math_view_sync(math_view);
 
   SmartPtr<Element> refElem;
   if (refEl)
@@ -79,6 +79,13 @@ extern "C" {
     gint state;
   } GtkMathViewModelEvent;
 
+#if GTKMATHVIEW_USES_LIBXML2
+  typedef struct _GtkMathViewModelChange {
+    GtkMathViewModelId id;
+    gboolean structure;
+  } GtkMathViewModelChange;
+#endif
+
   typedef void (*GtkMathViewModelSignal)(GtkMathView*, const GtkMathViewModelEvent*);
   typedef void (*GtkMathViewSelectAbortSignal)(GtkMathView*);
   typedef void (*GtkMathViewDecorateSignal)(GtkMathView*, GdkDrawable*, gpointer);
@@ -87,6 +94,9 @@ extern "C" {
   GtkWidget* GTKMATHVIEW_METHOD_NAME(new)(GtkAdjustment*, GtkAdjustment*);
   gboolean   GTKMATHVIEW_METHOD_NAME(freeze)(GtkMathView*);
   gboolean   GTKMATHVIEW_METHOD_NAME(thaw)(GtkMathView*);
+  void       GTKMATHVIEW_METHOD_NAME(flush)(GtkMathView*);
+  void       GTKMATHVIEW_METHOD_NAME(set_async_format)(GtkMathView*, gboolean);
+  gboolean   GTKMATHVIEW_METHOD_NAME(get_async_format)(GtkMathView*);
   void       GTKMATHVIEW_METHOD_NAME(update)(GtkMathView*, GdkRectangle*);
 #if GTKMATHVIEW_USES_CUSTOM_READER
   gboolean   GTKMATHVIEW_METHOD_NAME(load_reader)(GtkMathView*, GtkMathViewReader*, GtkMathViewReaderData);
@@ -102,6 +112,9 @@ extern "C" {
   void       GTKMATHVIEW_METHOD_NAME(unload)(GtkMathView*);
   gboolean   GTKMATHVIEW_METHOD_NAME(structure_changed)(GtkMathView*, GtkMathViewModelId);
   gboolean   GTKMATHVIEW_METHOD_NAME(attribute_changed)(GtkMathView*, GtkMathViewModelId, GtkMathViewModelString);
+#if GTKMATHVIEW_USES_LIBXML2
+  guint      GTKMATHVIEW_METHOD_NAME(changes)(GtkMathView*, const GtkMathViewModelChange*, guint);
+#endif
   gboolean   GTKMATHVIEW_METHOD_NAME(select)(GtkMathView*, GtkMathViewModelId);
   gboolean   GTKMATHVIEW_METHOD_NAME(unselect)(GtkMathView*, GtkMathViewModelId);
   gboolean   GTKMATHVIEW_METHOD_NAME(is_selected)(GtkMathView*, GtkMathViewModelId);
@@ -127,6 +140,7 @@ extern "C" {
   void       GTKMATHVIEW_METHOD_NAME(get_adjustments)(GtkMathView*, GtkAdjustment**, GtkAdjustment**);
   GdkPixmap* GTKMATHVIEW_METHOD_NAME(get_buffer)(GtkMathView*);
   void       GTKMATHVIEW_METHOD_NAME(set_font_size)(GtkMathView*, guint);
+  void       GTKMATHVIEW_METHOD_NAME(zoom_font_size)(GtkMathView*, guint);
   guint      GTKMATHVIEW_METHOD_NAME(get_font_size)(GtkMathView*);
   void       GTKMATHVIEW_METHOD_NAME(set_log_verbosity)(GtkMathView*, gint);
   gint       GTKMATHVIEW_METHOD_NAME(get_log_verbosity)(GtkMathView*);